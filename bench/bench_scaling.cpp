@@ -0,0 +1,388 @@
+// End-to-end scaling benchmark: runs a fixed, seeded workload mix across a
+// grid of compute unit counts, host core counts and workload sizes, and
+// reports simulated cycles per host second, parallel efficiency and peak
+// memory. The CSV it writes is the regression baseline.
+//
+// The simulator runs one host thread per compute unit, so the host core
+// count is swept by pinning the run to the first N cores (Linux only;
+// elsewhere every run uses all cores). Each point runs in a child process so
+// its peak RSS is its own.
+//
+// Usage: bench_scaling [--cus 16,68,132] [--host-cores 4,16,64] [--sizes 1,2,4]
+//                      [--seed N] [--csv FILE]
+
+#include "gpu_device.h"
+#include "workload.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+#define popen _popen
+#define pclose _pclose
+#endif
+
+using namespace GPUSim;
+
+namespace {
+
+const char* kResultTag = "SCALING_RESULT";
+
+struct ScalingPoint {
+    size_t compute_units;
+    size_t host_cores;
+    size_t size_scale;
+};
+
+struct ScalingResult {
+    ScalingPoint point;
+    bool ok;
+    uint64_t simulated_cycles;
+    uint64_t compute_unit_cycles; // Summed over compute units
+    double host_time_ms;
+    double cycles_per_second;     // Device clock
+    double cu_cycles_per_second;  // All compute units; the work rate
+    size_t peak_rss_bytes;
+    double speedup;               // Over the fewest host cores at this CU count and size
+    double efficiency;            // Speedup over the core ratio
+};
+
+// The same mix for every point: seeded types and shapes, scaled by size
+std::vector<std::shared_ptr<Workload>> buildWorkloads(size_t size_scale, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::shared_ptr<Workload>> workloads;
+    for (size_t i = 0; i < 8; ++i) {
+        size_t variant = 1 + rng() % 2;
+        switch (rng() % 4) {
+            case 0:
+                workloads.push_back(Workload::createMatrixMultiply(128 * variant * size_scale,
+                                                                   128 * size_scale, 128));
+                break;
+            case 1:
+                workloads.push_back(Workload::createConvolution(1, 16 * variant, 28 * size_scale,
+                                                                28 * size_scale));
+                break;
+            case 2:
+                workloads.push_back(Workload::createVectorAdd(128 * 1024 * variant * size_scale));
+                break;
+            default:
+                workloads.push_back(Workload::createReduction(128 * 1024 * variant * size_scale));
+                break;
+        }
+    }
+    return workloads;
+}
+
+// Keep the first host_cores cores of this process's affinity mask
+void restrictHostCores(size_t host_cores) {
+#if defined(__linux__)
+    cpu_set_t current;
+    CPU_ZERO(&current);
+    if (sched_getaffinity(0, sizeof(current), &current) != 0) return;
+
+    cpu_set_t restricted;
+    CPU_ZERO(&restricted);
+    size_t kept = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE && kept < host_cores; ++cpu) {
+        if (CPU_ISSET(cpu, &current)) {
+            CPU_SET(cpu, &restricted);
+            kept++;
+        }
+    }
+    sched_setaffinity(0, sizeof(restricted), &restricted);
+#else
+    (void)host_cores;
+#endif
+}
+
+// One point, in the child process; the result is a single tagged line
+int runPoint(const ScalingPoint& point, uint64_t seed) {
+    restrictHostCores(point.host_cores);
+
+    GPUConfig config;
+    config.num_compute_units = point.compute_units;
+    GPUDevice gpu(config);
+
+    for (auto& workload : buildWorkloads(point.size_scale, seed)) {
+        gpu.submitWorkload(workload);
+    }
+
+    gpu.executeWorkloads();
+    gpu.waitForCompletion();
+
+    const GPUMetrics& metrics = gpu.getPerformanceAnalyzer()->getGPUMetrics();
+    std::cout << kResultTag << " " << metrics.simulated_cycles << " " << metrics.total_cycles << " "
+              << std::setprecision(17) << metrics.total_execution_time_ms << " "
+              << getPeakRSSBytes() << std::endl;
+    return metrics.simulated_cycles > 0 ? 0 : 1;
+}
+
+// Path of this executable for the child runs. argv[0] is only what the shell
+// was given, which need not resolve from the child's shell (e.g. a bare name
+// found on PATH), so Linux reads the link the kernel keeps instead
+std::string selfExecutable(const char* argv0) {
+#if defined(__linux__)
+    char path[4096];
+    ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length > 0) {
+        return std::string(path, static_cast<size_t>(length));
+    }
+#endif
+    return argv0;
+}
+
+// Re-runs this executable for one point and parses its result line
+ScalingResult runChild(const std::string& executable, const ScalingPoint& point, uint64_t seed) {
+    ScalingResult result{};
+    result.point = point;
+
+    std::ostringstream command;
+    command << "\"" << executable << "\" --child " << point.compute_units << " " << point.host_cores
+            << " " << point.size_scale << " " << seed;
+
+    FILE* pipe = popen(command.str().c_str(), "r");
+    if (!pipe) {
+        std::cerr << "Failed to run: " << command.str() << "\n";
+        return result;
+    }
+
+    char line[512];
+    while (fgets(line, sizeof(line), pipe)) {
+        std::istringstream fields(line);
+        std::string tag;
+        fields >> tag;
+        if (tag == kResultTag) {
+            fields >> result.simulated_cycles >> result.compute_unit_cycles
+                   >> result.host_time_ms >> result.peak_rss_bytes;
+            result.ok = !fields.fail();
+        }
+    }
+    if (pclose(pipe) != 0) {
+        result.ok = false;
+    }
+
+    if (result.ok && result.host_time_ms > 0) {
+        result.cycles_per_second = result.simulated_cycles / (result.host_time_ms / 1000.0);
+        result.cu_cycles_per_second = result.compute_unit_cycles / (result.host_time_ms / 1000.0);
+    }
+    return result;
+}
+
+// Speedup and efficiency relative to the fewest host cores run for the
+// same compute unit count and size
+void computeEfficiency(std::vector<ScalingResult>& results) {
+    std::map<std::pair<size_t, size_t>, const ScalingResult*> baselines;
+    for (const auto& result : results) {
+        if (!result.ok) continue;
+        auto key = std::make_pair(result.point.compute_units, result.point.size_scale);
+        auto it = baselines.find(key);
+        if (it == baselines.end() || result.point.host_cores < it->second->point.host_cores) {
+            baselines[key] = &result;
+        }
+    }
+
+    for (auto& result : results) {
+        auto it = baselines.find(std::make_pair(result.point.compute_units, result.point.size_scale));
+        if (!result.ok || it == baselines.end() || it->second->cu_cycles_per_second <= 0) continue;
+        const ScalingResult& baseline = *it->second;
+        result.speedup = result.cu_cycles_per_second / baseline.cu_cycles_per_second;
+        result.efficiency = result.speedup * baseline.point.host_cores / result.point.host_cores;
+    }
+}
+
+void printScalingTable(const std::vector<ScalingResult>& results) {
+    std::cout << "\n=== Simulator Scaling ===\n";
+    std::cout << std::left << std::setw(6) << "CUs" << std::right
+              << std::setw(8) << "Cores"
+              << std::setw(6) << "Size"
+              << std::setw(14) << "Sim Cycles"
+              << std::setw(12) << "Host(ms)"
+              << std::setw(14) << "Mcycles/s"
+              << std::setw(16) << "CU Mcycles/s"
+              << std::setw(10) << "Speedup"
+              << std::setw(8) << "Eff %"
+              << std::setw(14) << "Peak RSS(MB)"
+              << "\n";
+    std::cout << std::string(108, '-') << "\n";
+
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(6) << result.point.compute_units << std::right
+                  << std::setw(8) << result.point.host_cores
+                  << std::setw(6) << result.point.size_scale;
+        if (!result.ok) {
+            std::cout << "  failed\n";
+            continue;
+        }
+        std::cout << std::setw(14) << result.simulated_cycles
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(12) << result.host_time_ms
+                  << std::setprecision(3)
+                  << std::setw(14) << result.cycles_per_second / 1e6
+                  << std::setw(16) << result.cu_cycles_per_second / 1e6
+                  << std::setprecision(2)
+                  << std::setw(10) << result.speedup
+                  << std::setprecision(1)
+                  << std::setw(8) << result.efficiency * 100.0
+                  << std::setw(14) << result.peak_rss_bytes / (1024.0 * 1024.0)
+                  << "\n";
+    }
+}
+
+// Efficiency against host cores, one bar per point
+void printEfficiencyCurve(const std::vector<ScalingResult>& results) {
+    std::cout << "\n=== Parallel Efficiency vs Host Cores ===\n";
+    for (const auto& result : results) {
+        if (!result.ok) continue;
+        size_t bar = static_cast<size_t>(std::min(1.0, std::max(0.0, result.efficiency)) * 50.0 + 0.5);
+        std::cout << std::right << std::setw(4) << result.point.compute_units << " CUs, size "
+                  << result.point.size_scale << ", " << std::setw(3) << result.point.host_cores << " cores |"
+                  << std::string(bar, '#') << std::string(50 - bar, ' ') << "| "
+                  << std::fixed << std::setprecision(1) << result.efficiency * 100.0 << "%\n";
+    }
+}
+
+bool exportCSV(const std::string& filename, const std::vector<ScalingResult>& results, uint64_t seed) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << "\n";
+        return false;
+    }
+
+    file << "Compute_Units,Host_Cores,Size_Scale,Seed,OK,Sim_Cycles,CU_Cycles,Host_Time_ms,"
+            "Sim_Cycles_per_s,CU_Cycles_per_s,Speedup,Efficiency,Peak_RSS_Bytes\n";
+    for (const auto& result : results) {
+        file << result.point.compute_units << ","
+             << result.point.host_cores << ","
+             << result.point.size_scale << ","
+             << seed << ","
+             << (result.ok ? 1 : 0) << ","
+             << result.simulated_cycles << ","
+             << result.compute_unit_cycles << ","
+             << result.host_time_ms << ","
+             << result.cycles_per_second << ","
+             << result.cu_cycles_per_second << ","
+             << result.speedup << ","
+             << result.efficiency << ","
+             << result.peak_rss_bytes << "\n";
+    }
+
+    file.close();
+    if (!file) {
+        std::cerr << "Failed to write file: " << filename << "\n";
+        return false;
+    }
+    std::cout << "\nScaling baseline exported to " << filename << "\n";
+    return true;
+}
+
+// Digits only: strtoull would accept a sign and leading space
+bool parseUnsigned(const std::string& text, unsigned long long& value) {
+    if (!std::isdigit(static_cast<unsigned char>(text[0]))) return false;
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoull(text.c_str(), &end, 10);
+    return *end == '\0' && errno != ERANGE;
+}
+
+bool parseList(const std::string& text, std::vector<size_t>& values) {
+    values.clear();
+    std::istringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        unsigned long long value = 0;
+        if (!parseUnsigned(item, value) || value == 0) return false;
+        values.push_back(static_cast<size_t>(value));
+    }
+    return !values.empty();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc == 6 && std::string(argv[1]) == "--child") {
+        ScalingPoint point{static_cast<size_t>(std::atol(argv[2])), static_cast<size_t>(std::atol(argv[3])),
+                           static_cast<size_t>(std::atol(argv[4]))};
+        return runPoint(point, std::strtoull(argv[5], nullptr, 10));
+    }
+
+    size_t hardware_cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> compute_units = {16, 68, 132};
+    std::vector<size_t> host_cores = {1, 4, 16, 64, hardware_cores};
+    std::vector<size_t> sizes = {1, 2, 4};
+    uint64_t seed = 42;
+    std::string csv_path = "scaling_baseline.csv";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool ok = i + 1 < argc;
+        if (ok && arg == "--cus") {
+            ok = parseList(argv[++i], compute_units);
+        } else if (ok && arg == "--host-cores") {
+            ok = parseList(argv[++i], host_cores);
+        } else if (ok && arg == "--sizes") {
+            ok = parseList(argv[++i], sizes);
+        } else if (ok && arg == "--seed") {
+            unsigned long long value = 0;
+            ok = parseUnsigned(argv[++i], value);
+            seed = value;
+        } else if (ok && arg == "--csv") {
+            csv_path = argv[++i];
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Usage: bench_scaling [--cus 16,68,132] [--host-cores 4,16,64] "
+                         "[--sizes 1,2,4] [--seed N] [--csv FILE]\n";
+            return 2;
+        }
+    }
+
+    // More cores than the host has would only repeat the all-cores point
+    for (auto& cores : host_cores) cores = std::min(cores, hardware_cores);
+    std::sort(host_cores.begin(), host_cores.end());
+    host_cores.erase(std::unique(host_cores.begin(), host_cores.end()), host_cores.end());
+
+    std::cout << "==============================================\n";
+    std::cout << "  SIMULATOR SCALING BENCHMARK\n";
+    std::cout << "==============================================\n\n";
+#if !defined(__linux__)
+    std::cout << "Host core pinning is Linux only; every point uses all " << hardware_cores << " cores\n";
+#endif
+
+    const std::string executable = selfExecutable(argv[0]);
+    std::vector<ScalingResult> results;
+    for (size_t cus : compute_units) {
+        for (size_t size : sizes) {
+            for (size_t cores : host_cores) {
+                std::cout << "Running " << cus << " CUs, size " << size << ", " << cores << " cores..." << std::endl;
+                results.push_back(runChild(executable, ScalingPoint{cus, cores, size}, seed));
+            }
+        }
+    }
+
+    computeEfficiency(results);
+    printScalingTable(results);
+    printEfficiencyCurve(results);
+    bool exported = exportCSV(csv_path, results, seed);
+
+    bool all_ok = std::all_of(results.begin(), results.end(), [](const ScalingResult& r) { return r.ok; });
+    return all_ok && exported ? 0 : 1;
+}
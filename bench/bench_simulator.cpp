@@ -0,0 +1,415 @@
+// Microbenchmarks of the simulator's hot paths. Each benchmark is calibrated
+// to run for at least --min-time-ms per repetition, then repeated; the
+// median ns/op is reported with the spread across repetitions, and the
+// results are written as JSON for tracking over time.
+//
+// Usage: bench_simulator [--filter SUBSTRING] [--repetitions N]
+//                        [--min-time-ms MS] [--json FILE]
+
+#include "compute_unit.h"
+#include "memory.h"
+#include "scheduler.h"
+#include "workload.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace GPUSim;
+
+namespace {
+
+// Accumulates the time a benchmark body spends outside its paused sections
+class Timer {
+private:
+    std::chrono::steady_clock::time_point started_;
+    double elapsed_ns_ = 0.0;
+    bool running_ = false;
+
+public:
+    void resume() {
+        if (running_) return;
+        started_ = std::chrono::steady_clock::now();
+        running_ = true;
+    }
+
+    void pause() {
+        if (!running_) return;
+        elapsed_ns_ += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started_).count();
+        running_ = false;
+    }
+
+    double getElapsedNs() const { return elapsed_ns_; }
+};
+
+// Runs `iterations` iterations and returns the number of operations done;
+// setup that should not count goes between timer.pause() and timer.resume()
+using BenchmarkBody = std::function<uint64_t(uint64_t iterations, Timer& timer)>;
+
+struct Benchmark {
+    std::string name;
+    BenchmarkBody body;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    uint64_t iterations;       // Per repetition, after calibration
+    uint64_t ops;              // Per repetition
+    double median_ns_per_op;
+    double min_ns_per_op;
+    double max_ns_per_op;
+    double cv_pct;             // Coefficient of variation across repetitions
+};
+
+struct Options {
+    std::string filter;
+    size_t repetitions = 10;
+    double min_time_ms = 50.0;
+    std::string json_path = "bench_simulator.json";
+};
+
+double timeOnce(const BenchmarkBody& body, uint64_t iterations, uint64_t& ops) {
+    Timer timer;
+    timer.resume();
+    ops = body(iterations, timer);
+    timer.pause();
+    return timer.getElapsedNs();
+}
+
+BenchmarkResult runBenchmark(const Benchmark& benchmark, const Options& options) {
+    const double min_time_ns = options.min_time_ms * 1e6;
+
+    // Grow the iteration count until one repetition takes min_time; this
+    // doubles as the warm-up
+    uint64_t iterations = 1;
+    uint64_t ops = 0;
+    for (;;) {
+        double ns = timeOnce(benchmark.body, iterations, ops);
+        if (ns >= min_time_ns) break;
+        double scale = ns > 0 ? min_time_ns * 1.2 / ns : 10.0;
+        iterations = static_cast<uint64_t>(std::ceil(iterations * std::min(10.0, std::max(2.0, scale))));
+    }
+
+    std::vector<double> ns_per_op;
+    for (size_t rep = 0; rep < options.repetitions; ++rep) {
+        double ns = timeOnce(benchmark.body, iterations, ops);
+        ns_per_op.push_back(ops > 0 ? ns / ops : 0.0);
+    }
+
+    std::vector<double> sorted = ns_per_op;
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+    double median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+
+    double mean = 0.0;
+    for (double value : ns_per_op) mean += value;
+    mean /= n;
+    double squares = 0.0;
+    for (double value : ns_per_op) squares += (value - mean) * (value - mean);
+    double stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0.0;
+
+    return BenchmarkResult{benchmark.name, iterations, ops, median, sorted.front(), sorted.back(),
+                           mean > 0 ? stddev / mean * 100.0 : 0.0};
+}
+
+// --- Benchmarks ---
+
+const size_t kThreadsPerBlock = 256;
+const size_t kBlocksPerRound = 16;
+
+// Shared by the compute unit benchmarks
+std::shared_ptr<MemoryController> getMemoryController() {
+    static auto memory_controller = std::make_shared<MemoryController>();
+    return memory_controller;
+}
+
+// One addWarp and one getNextWarp per op
+uint64_t benchWarpScheduler(uint64_t iterations, Timer&) {
+    static ThreadBlock block(0, 1024);
+    WarpScheduler scheduler(64);
+    size_t num_warps = block.getNumWarps();
+
+    for (uint64_t i = 0; i < iterations; ++i) {
+        scheduler.addWarp(block.getWarp(i % num_warps));
+        scheduler.getNextWarp();
+    }
+    return iterations;
+}
+
+// One 8-instruction warp issue per op, as simulateCycle does
+uint64_t benchExecuteWarp(uint64_t iterations, Timer& timer) {
+    timer.pause();
+    ComputeUnit cu(0, getMemoryController());
+    ThreadBlock block(0, kThreadsPerBlock);
+    size_t num_warps = block.getNumWarps();
+    timer.resume();
+
+    for (uint64_t i = 0; i < iterations; ++i) {
+        cu.executeWarp(block.getWarp(i % num_warps), 8);
+    }
+    return iterations;
+}
+
+// One simulated cycle per op, with completed blocks retired as the device does
+uint64_t benchSimulateCycle(uint64_t iterations, Timer& timer) {
+    timer.pause();
+    ComputeUnit cu(0, getMemoryController());
+    timer.resume();
+
+    for (uint64_t step = 1; step <= iterations; ++step) {
+        if (cu.getActiveBlockCount() == 0) {
+            timer.pause();
+            for (size_t b = 0; b < kBlocksPerRound; ++b) {
+                auto block = std::make_unique<ThreadBlock>(b, kThreadsPerBlock);
+                block->setWorkloadID(1);
+                cu.assignBlock(std::move(block));
+            }
+            timer.resume();
+        }
+        cu.simulateCycle();
+        if (step % 256 == 0) {
+            cu.removeCompletedBlocks();
+        }
+    }
+    return iterations;
+}
+
+// Alternating 128-byte reads and writes from `threads` threads sharing one
+// memory; ns/op is wall time over all threads' accesses
+BenchmarkBody benchGlobalMemory(size_t threads) {
+    return [threads](uint64_t iterations, Timer& timer) -> uint64_t {
+        timer.pause();
+        static GlobalMemory memory(64 * 1024 * 1024);
+        uint64_t per_thread = std::max<uint64_t>(1, iterations / threads);
+        timer.resume();
+
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([t, per_thread]() {
+                MemoryAddress address = t * 4096;
+                for (uint64_t i = 0; i < per_thread; ++i) {
+                    if (i & 1) {
+                        memory.write(address, 128);
+                    } else {
+                        memory.read(address, 128);
+                    }
+                    address = (address + 128) % (memory.getSize() - 128);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return per_thread * threads;
+    };
+}
+
+// One thread block materialized per op
+uint64_t benchGenerateThreadBlocks(uint64_t iterations, Timer& timer) {
+    timer.pause();
+    static auto workload = Workload::createMatrixMultiply(256, 256, 256);
+    timer.resume();
+
+    uint64_t blocks = 0;
+    for (uint64_t i = 0; i < iterations; ++i) {
+        workload->generateThreadBlocks();
+        while (auto block = workload->getNextBlock()) {
+            blocks++;
+        }
+    }
+    return blocks;
+}
+
+// Queues `queue_depth` workloads on a fresh scheduler and drains it; one
+// addWorkload and one getNextWorkload per op
+BenchmarkBody benchGetNextWorkload(SchedulingAlgorithm algorithm, size_t queue_depth) {
+    auto pool = std::make_shared<std::vector<std::shared_ptr<Workload>>>();
+    std::mt19937_64 rng(42);
+    for (size_t i = 0; i < queue_depth; ++i) {
+        std::shared_ptr<Workload> workload;
+        switch (rng() % 4) {
+            case 0: workload = Workload::createMatrixMultiply(64 << (rng() % 4), 64, 64); break;
+            case 1: workload = Workload::createConvolution(1, 16, 32 << (rng() % 3), 32); break;
+            case 2: workload = Workload::createVectorAdd(1024 << (rng() % 8)); break;
+            default: workload = Workload::createReduction(1024 << (rng() % 8)); break;
+        }
+        workload->setPriority(static_cast<int>(rng() % 5));
+        pool->push_back(workload);
+    }
+
+    return [algorithm, pool](uint64_t iterations, Timer& timer) -> uint64_t {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            timer.pause();
+            auto scheduler = SchedulerFactory::createScheduler(algorithm);
+            timer.resume();
+
+            for (const auto& workload : *pool) {
+                scheduler->addWorkload(workload);
+            }
+            while (scheduler->getNextWorkload()) {
+            }
+
+            timer.pause();
+            scheduler.reset();
+            timer.resume();
+        }
+        return iterations * pool->size();
+    };
+}
+
+std::vector<Benchmark> makeBenchmarks() {
+    std::vector<Benchmark> benchmarks = {
+        {"warp_scheduler/add_get", benchWarpScheduler},
+        {"compute_unit/execute_warp", benchExecuteWarp},
+        {"compute_unit/simulate_cycle", benchSimulateCycle},
+        {"workload/generate_thread_blocks", benchGenerateThreadBlocks},
+    };
+
+    std::vector<size_t> thread_counts = {1, 2, 4, std::max(1u, std::thread::hardware_concurrency())};
+    std::sort(thread_counts.begin(), thread_counts.end());
+    thread_counts.erase(std::unique(thread_counts.begin(), thread_counts.end()), thread_counts.end());
+    for (size_t threads : thread_counts) {
+        benchmarks.push_back({"global_memory/read_write/threads:" + std::to_string(threads),
+                              benchGlobalMemory(threads)});
+    }
+
+    struct SchedulerCase {
+        SchedulingAlgorithm algorithm;
+        const char* name;
+        std::vector<size_t> queue_depths;
+    };
+    // Shortest-job-first rescans the queue with two predictions per
+    // comparison, so it stops at a smaller depth
+    const SchedulerCase cases[] = {
+        {SchedulingAlgorithm::FIFO, "fifo", {100, 1000, 10000}},
+        {SchedulingAlgorithm::PRIORITY, "priority", {100, 1000, 10000}},
+        {SchedulingAlgorithm::SHORTEST_JOB_FIRST, "sjf", {100, 1000}},
+    };
+    for (const auto& scheduler_case : cases) {
+        for (size_t depth : scheduler_case.queue_depths) {
+            benchmarks.push_back({std::string("scheduler/get_next_workload/") + scheduler_case.name +
+                                      "/queue:" + std::to_string(depth),
+                                  benchGetNextWorkload(scheduler_case.algorithm, depth)});
+        }
+    }
+
+    return benchmarks;
+}
+
+bool writeJson(const std::string& path, const Options& options, const std::vector<BenchmarkResult>& results) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << path << "\n";
+        return false;
+    }
+
+    file << "{\n";
+    file << "  \"suite\": \"bench_simulator\",\n";
+#ifdef GPUSIM_ENABLE_TRACING
+    file << "  \"tracing\": true,\n";
+#else
+    file << "  \"tracing\": false,\n";
+#endif
+    file << "  \"host_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    file << "  \"repetitions\": " << options.repetitions << ",\n";
+    file << "  \"min_time_ms\": " << options.min_time_ms << ",\n";
+    file << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        file << "    {\"name\": \"" << result.name << "\""
+             << ", \"iterations\": " << result.iterations
+             << ", \"ops\": " << result.ops
+             << std::fixed << std::setprecision(3)
+             << ", \"ns_per_op\": " << result.median_ns_per_op
+             << ", \"min_ns_per_op\": " << result.min_ns_per_op
+             << ", \"max_ns_per_op\": " << result.max_ns_per_op
+             << ", \"cv_pct\": " << result.cv_pct
+             << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n";
+    file << "}\n";
+
+    std::cout << "Results written to " << path << "\n";
+    return true;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--repetitions") {
+            options.repetitions = std::max(1, std::atoi(value.c_str()));
+        } else if (arg == "--min-time-ms") {
+            options.min_time_ms = std::max(1.0, std::atof(value.c_str()));
+        } else if (arg == "--json") {
+            options.json_path = value;
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: bench_simulator [--filter SUBSTRING] [--repetitions N] "
+                     "[--min-time-ms MS] [--json FILE]\n";
+        return 2;
+    }
+
+    std::cout << "==============================================\n";
+    std::cout << "  SIMULATOR MICROBENCHMARKS\n";
+    std::cout << "==============================================\n\n";
+    std::cout << options.repetitions << " repetitions of at least " << options.min_time_ms << " ms each\n\n";
+
+    std::cout << std::left << std::setw(52) << "Benchmark" << std::right
+              << std::setw(14) << "ns/op"
+              << std::setw(14) << "min"
+              << std::setw(14) << "max"
+              << std::setw(10) << "CV %"
+              << "\n";
+    std::cout << std::string(104, '-') << "\n";
+
+    std::vector<BenchmarkResult> results;
+    for (const auto& benchmark : makeBenchmarks()) {
+        if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) continue;
+
+        BenchmarkResult result = runBenchmark(benchmark, options);
+        std::cout << std::left << std::setw(52) << result.name << std::right
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(14) << result.median_ns_per_op
+                  << std::setw(14) << result.min_ns_per_op
+                  << std::setw(14) << result.max_ns_per_op
+                  << std::setprecision(1)
+                  << std::setw(10) << result.cv_pct
+                  << std::endl;
+        results.push_back(result);
+    }
+
+    if (results.empty()) {
+        std::cerr << "No benchmark matches filter: " << options.filter << "\n";
+        return 1;
+    }
+
+    return writeJson(options.json_path, options, results) ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+// Tracing overhead benchmark: runs the same compute unit workload with and
+// without a per-CU event ring attached and reports the slowdown.
+//
+// Build with -DGPUSIM_ENABLE_TRACING=OFF to measure the compiled-out hooks.
+
+#include "compute_unit.h"
+#include "event_trace.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+using namespace GPUSim;
+
+namespace {
+
+const size_t kBlocksPerRound = 16;
+const size_t kThreadsPerBlock = 256;
+const size_t kRounds = 10;
+const size_t kRepetitions = 15;
+const double kOverheadBudgetPct = 5.0;
+
+// Runs kRounds full waves of blocks through one CU; returns ns per simulated cycle
+double runRounds(ComputeUnit& cu) {
+    double total_ns = 0.0;
+    uint64_t total_cycles = 0;
+
+    for (size_t round = 0; round < kRounds; ++round) {
+        for (size_t b = 0; b < kBlocksPerRound; ++b) {
+            auto block = std::make_unique<ThreadBlock>(b, kThreadsPerBlock);
+            block->setWorkloadID(round + 1);
+            cu.assignBlock(std::move(block));
+        }
+
+        uint64_t cycles_before = cu.getCyclesExecuted();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t step = 1; cu.getActiveBlockCount() > 0; ++step) {
+            cu.simulateCycle();
+            if (step % 256 == 0) {
+                cu.removeCompletedBlocks();
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        total_ns += std::chrono::duration<double, std::nano>(end - start).count();
+        total_cycles += cu.getCyclesExecuted() - cycles_before;
+    }
+
+    return total_cycles > 0 ? total_ns / total_cycles : 0.0;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "==============================================\n";
+    std::cout << "  EVENT TRACING OVERHEAD BENCHMARK\n";
+    std::cout << "==============================================\n\n";
+
+#ifdef GPUSIM_ENABLE_TRACING
+    std::cout << "Tracing hooks: compiled in\n";
+#else
+    std::cout << "Tracing hooks: compiled out\n";
+#endif
+
+    auto memory_controller = std::make_shared<MemoryController>();
+    ComputeUnit cu(0, memory_controller);
+    EventTracer tracer(1, "bench_trace.bin");
+
+    // Warm up allocators and caches
+    runRounds(cu);
+
+    // Interleave the modes so drift affects both; keep the best of each
+    double best_off = 0.0;
+    double best_on = 0.0;
+    for (size_t rep = 0; rep < kRepetitions; ++rep) {
+        cu.setEventRing(nullptr);
+        double off = runRounds(cu);
+
+        if (!tracer.start()) return 1;
+        cu.setEventRing(tracer.getRing(0));
+        double on = runRounds(cu);
+        cu.setEventRing(nullptr);
+        if (!tracer.stop()) return 1;
+
+        best_off = rep == 0 ? off : std::min(best_off, off);
+        best_on = rep == 0 ? on : std::min(best_on, on);
+    }
+
+    double overhead_pct = best_off > 0 ? (best_on - best_off) / best_off * 100.0 : 0.0;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Tracing off: " << best_off << " ns/cycle\n";
+    std::cout << "Tracing on:  " << best_on << " ns/cycle\n";
+    std::cout << "Overhead:    " << overhead_pct << "% (budget " << kOverheadBudgetPct << "%)\n";
+    tracer.printSummary();
+
+    return overhead_pct <= kOverheadBudgetPct ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#ifndef BATCHER_H
+#define BATCHER_H
+
+#include "types.h"
+#include "workload.h"
+#include "gpu_device.h"
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <thread>
+#include <future>
+#include <chrono>
+#include <condition_variable>
+
+namespace GPUSim {
+
+// Knobs of the latency/throughput trade-off
+struct BatchingPolicy {
+    size_t max_batch_size; // Requests coalesced into one kernel
+    double max_wait_ms;    // Longest a request waits for its batch to fill
+
+    BatchingPolicy(size_t batch_size = 8, double wait_ms = 5.0)
+        : max_batch_size(batch_size), max_wait_ms(wait_ms) {}
+};
+
+struct BatchingStats {
+    size_t requests_completed;
+    size_t requests_rejected;
+    size_t batches_launched;
+    double average_batch_size;
+    double p50_latency_ms; // Request arrival to batch completion
+    double p95_latency_ms;
+    double p99_latency_ms;
+    double max_latency_ms;
+    double throughput_rps; // Completed requests per second of wall time
+};
+
+// Front end that sits in front of the device's scheduler and coalesces small
+// compatible requests (same workload type and shape class) into one larger
+// grid, launching a batch when it is full or its oldest request has waited
+// max_wait_ms
+class BatchingFrontend {
+private:
+    // Workload type, block dims, log2(grid blocks)
+    using ShapeClass = std::tuple<int, size_t, size_t, size_t, int>;
+
+    struct Request {
+        std::shared_ptr<Workload> workload;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    struct LaunchedBatch {
+        std::future<WorkloadMetrics> result;
+        size_t requests;
+    };
+
+    GPUDevice& device_;
+    BatchingPolicy policy_;
+
+    std::map<ShapeClass, std::vector<Request>> open_batches_;
+    std::mutex batch_mutex_;
+    std::condition_variable batch_cv_;
+    std::thread flusher_;
+    bool stopping_;
+    size_t launches_in_flight_; // Taken from open_batches_, not yet in launched_batches_
+    std::condition_variable launch_cv_; // Signalled when launches_in_flight_ drops to zero
+
+    // Results
+    mutable std::mutex stats_mutex_;
+    std::vector<double> latencies_ms_;
+    std::vector<LaunchedBatch> launched_batches_;
+    size_t requests_rejected_;
+    size_t batches_launched_;
+    size_t requests_launched_;
+    std::chrono::steady_clock::time_point first_arrival_;
+    std::chrono::steady_clock::time_point last_completion_;
+
+    static ShapeClass classify(const Workload& workload);
+    void flusherThread();
+    void launchBatch(std::vector<Request> batch); // Non-empty, counted in launches_in_flight_
+
+public:
+    BatchingFrontend(GPUDevice& device, const BatchingPolicy& policy = BatchingPolicy());
+    ~BatchingFrontend();
+
+    BatchingFrontend(const BatchingFrontend&) = delete;
+    BatchingFrontend& operator=(const BatchingFrontend&) = delete;
+
+    void submit(std::shared_ptr<Workload> request);
+
+    // Launch every open batch and wait until all launched batches complete
+    void drain();
+
+    const BatchingPolicy& getPolicy() const { return policy_; }
+    BatchingStats getStats() const;
+    void printReport() const;
+};
+
+} // namespace GPUSim
+
+#endif // BATCHER_H
@@ -0,0 +1,179 @@
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include "types.h"
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace GPUSim {
+
+// Fixed-width column types. DICT columns hold a 32-bit code into the file's
+// string dictionary, so repeated names cost four bytes a row.
+enum class ColumnType : uint8_t {
+    U32,
+    U64,
+    F64,
+    DICT
+};
+
+size_t columnTypeWidth(ColumnType type);
+
+struct ColumnSpec {
+    std::string name;
+    ColumnType type;
+};
+
+// Columnar results file, little-endian:
+//
+//   header   "GPUSIMCR", uint32 version, uint32 byte-order mark
+//   chunks   per chunk of up to rows_per_chunk rows, each column's values
+//            back to back, every column padded to 8 bytes
+//   footer   schema, rows per chunk, chunk directory {offset, rows} and the
+//            string dictionary
+//   trailer  uint64 footer offset, "GPUSIMCR"
+//
+// Chunk data is 8-byte aligned, so a mapped file can be read in place.
+//
+// Rows are filled column by column and committed with endRow(). Full
+// chunks go to a background thread that writes them while the next chunk
+// fills; at most two wait, after which endRow() blocks.
+class ColumnarWriter {
+private:
+    struct Chunk {
+        size_t rows = 0;
+        std::vector<std::vector<uint8_t>> columns;
+    };
+
+    struct ChunkInfo {
+        uint64_t offset;
+        uint64_t rows;
+    };
+
+    std::string path_;
+    std::vector<ColumnSpec> schema_;
+    size_t rows_per_chunk_;
+    std::FILE* file_;
+    std::vector<char> file_buffer_;
+
+    // Producer side
+    Chunk current_;
+    std::vector<bool> row_set_; // Columns filled for the current row
+    std::unordered_map<std::string, uint32_t> dictionary_index_;
+    std::vector<std::string> dictionary_;
+    uint64_t rows_written_;
+
+    // Handoff to the writer thread
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::deque<Chunk> queue_;
+    bool closing_;
+    std::thread writer_;
+
+    // Writer thread side
+    uint64_t file_offset_;
+    std::vector<ChunkInfo> chunks_;
+    bool write_failed_;
+
+    Chunk makeChunk() const;
+    void setValue(size_t column, ColumnType type, const void* value);
+    void submitChunk();
+    void writerThread();
+    void writeBytes(const void* data, size_t size);
+
+public:
+    ColumnarWriter(const std::string& path, std::vector<ColumnSpec> schema,
+                   size_t rows_per_chunk = 64 * 1024);
+    ~ColumnarWriter();
+
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    bool open();
+    bool close(); // Writes the last chunk and the footer; false on I/O error
+    bool isOpen() const { return file_ != nullptr; }
+
+    const std::vector<ColumnSpec>& getSchema() const { return schema_; }
+    int findColumn(const std::string& name) const; // -1 if absent
+
+    // Values for the current row; unset columns are written as zero
+    void setU32(size_t column, uint32_t value);
+    void setU64(size_t column, uint64_t value);
+    void setF64(size_t column, double value);
+    void setString(size_t column, const std::string& value);
+    void endRow();
+
+    uint64_t getRowCount() const { return rows_written_; }
+};
+
+// Maps a columnar results file and reads it in place: column data is
+// returned as pointers into the mapping, strings as views of it.
+class ColumnarReader {
+private:
+    struct ChunkInfo {
+        uint64_t offset;
+        uint64_t rows;
+    };
+
+    const uint8_t* data_;
+    size_t size_;
+#if defined(_WIN32)
+    void* file_handle_;
+    void* mapping_handle_;
+#else
+    int fd_;
+#endif
+
+    std::vector<ColumnSpec> columns_;
+    std::vector<ChunkInfo> chunks_;
+    std::vector<std::string_view> dictionary_;
+    uint64_t rows_per_chunk_;
+    uint64_t num_rows_;
+
+    bool parseFooter();
+    const uint8_t* columnData(size_t chunk, size_t column) const;
+    const uint8_t* cell(size_t column, uint64_t row) const;
+
+public:
+    ColumnarReader();
+    ~ColumnarReader();
+
+    ColumnarReader(const ColumnarReader&) = delete;
+    ColumnarReader& operator=(const ColumnarReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    uint64_t getNumRows() const { return num_rows_; }
+    size_t getNumColumns() const { return columns_.size(); }
+    size_t getNumChunks() const { return chunks_.size(); }
+    uint64_t getChunkRows(size_t chunk) const { return chunks_[chunk].rows; }
+    const ColumnSpec& getColumn(size_t column) const { return columns_[column]; }
+    int findColumn(const std::string& name) const; // -1 if absent
+
+    // A chunk's values of one column, in place. T must match the column
+    // width: uint32_t for U32 and DICT, uint64_t for U64, double for F64.
+    template <typename T>
+    const T* getChunkData(size_t chunk, size_t column) const {
+        return reinterpret_cast<const T*>(columnData(chunk, column));
+    }
+
+    // Single values by row, for lookups rather than scans
+    uint32_t getU32(size_t column, uint64_t row) const;
+    uint64_t getU64(size_t column, uint64_t row) const;
+    double getF64(size_t column, uint64_t row) const;
+    std::string_view getString(size_t column, uint64_t row) const;
+
+    std::string_view getDictionaryEntry(uint32_t code) const;
+    size_t getDictionarySize() const { return dictionary_.size(); }
+};
+
+} // namespace GPUSim
+
+#endif // COLUMNAR_H
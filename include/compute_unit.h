@@ -4,6 +4,10 @@
 #include "types.h"
 #include "warp.h"
 #include "memory.h"
+#include "event_trace.h"
+#include "occupancy.h"
+#include "histogram.h"
+#include "host_profile.h"
 #include <queue>
 #include <mutex>
 #include <condition_variable>
@@ -13,6 +17,8 @@
 
 namespace GPUSim {
 
+class TimelineTracer;
+
 // Warp Scheduler: Selects which warp to execute on a compute unit
 class WarpScheduler {
 private:
@@ -52,12 +58,39 @@ private:
     std::atomic<uint64_t> warps_executed_;
     std::atomic<uint64_t> idle_cycles_;
     std::atomic<uint64_t> cycles_stalled_;
+    LatencyHistogram stall_histogram_; // Stall durations; written by the CU thread only
+
+    // Stall reasons: cycles the pipeline was blocked by in-line memory
+    // stalls, and the per-reason totals of the blocks completed here
+    std::atomic<uint64_t> blocked_cycles_;
+    StallBreakdown stall_breakdown_; // Written by the CU thread only
+
+    // Host time of this CU's thread; memory accesses are timed one in N
+    PhaseTimes phase_times_;
+    uint64_t memory_timer_tick_;
+
+    void accountWarpWait(Warp* warp);
+
+    // Occupancy sampling, on this CU's clock
+    OccupancyRing* occupancy_ring_; // Optional, owned by the device's OccupancySampler
+    uint64_t occupancy_interval_;
+    uint64_t next_sample_cycle_;
+    uint64_t sampled_instructions_; // Instruction count at the previous sample
+    uint64_t last_simulated_cycle_; // Clock when the previous simulateCycle ended
+
+    // Samples every interval boundary up to cycle, so buckets the clock
+    // jumps over are filled too; idle buckets hold no blocks
+    void sampleOccupancy(uint64_t cycle, bool idle = false);
 
     // Memory controller reference
     std::shared_ptr<MemoryController> memory_controller_;
 
+    TimelineTracer* tracer_; // Optional, owned by the device
+    EventRing* event_ring_;  // Optional, owned by the device's EventTracer; CU thread only
+
 public:
-    ComputeUnit(CoreID id, std::shared_ptr<MemoryController> mem_ctrl);
+    ComputeUnit(CoreID id, std::shared_ptr<MemoryController> mem_ctrl,
+                size_t max_warps = 64, size_t max_blocks = 16);
 
     CoreID getCoreID() const { return core_id_; }
     ExecutionState getState() const { return state_; }
@@ -65,11 +98,20 @@ public:
     // Block management
     bool canAcceptBlock(const ThreadBlock* block) const;
     bool assignBlock(std::unique_ptr<ThreadBlock> block);
-    void removeCompletedBlocks();
+    std::vector<std::unique_ptr<ThreadBlock>> removeCompletedBlocks(); // Returns retired blocks
 
     // Execution
     void executeWarp(Warp* warp, size_t num_instructions);
     void simulateCycle();
+    void start(); // Arms the run loop; call before run() is spawned
+
+    // An idle CU's clock stops; bring it up to the device clock before it
+    // receives new work so the gap counts as idle cycles
+    void syncClock(uint64_t cycle);
+
+    void setTracer(TimelineTracer* tracer) { tracer_ = tracer; }
+    void setEventRing(EventRing* ring) { event_ring_ = ring; }
+    void setOccupancyRing(OccupancyRing* ring, uint64_t interval_cycles);
     void run();
     void stop();
 
@@ -86,6 +128,9 @@ public:
     uint64_t getInstructionsExecuted() const { return instructions_executed_.load(); }
     uint64_t getWarpsExecuted() const { return warps_executed_.load(); }
     uint64_t getIdleCycles() const { return idle_cycles_.load(); }
+    const LatencyHistogram& getStallHistogram() const { return stall_histogram_; } // Read once stopped
+    StallBreakdown getStallBreakdown() const; // Completed blocks plus idle cycles; read once stopped
+    const PhaseTimes& getPhaseTimes() const { return phase_times_; } // Read once stopped
     double getUtilization() const;
 
     void resetMetrics();
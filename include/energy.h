@@ -0,0 +1,70 @@
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include "types.h"
+
+namespace GPUSim {
+
+// Energy per operation of one lane, in picojoules, plus leakage. Each
+// device profile in GPUConfig carries its own set.
+struct EnergyCoefficients {
+    double alu_pj;             // Integer and simple FP32 op
+    double fma_pj;             // FP32 fused multiply-add
+    double mma_pj;             // Tensor-core matrix multiply-accumulate, per lane
+    double register_file_pj;   // One operand read or write
+    double shared_memory_pj;   // One 32-bit shared memory access
+    double l1_pj;              // One 32-bit L1 access
+    double l2_pj;              // One 32-bit L2 access
+    double dram_pj_per_byte;
+    double leakage_w_per_cu;   // Static power of a compute unit while it is active
+
+    // Default: RTX 3080 class part (8 nm, GDDR6X)
+    EnergyCoefficients()
+        : alu_pj(1.2),
+          fma_pj(2.4),
+          mma_pj(4.0),
+          register_file_pj(1.0),
+          shared_memory_pj(5.0),
+          l1_pj(8.0),
+          l2_pj(20.0),
+          dram_pj_per_byte(58.0),
+          leakage_w_per_cu(0.9) {}
+};
+
+// What a kernel's instructions do, which the simulated counters do not
+// record: arithmetic instructions split by class, and where its memory
+// instructions are served
+struct InstructionMix {
+    double alu_fraction;
+    double fma_fraction;
+    double mma_fraction;
+    double shared_fraction; // Memory instructions served from shared memory
+    double l1_hit_rate;     // Of the rest
+    double l2_hit_rate;     // Of the L1 misses; the remainder goes to DRAM
+
+    static InstructionMix forType(WorkloadType type);
+};
+
+struct EnergyBreakdown {
+    double compute_j;
+    double register_file_j;
+    double shared_memory_j;
+    double cache_j; // L1 and L2
+    double dram_j;
+    double static_j;
+
+    double dynamicJoules() const {
+        return compute_j + register_file_j + shared_memory_j + cache_j + dram_j;
+    }
+    double totalJoules() const { return dynamicJoules() + static_j; }
+};
+
+// Energy of a run of warp instructions on lanes-wide warps, with leakage
+// over active_cu_seconds of compute unit time
+EnergyBreakdown estimateEnergy(const EnergyCoefficients& coefficients, const InstructionMix& mix,
+                               uint64_t instructions, uint64_t memory_ops, size_t lanes,
+                               double active_cu_seconds);
+
+} // namespace GPUSim
+
+#endif // ENERGY_H
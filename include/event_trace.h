@@ -0,0 +1,132 @@
+#ifndef EVENT_TRACE_H
+#define EVENT_TRACE_H
+
+#include "types.h"
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GPUSim {
+
+enum class TraceEventType : uint8_t {
+    BLOCK_START,
+    BLOCK_END,
+    WARP_STALL,
+    WARP_DONE
+};
+
+// Fixed-size binary trace record. The compute unit is implied by the ring the
+// record came from and is written once per chunk by the drainer.
+struct TraceRecord {
+    uint64_t cycle;        // CU clock
+    uint32_t block_id;
+    uint16_t warp_id;
+    uint8_t type;          // TraceEventType
+    uint8_t workload_tag;  // Low bits of the workload id, tells co-runners apart
+};
+
+static_assert(sizeof(TraceRecord) == 16, "TraceRecord must stay 16 bytes");
+
+// Single-producer single-consumer ring of trace records. The owning compute
+// unit thread pushes, the drainer pops; a full ring drops records rather
+// than stalling the simulation.
+class EventRing {
+private:
+    std::vector<TraceRecord> buffer_;
+    size_t mask_;
+
+    alignas(64) std::atomic<uint64_t> head_; // Next slot to write, producer owned
+    uint64_t cached_tail_;                   // Producer's last view of tail_
+    std::atomic<uint64_t> dropped_;
+
+    alignas(64) std::atomic<uint64_t> tail_; // Next slot to read, consumer owned
+
+public:
+    explicit EventRing(size_t capacity); // Rounded up to a power of two
+
+    EventRing(const EventRing&) = delete;
+    EventRing& operator=(const EventRing&) = delete;
+
+    bool push(const TraceRecord& record) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - cached_tail_ > mask_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - cached_tail_ > mask_) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        buffer_[head & mask_] = record;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: write everything currently in the ring straight from
+    // the buffer, as at most two contiguous spans, then release the slots.
+    // Returns false, releasing nothing, if a write fails.
+    bool drainTo(std::FILE* file, uint32_t compute_unit, size_t& drained);
+
+    size_t getCapacity() const { return buffer_.size(); }
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+};
+
+// Owns one ring per compute unit and a background thread that drains them to
+// a binary file: a header, then chunks of {uint32 compute unit, uint32 count,
+// count x TraceRecord}.
+class EventTracer {
+private:
+    std::vector<std::unique_ptr<EventRing>> rings_;
+    std::string output_path_;
+    std::FILE* file_;
+    std::thread drainer_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> records_written_;
+    std::atomic<bool> write_failed_; // Stops draining; the file is incomplete
+    std::vector<char> file_buffer_;
+
+    void drainerThread();
+    size_t drainOnce();
+
+public:
+    EventTracer(size_t num_compute_units, const std::string& output_path,
+                size_t ring_capacity = 32 * 1024);
+    ~EventTracer();
+
+    EventTracer(const EventTracer&) = delete;
+    EventTracer& operator=(const EventTracer&) = delete;
+
+    EventRing* getRing(size_t compute_unit);
+    size_t getNumRings() const { return rings_.size(); }
+
+    bool start();
+    bool stop(); // Drains what is left and closes the file; false if a write failed
+    bool isRunning() const { return running_.load(); }
+
+    uint64_t getRecordsWritten() const { return records_written_.load(); }
+    bool hasWriteFailed() const { return write_failed_.load(); }
+    uint64_t getDroppedCount() const;
+    void printSummary() const;
+};
+
+} // namespace GPUSim
+
+// Tracing hook for hot paths. Building without GPUSIM_ENABLE_TRACING removes
+// every hook, arguments included.
+#ifdef GPUSIM_ENABLE_TRACING
+#define GPUSIM_TRACE_EVENT(ring, event_type, cycle, block, warp, workload)                  \
+    do {                                                                                    \
+        if (ring) {                                                                         \
+            (ring)->push(GPUSim::TraceRecord{(cycle), static_cast<uint32_t>(block),         \
+                                             static_cast<uint16_t>(warp),                   \
+                                             static_cast<uint8_t>(event_type),              \
+                                             static_cast<uint8_t>(workload)});              \
+        }                                                                                   \
+    } while (0)
+#else
+#define GPUSIM_TRACE_EVENT(ring, event_type, cycle, block, warp, workload) do {} while (0)
+#endif
+
+#endif // EVENT_TRACE_H
@@ -6,14 +6,44 @@
 #include "memory.h"
 #include "scheduler.h"
 #include "metrics.h"
+#include "tracer.h"
+#include "live_metrics.h"
+#include "columnar.h"
+#include "energy.h"
+#include "record_sink.h"
 #include <vector>
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <map>
 
 namespace GPUSim {
 
+// Limits on work admitted to the device but not yet launched (0 = unlimited)
+struct AdmissionLimits {
+    size_t max_pending_workloads;
+    size_t max_pending_blocks;
+    size_t max_pending_memory_bytes; // Host footprint of the pending blocks
+
+    AdmissionLimits()
+        : max_pending_workloads(0),
+          max_pending_blocks(0),
+          max_pending_memory_bytes(0) {}
+};
+
+// Admission outcomes since the device was created or reset
+struct AdmissionStats {
+    uint64_t admitted;
+    uint64_t rejected;
+    double average_wait_ms; // Time blocked in submitWorkload before admission
+    double max_wait_ms;
+};
+
 // GPU Device Configuration
 struct GPUConfig {
     size_t num_compute_units;
@@ -23,6 +53,12 @@ struct GPUConfig {
     size_t global_memory_size;
     size_t shared_memory_per_block;
     std::string device_name;
+    double core_clock_mhz; // Converts simulated cycles to simulated time
+    double fp32_flops_per_cu_cycle; // Peak compute, per compute unit
+    double memory_bandwidth_gbs;    // Peak DRAM bandwidth
+    size_t global_memory_latency;   // Cycles per global memory access
+    EnergyCoefficients energy;
+    AdmissionLimits admission;
 
     // Default: Similar to NVIDIA RTX 3080
     GPUConfig()
@@ -32,14 +68,50 @@ struct GPUConfig {
           max_blocks_per_cu(16),
           global_memory_size(10ULL * 1024 * 1024 * 1024), // 10GB
           shared_memory_per_block(48 * 1024),
-          device_name("GPU Simulator - RTX 3080 Profile") {}
+          device_name("GPU Simulator - RTX 3080 Profile"),
+          core_clock_mhz(1710.0),
+          fp32_flops_per_cu_cycle(64.0), // One warp instruction a cycle, a multiply-add per lane
+          memory_bandwidth_gbs(760.0),
+          global_memory_latency(GLOBAL_MEMORY_LATENCY) {}
+
+    // Other device profiles; the default is rtx3080()
+    static GPUConfig rtx3080() { return GPUConfig(); }
+    static GPUConfig a100();
+    static GPUConfig h100();
+
+    // Looks up a profile by name: rtx3080, a100 or h100
+    static bool fromPreset(const std::string& name, GPUConfig& config);
 };
 
+// Invoked on the distributor thread when a workload submitted with
+// submitAsync() completes; must not block
+using CompletionCallback = std::function<void(const WorkloadMetrics&)>;
+
 // Main GPU Device class
 class GPUDevice {
 private:
+    // A launched workload and the compute units reserved for it
+    struct ActiveWorkload {
+        std::shared_ptr<Workload> workload;
+        std::vector<ComputeUnit*> compute_units;
+        std::unique_ptr<ThreadBlock> next_block; // Waiting for room on a CU
+        size_t blocks_retired;
+    };
+
+    // Completion handle of a workload submitted with submitAsync()
+    struct PendingCompletion {
+        std::promise<WorkloadMetrics> promise;
+        CompletionCallback callback;
+    };
+
     GPUConfig config_;
     std::vector<std::unique_ptr<ComputeUnit>> compute_units_;
+
+    // Status lines; the distributor and the submitting threads both write
+    std::ostream* log_;
+    std::mutex log_mutex_;
+    void logStatus(const std::string& line);
+
     std::shared_ptr<MemoryController> memory_controller_;
     std::unique_ptr<Scheduler> scheduler_;
 
@@ -52,15 +124,65 @@ private:
 
     // Performance tracking
     std::unique_ptr<PerformanceAnalyzer> performance_analyzer_;
-    std::atomic<uint64_t> global_cycle_count_;
+    std::atomic<uint64_t> global_cycle_count_; // Furthest CU clock
+    std::shared_ptr<TimelineTracer> tracer_;
+    std::shared_ptr<EventTracer> event_tracer_;
+    std::shared_ptr<ColumnarWriter> block_record_writer_;
+    std::shared_ptr<RecordSink> record_sink_;
+    std::shared_ptr<OccupancySampler> occupancy_sampler_;
+    PhaseTimes distributor_phase_times_; // Written by the distributor thread only
+
+    // Lock-free view for live scrapers, refreshed by the distributor
+    LiveMetrics live_metrics_;
+    std::chrono::steady_clock::time_point last_live_publish_;
+    uint64_t last_live_instructions_;
+
+    // Admission control: work accepted by submit but not yet launched
+    mutable std::mutex admission_mutex_;
+    std::condition_variable admission_cv_;
+    size_t pending_workloads_;
+    size_t pending_blocks_;
+    size_t pending_memory_bytes_;
+    uint64_t workloads_admitted_;
+    uint64_t workloads_rejected_;
+    double total_admission_wait_ms_;
+    double max_admission_wait_ms_;
+
+    // Asynchronous completion
+    std::mutex completion_mutex_;
+    std::condition_variable idle_cv_;
+    std::map<uint64_t, PendingCompletion> pending_completions_;
 
     // Private methods
     void initializeComputeUnits();
     void distributorThread(); // Distributes blocks to CUs
+    bool launchWorkloads(std::vector<ActiveWorkload>& active, std::vector<bool>& allocated);
+    void launchOnComputeUnits(std::vector<ActiveWorkload>& active, std::shared_ptr<Workload> workload,
+                              const std::vector<ComputeUnit*>& compute_units);
+    bool dispatchBlocks(std::vector<ActiveWorkload>& active);
+    bool retireWorkloads(std::vector<ActiveWorkload>& active, std::vector<bool>& allocated);
+    void advanceGlobalClock();
+    void raiseGlobalClock(uint64_t cycle);
+    void publishLiveMetrics();
+    void recordBlockRow(const Workload& workload, const ThreadBlock& block, size_t compute_unit);
     void cuExecutionThread(ComputeUnit* cu);
 
+    bool fitsAdmissionLimits(const Workload& workload) const; // Requires admission_mutex_
+    bool fitsComputeUnit(const Workload& workload) const;     // A block's warps fit on one CU
+    // Counts the workload against the limits in the same critical section
+    // as the fitsAdmissionLimits check, so concurrent submitters cannot
+    // overshoot them together
+    void reserveAdmission(const Workload& workload, double wait_ms); // Requires admission_mutex_
+    void admitWorkload(std::shared_ptr<Workload> workload);
+    void rejectWorkload(const Workload& workload, const char* reason);
+    void releaseAdmission(const Workload& workload);
+
+    void resolveCompletion(const Workload& workload, const WorkloadMetrics& metrics);
+    bool hasOutstandingWork() const;
+
 public:
-    GPUDevice(const GPUConfig& config = GPUConfig());
+    // Status lines go to log, which must outlive the device
+    GPUDevice(const GPUConfig& config = GPUConfig(), std::ostream& log = std::cout);
     ~GPUDevice();
 
     // Device information
@@ -71,16 +193,78 @@ public:
     void setScheduler(std::unique_ptr<Scheduler> scheduler);
     Scheduler* getScheduler() { return scheduler_.get(); }
 
-    // Workload management
-    void submitWorkload(std::shared_ptr<Workload> workload);
+    // Workload management. submitWorkload blocks while the admission limits
+    // are exceeded and the device is running; trySubmitWorkload rejects
+    // instead. Both return whether the workload was accepted.
+    bool submitWorkload(std::shared_ptr<Workload> workload);
+    bool trySubmitWorkload(std::shared_ptr<Workload> workload);
+    void setAdmissionLimits(const AdmissionLimits& limits);
+    AdmissionStats getAdmissionStats() const;
+    size_t getPendingWorkloadCount() const;
+
+    // Non-blocking submission that may be called while the device runs. The
+    // future resolves with the workload's metrics once it completes, or holds
+    // an exception if admission control rejects it.
+    std::future<WorkloadMetrics> submitAsync(std::shared_ptr<Workload> workload,
+                                             CompletionCallback on_complete = nullptr);
+
     void executeWorkloads();
-    void waitForCompletion();
+    void waitForIdle();        // Wait for submitted work; the device keeps running
+    void waitForCompletion();  // Wait for submitted work, then stop the device
 
     // Execution control
     void start();
     void stop();
     bool isRunning() const { return running_.load(); }
 
+    // Simulated time: the device clock is the furthest compute unit clock
+    uint64_t getCurrentCycle() const { return global_cycle_count_.load(); }
+    double cyclesToNs(uint64_t cycles) const { return cycles * 1000.0 / config_.core_clock_mhz; }
+    uint64_t nsToCycles(double ns) const { return static_cast<uint64_t>(ns * config_.core_clock_mhz / 1000.0); }
+
+    // Moves an idle device's clock forward to cycle, as if it had sat idle
+    // until then. Returns false, leaving the clock alone, while work is
+    // outstanding.
+    bool advanceIdleClock(uint64_t cycle);
+
+    // Roofs for roofline analysis
+    double getPeakGflops() const {
+        return config_.num_compute_units * config_.fp32_flops_per_cu_cycle * config_.core_clock_mhz / 1000.0;
+    }
+    double getPeakBandwidthGBs() const { return config_.memory_bandwidth_gbs; }
+
+    // Host time per phase summed over the simulator's threads; read once stopped
+    PhaseTimes getPhaseTimes() const;
+
+    // Counters refreshed while running; safe to read from any thread
+    const LiveMetrics& getLiveMetrics() const { return live_metrics_; }
+
+    // Optional timeline tracing; set while the device is stopped
+    void setTracer(std::shared_ptr<TimelineTracer> tracer);
+    TimelineTracer* getTracer() { return tracer_.get(); }
+
+    // Optional per-CU binary event rings, drained while the device runs;
+    // needs one ring per compute unit and is set while the device is stopped
+    void setEventTracer(std::shared_ptr<EventTracer> tracer);
+    EventTracer* getEventTracer() { return event_tracer_.get(); }
+
+    // Optional per-block records, one row per retired block, appended by
+    // the distributor. The writer must be open, use getBlockRecordSchema()
+    // and be set while the device is stopped; the caller closes it.
+    void setBlockRecordWriter(std::shared_ptr<ColumnarWriter> writer);
+    static std::vector<ColumnSpec> getBlockRecordSchema();
+
+    // Optional stream of block and kernel records, written by the distributor
+    // as they retire and flushed with the live metrics. Set while the device
+    // is stopped; the caller opens the sink and closes it after stop().
+    void setRecordSink(std::shared_ptr<RecordSink> sink);
+    RecordSink* getRecordSink() { return record_sink_.get(); }
+
+    // Optional per-CU occupancy sampling; needs one ring per compute unit
+    // and is set while the device is stopped
+    void setOccupancySampler(std::shared_ptr<OccupancySampler> sampler);
+    OccupancySampler* getOccupancySampler() { return occupancy_sampler_.get(); }
+
     // Performance metrics
     PerformanceAnalyzer* getPerformanceAnalyzer() { return performance_analyzer_.get(); }
     const PerformanceAnalyzer* getPerformanceAnalyzer() const { return performance_analyzer_.get(); }
@@ -99,7 +283,7 @@ public:
 
     // Utility
     void printDeviceInfo() const;
-    void reset();
+    void reset(); // Stops the device and clears its counters and metrics for another run
 };
 
 } // namespace GPUSim
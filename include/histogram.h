@@ -0,0 +1,59 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include "types.h"
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace GPUSim {
+
+// HDR-style log-linear histogram of non-negative integer values. Values below
+// 2^precision_bits are counted exactly; above that each power of two is split
+// into 2^(precision_bits - 1) buckets, so any recorded value is reproduced to
+// within 2^(1 - precision_bits) relative error. Recording is a few integer
+// operations and no allocation once the range has been seen. Not thread safe:
+// keep one histogram per writer and merge them.
+class LatencyHistogram {
+private:
+    int precision_bits_;
+    std::vector<uint64_t> counts_; // Grows to the highest bucket recorded
+    uint64_t total_count_;
+    uint64_t min_;
+    uint64_t max_;
+    double sum_;
+
+    size_t bucketIndex(uint64_t value) const;
+    uint64_t bucketLowerBound(size_t index) const;
+    uint64_t bucketUpperBound(size_t index) const;
+
+public:
+    explicit LatencyHistogram(int precision_bits = 7);
+
+    void record(uint64_t value, uint64_t count = 1);
+
+    // Fold another histogram into this one; both must share a precision
+    bool merge(const LatencyHistogram& other);
+
+    uint64_t getCount() const { return total_count_; }
+    uint64_t getMin() const { return total_count_ ? min_ : 0; }
+    uint64_t getMax() const { return max_; }
+    double getMean() const { return total_count_ ? sum_ / total_count_ : 0.0; }
+    int getPrecisionBits() const { return precision_bits_; }
+
+    // Value at or below which the given percentage (0-100) of samples fall,
+    // reported as the upper edge of its bucket clamped to the observed range
+    uint64_t getPercentile(double percentile) const;
+
+    // Text form: a header line, then one "bucket count" line per non-empty
+    // bucket, so files from parallel runs can be loaded and merged
+    void serialize(std::ostream& out) const;
+    bool deserialize(std::istream& in);
+
+    void print(const std::string& label, const std::string& unit, double scale = 1.0) const;
+    void reset();
+};
+
+} // namespace GPUSim
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,106 @@
+#ifndef HOST_PROFILE_H
+#define HOST_PROFILE_H
+
+#include "types.h"
+#include <array>
+
+namespace GPUSim {
+
+// Where the simulator spends host time
+enum class SimPhase {
+    DISPATCH,     // Distributor: clock, launch and block dispatch
+    EXECUTION,    // Compute units: warp scheduling and issue
+    MEMORY_MODEL, // Memory accesses and stalls within execution
+    METRICS,      // Retirement bookkeeping, counters and tracing
+    COUNT
+};
+
+constexpr size_t NUM_SIM_PHASES = static_cast<size_t>(SimPhase::COUNT);
+
+inline const char* simPhaseName(SimPhase phase) {
+    switch (phase) {
+        case SimPhase::DISPATCH: return "Dispatch";
+        case SimPhase::EXECUTION: return "Execution";
+        case SimPhase::MEMORY_MODEL: return "Memory Model";
+        case SimPhase::METRICS: return "Metrics";
+        default: return "Unknown";
+    }
+}
+
+// Host nanoseconds per phase. Each simulator thread owns one and they are
+// merged once the threads have stopped, so adding is a plain increment.
+struct PhaseTimes {
+    std::array<uint64_t, NUM_SIM_PHASES> ns{};
+
+    void add(SimPhase phase, uint64_t nanoseconds) { ns[static_cast<size_t>(phase)] += nanoseconds; }
+    uint64_t get(SimPhase phase) const { return ns[static_cast<size_t>(phase)]; }
+
+    void merge(const PhaseTimes& other) {
+        for (size_t i = 0; i < NUM_SIM_PHASES; ++i) ns[i] += other.ns[i];
+    }
+    void reset() { ns.fill(0); }
+};
+
+// Host CPU time consumed by the calling thread, in nanoseconds. Unlike a
+// wall clock it does not advance while the thread is preempted, so phase
+// times stay meaningful when simulator threads outnumber host cores.
+uint64_t threadCpuTimeNs();
+
+// Charges the calling thread's CPU time over a scope to a phase. The clock
+// read costs a system call on most hosts, so use it around coarse scopes.
+class ScopedPhaseTimer {
+private:
+    PhaseTimes& times_;
+    SimPhase phase_;
+    uint64_t start_ns_;
+
+public:
+    ScopedPhaseTimer(PhaseTimes& times, SimPhase phase)
+        : times_(times), phase_(phase), start_ns_(threadCpuTimeNs()) {}
+
+    ~ScopedPhaseTimer() { times_.add(phase_, threadCpuTimeNs() - start_ns_); }
+
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+};
+
+// Cost of an empty threadCpuTimeNs() scope, measured once and subtracted
+// from sampled timings, which are otherwise dominated by it
+uint64_t threadCpuTimeOverheadNs();
+
+// Times one scope in N on the same thread CPU clock as ScopedPhaseTimer, so
+// a sampled phase nested in a scoped one can be subtracted from it, and
+// charges N times its length. For short scopes on hot paths; an inactive
+// timer reads no clock.
+class SampledPhaseTimer {
+private:
+    PhaseTimes& times_;
+    SimPhase phase_;
+    uint64_t weight_; // 0 when inactive
+    uint64_t start_ns_;
+
+public:
+    SampledPhaseTimer(PhaseTimes& times, SimPhase phase, bool active, uint64_t weight)
+        : times_(times), phase_(phase), weight_(active ? weight : 0), start_ns_(0) {
+        if (weight_) start_ns_ = threadCpuTimeNs();
+    }
+
+    ~SampledPhaseTimer() {
+        if (!weight_) return;
+        uint64_t elapsed = threadCpuTimeNs() - start_ns_;
+        uint64_t overhead = threadCpuTimeOverheadNs();
+        if (elapsed > overhead) {
+            times_.add(phase_, weight_ * (elapsed - overhead));
+        }
+    }
+
+    SampledPhaseTimer(const SampledPhaseTimer&) = delete;
+    SampledPhaseTimer& operator=(const SampledPhaseTimer&) = delete;
+};
+
+// Peak resident set size of this process in bytes; 0 where unsupported
+size_t getPeakRSSBytes();
+
+} // namespace GPUSim
+
+#endif // HOST_PROFILE_H
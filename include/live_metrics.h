@@ -0,0 +1,63 @@
+#ifndef LIVE_METRICS_H
+#define LIVE_METRICS_H
+
+#include "types.h"
+#include <atomic>
+#include <vector>
+
+namespace GPUSim {
+
+struct LiveComputeUnitMetrics {
+    std::atomic<double> utilization{0.0}; // Percent of cycles not idle
+    std::atomic<uint64_t> active_blocks{0};
+    std::atomic<uint64_t> active_warps{0};
+    std::atomic<uint64_t> cycles{0};
+    std::atomic<uint64_t> instructions{0};
+};
+
+// Counters the device's distributor thread publishes while it runs, for
+// readers outside the simulation. Every field is a relaxed atomic, so a
+// reader never takes a simulator lock or slows the simulation down; fields
+// may come from adjacent publishes.
+struct LiveMetrics {
+    std::vector<LiveComputeUnitMetrics> compute_units;
+
+    std::atomic<uint64_t> simulated_cycles{0};
+    std::atomic<uint64_t> instructions{0};
+    std::atomic<uint64_t> admission_queue_depth{0}; // Admitted, not yet launched
+    std::atomic<uint64_t> scheduler_queue_depth{0}; // Waiting in the scheduler's queue
+    std::atomic<uint64_t> running_workloads{0};
+    std::atomic<uint64_t> completed_workloads{0};
+    std::atomic<uint64_t> rejected_workloads{0};
+    std::atomic<double> host_mips{0.0}; // Over the last publish interval
+    std::atomic<uint64_t> publishes{0};
+
+    explicit LiveMetrics(size_t num_compute_units) : compute_units(num_compute_units) {}
+
+    // Back to zero for another run on the same device
+    void reset() {
+        for (auto& cu : compute_units) {
+            cu.utilization.store(0.0, std::memory_order_relaxed);
+            cu.active_blocks.store(0, std::memory_order_relaxed);
+            cu.active_warps.store(0, std::memory_order_relaxed);
+            cu.cycles.store(0, std::memory_order_relaxed);
+            cu.instructions.store(0, std::memory_order_relaxed);
+        }
+        simulated_cycles.store(0, std::memory_order_relaxed);
+        instructions.store(0, std::memory_order_relaxed);
+        admission_queue_depth.store(0, std::memory_order_relaxed);
+        scheduler_queue_depth.store(0, std::memory_order_relaxed);
+        running_workloads.store(0, std::memory_order_relaxed);
+        completed_workloads.store(0, std::memory_order_relaxed);
+        rejected_workloads.store(0, std::memory_order_relaxed);
+        host_mips.store(0.0, std::memory_order_relaxed);
+        publishes.store(0, std::memory_order_relaxed);
+    }
+
+    LiveMetrics(const LiveMetrics&) = delete;
+    LiveMetrics& operator=(const LiveMetrics&) = delete;
+};
+
+} // namespace GPUSim
+
+#endif // LIVE_METRICS_H
@@ -0,0 +1,113 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include "types.h"
+#include "workload.h"
+#include "gpu_device.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace GPUSim {
+
+// Inter-arrival processes
+enum class ArrivalProcess {
+    POISSON, // Exponential inter-arrival times at a constant rate
+    MMPP,    // Two-state Markov-modulated Poisson: calm periods and bursts
+    DIURNAL  // Sinusoidally varying rate, generated by thinning
+};
+
+// Request size (element count) distributions
+enum class SizeDistribution {
+    FIXED,       // Always min_elements
+    UNIFORM,     // Uniform between min and max elements
+    LOG_UNIFORM, // Uniform in log space: many small requests, a long tail
+    BIMODAL      // Mostly min_elements, a large_fraction of max_elements
+};
+
+struct LoadProfile {
+    ArrivalProcess arrivals;
+    double arrival_rate;  // Long-run mean requests per simulated second
+
+    // MMPP
+    double burst_factor;  // Rate multiplier while bursting
+    double mean_burst_ms;
+    double mean_calm_ms;
+
+    // Diurnal
+    double period_ms;
+    double amplitude;     // Peak rate is arrival_rate * (1 + amplitude)
+
+    SizeDistribution sizes;
+    size_t min_elements;
+    size_t max_elements;
+    double large_fraction; // Bimodal only
+
+    double duration_ms;   // Length of the arrival window; all times are simulated
+    uint64_t seed;
+
+    LoadProfile()
+        : arrivals(ArrivalProcess::POISSON),
+          arrival_rate(50.0),
+          burst_factor(5.0),
+          mean_burst_ms(50.0),
+          mean_calm_ms(200.0),
+          period_ms(1000.0),
+          amplitude(0.8),
+          sizes(SizeDistribution::LOG_UNIFORM),
+          min_elements(4 * 1024),
+          max_elements(64 * 1024),
+          large_fraction(0.1),
+          duration_ms(1000.0),
+          seed(42) {}
+};
+
+// A request in a generated schedule
+struct Arrival {
+    double time_ms; // Simulated offset from the start of the run
+    WorkloadType type;
+    size_t elements;
+
+    std::shared_ptr<Workload> createWorkload() const;
+};
+
+struct LoadRunResult {
+    std::string scheduler_name;
+    size_t requests_offered;
+    size_t requests_completed;
+    size_t requests_rejected;
+    double offered_rate;   // Requests per second in the arrival window
+    double achieved_rate;  // Completed requests per second until the last completion
+    double p50_response_ms; // Arrival to completion, simulated
+    double p95_response_ms;
+    double p99_response_ms;
+    double mean_response_ms;
+    double mean_queue_wait_ms;
+};
+
+// Open-loop load generator: requests arrive on their own schedule whether or
+// not earlier ones have finished, so queueing under load shows up in the
+// response times. Schedules are reproducible from the profile's seed.
+class LoadGenerator {
+private:
+    LoadProfile profile_;
+
+public:
+    explicit LoadGenerator(const LoadProfile& profile = LoadProfile());
+
+    const LoadProfile& getProfile() const { return profile_; }
+
+    std::vector<Arrival> generateSchedule() const;
+
+    // Replay a schedule against a running device on its simulated clock and
+    // wait for every request
+    LoadRunResult run(GPUDevice& device, const std::vector<Arrival>& schedule) const;
+    LoadRunResult run(GPUDevice& device) const { return run(device, generateSchedule()); }
+
+    static std::string arrivalProcessName(ArrivalProcess process);
+    static void printLoadCurve(const std::vector<LoadRunResult>& results);
+};
+
+} // namespace GPUSim
+
+#endif // LOAD_GENERATOR_H
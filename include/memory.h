@@ -30,17 +30,17 @@ public:
     uint64_t getAccessCount() const { return access_count_.load(); }
 };
 
-// Global GPU memory (GDDR/HBM)
+// Global GPU memory (GDDR/HBM). Only accesses are modelled, so there is no
+// backing store and a device costs no host memory for its capacity.
 class GlobalMemory : public Memory {
 private:
-    std::vector<uint8_t> data_;
     std::atomic<uint64_t> read_count_;
     std::atomic<uint64_t> write_count_;
     std::atomic<uint64_t> bytes_read_;
     std::atomic<uint64_t> bytes_written_;
 
 public:
-    GlobalMemory(size_t size = GLOBAL_MEMORY_SIZE);
+    GlobalMemory(size_t size = GLOBAL_MEMORY_SIZE, size_t latency = GLOBAL_MEMORY_LATENCY);
 
     bool read(MemoryAddress address, size_t bytes) override;
     bool write(MemoryAddress address, size_t bytes) override;
@@ -97,7 +97,7 @@ private:
     std::atomic<uint64_t> cache_misses_;
 
 public:
-    MemoryController();
+    explicit MemoryController(size_t global_memory_latency = GLOBAL_MEMORY_LATENCY);
 
     std::shared_ptr<GlobalMemory> getGlobalMemory() { return global_memory_; }
 
@@ -107,6 +107,8 @@ public:
 
     double getCacheHitRate() const;
     uint64_t getTotalMemoryOps() const { return total_memory_ops_.load(); }
+
+    void reset();
 };
 
 } // namespace GPUSim
@@ -2,55 +2,135 @@
 #define METRICS_H
 
 #include "types.h"
+#include "histogram.h"
+#include "host_profile.h"
+#include "roofline.h"
+#include "energy.h"
+#include "statistics.h"
 #include <string>
 #include <vector>
 #include <map>
 #include <memory>
 #include <chrono>
+#include <functional>
+#include <ostream>
 
 namespace GPUSim {
 
 class Workload;
 class GPUDevice;
 
-// Performance metrics for a single workload
+// Performance metrics for a single workload. Simulated times come from the
+// device's cycle clock at its configured core clock; the *_ms host times
+// measure how long the simulator took and feed the schedulers' feedback.
 struct WorkloadMetrics {
     std::string workload_name;
     WorkloadType type;
-    double execution_time_ms;
+    uint64_t simulated_cycles;       // Launch to last block retired
+    double simulated_time_ns;
+    uint64_t queue_wait_cycles;      // Submit to launch
+    double simulated_queue_wait_ns;
+    double execution_time_ms;        // Host wall time
+    double queue_wait_ms;
+    double predicted_time_ns;    // Scheduler's runtime prediction at launch, simulated
+    double prediction_error_pct; // Absolute error of that prediction against simulated time
     uint64_t instructions_executed;
     uint64_t memory_operations;
     uint64_t cycles_executed;
-    double average_cu_utilization;
+    uint64_t flops;        // Arithmetic instructions x lanes x FLOP per lane
+    uint64_t memory_bytes; // Memory instructions x lanes x bytes per lane
+    StallBreakdown stall_cycles; // Non-issuing warp cycles by reason
+    EnergyBreakdown energy;      // Over simulated time, leakage on the CUs it held
+    double average_power_w;
+    double gflops_per_watt;
+    double average_cu_utilization; // Share of its CUs' cycles spent on its own blocks
     size_t total_threads;
     size_t total_blocks;
-    double throughput; // Instructions per millisecond
+    size_t compute_units_allocated;
+    std::string co_runner; // Workload that shared its compute units, if any
+    double throughput; // Instructions per simulated microsecond
 };
 
 // GPU-wide performance metrics
 struct GPUMetrics {
-    uint64_t total_cycles;
+    uint64_t simulated_cycles;       // Furthest compute unit clock
+    double simulated_time_ns;
+    double core_clock_mhz;
+    size_t num_compute_units;
+    uint64_t total_cycles;           // Summed over compute units
     uint64_t total_instructions;
     uint64_t total_memory_ops;
-    double total_execution_time_ms;
+    double total_execution_time_ms;  // Host wall time of the run
     double average_utilization;
-    double memory_bandwidth_utilization;
+    double memory_bandwidth_utilization; // Share of peak bandwidth over the simulated run
+    double peak_gflops;
+    double peak_bandwidth_gbs;
+
+    // Energy: workloads' dynamic energy plus leakage of every CU while active
+    double energy_j;
+    double static_energy_j;
+    double average_power_w; // Over simulated time
+    double gflops_per_watt;
+    double cu_allocation_utilization; // Share of simulated CU-time reserved by workloads
+    double average_queue_wait_ns;     // Simulated, submit to launch
+    double p99_queue_wait_ns;
+    double p99_service_time_ns;       // Simulated, launch to completion
+    double mean_prediction_error_pct;
     size_t total_workloads_executed;
+    uint64_t workloads_admitted;
+    uint64_t workloads_rejected;
+    double average_admission_wait_ms;
+    double max_admission_wait_ms;
+
+    // Simulator cost: how fast the host simulated this run
+    double simulated_mips;                    // Simulated instructions per host microsecond
+    double simulated_cycles_per_host_second;
+    size_t peak_rss_bytes;
+    std::array<double, NUM_SIM_PHASES> phase_time_ms; // Exclusive, summed over threads
 };
 
 // Performance analyzer for collecting and analyzing metrics
 class PerformanceAnalyzer {
 private:
+    // Running totals over every recorded workload, kept whether or not the
+    // per-workload list is
+    struct WorkloadTotals {
+        size_t count = 0;
+        double execution_time_ms = 0.0;
+        double queue_wait_ms = 0.0;
+        double prediction_error_pct = 0.0;
+        double throughput = 0.0;
+        uint64_t queue_wait_cycles = 0;
+        double reserved_cu_cycles = 0.0; // Simulated cycles x CUs the workload could keep busy
+        uint64_t flops = 0;
+        double dynamic_energy_j = 0.0;
+        WorkloadMetrics fastest{}; // By simulated time
+        WorkloadMetrics slowest{};
+    };
+
     std::vector<WorkloadMetrics> workload_metrics_;
+    WorkloadTotals totals_;
+    bool retain_workload_metrics_;
     GPUMetrics gpu_metrics_;
     std::chrono::high_resolution_clock::time_point sim_start_time_;
     std::chrono::high_resolution_clock::time_point sim_end_time_;
 
+    // Latency distributions, in simulated cycles
+    LatencyHistogram queue_wait_cycles_;     // Per workload, submit to start
+    LatencyHistogram service_cycles_;        // Per workload, start to completion
+    LatencyHistogram block_residency_cycles_; // Per block, assignment to completion
+    LatencyHistogram warp_stall_cycles_;     // Per stall, merged from the CUs
+
+    std::vector<StallBreakdown> cu_stall_cycles_; // Per CU, including idle
+
+    RooflineModel getRooflineModel(const WorkloadMetrics& metrics) const; // Scaled to its CUs
+
 public:
     PerformanceAnalyzer();
 
-    void recordWorkloadMetrics(const Workload* workload, const GPUDevice* device);
+    WorkloadMetrics recordWorkloadMetrics(const Workload* workload, const GPUDevice* device);
     void recordGPUMetrics(const GPUDevice* device);
+    void recordBlockResidency(uint64_t cycles) { block_residency_cycles_.record(cycles); }
 
     void startSimulation();
     void endSimulation();
@@ -59,37 +139,109 @@ public:
         return workload_metrics_;
     }
 
+    // Long runs that stream their records (see record_sink.h) can stop
+    // keeping one entry per workload; summaries and histograms still cover
+    // every workload, per-workload reports and exports cover those kept
+    void setRetainWorkloadMetrics(bool retain) { retain_workload_metrics_ = retain; }
+    size_t getWorkloadCount() const { return totals_.count; }
+
     const GPUMetrics& getGPUMetrics() const {
         return gpu_metrics_;
     }
 
     // Analysis functions
-    double getTotalSimulationTime() const;
-    double getAverageThroughput() const;
-    double getAverageWorkloadTime() const;
+    double getTotalSimulationTime() const; // Host wall time, in milliseconds
+    double getSimulatedIPC() const;        // Device-wide instructions per simulated cycle
+    double getAverageThroughput() const;    // Mean over workloads, instructions per simulated us
+    double getAverageWorkloadTime() const;  // Host milliseconds
+    double getAverageQueueWaitTime() const; // Host milliseconds
+    double getMeanPredictionError() const;
+    const LatencyHistogram& getQueueWaitHistogram() const { return queue_wait_cycles_; }
+    const LatencyHistogram& getServiceTimeHistogram() const { return service_cycles_; }
+    const LatencyHistogram& getBlockResidencyHistogram() const { return block_residency_cycles_; }
+    const LatencyHistogram& getWarpStallHistogram() const { return warp_stall_cycles_; }
     WorkloadMetrics getFastestWorkload() const;
     WorkloadMetrics getSlowestWorkload() const;
 
     // Reporting
     void printSummary() const;
     void printDetailedReport() const;
-    void exportToCSV(const std::string& filename) const;
+    bool exportToCSV(const std::string& filename) const;
+    bool exportToColumnar(const std::string& filename) const; // One row per workload, see columnar.h
+    void printLatencyReport() const;
+    void printStallReport() const;
+    void printEnergyReport() const;
+
+    // Each workload against the compute and bandwidth roofs of the share of
+    // the device it was allocated
+    RooflineModel getRooflineModel() const;
+    std::vector<RooflinePoint> getRooflinePoints() const;
+    void printRooflineReport() const;
+    bool exportRooflineCSV(const std::string& filename) const;
+    bool exportRooflineSVG(const std::string& filename) const;
+    bool exportSimulatorPerformance(const std::string& filename) const;
+
+    // Histogram files combine runs: export from each, then merge into one
+    bool exportHistograms(const std::string& filename) const;
+    bool mergeHistograms(const std::string& filename);
+
+    // Slowdown of each workload against its run in an isolated baseline
+    void printInterferenceReport(const PerformanceAnalyzer& isolated) const;
 
     void reset();
 };
 
+// Nearest-rank percentile (0-100) of a sample set; 0 when empty
+double computePercentile(std::vector<double> samples, double percentile);
+
 // Comparison framework for different scheduling strategies
+// Compares schedulers on replicated runs. Each scheduler holds one analyzer
+// per replica; replica r of every scheduler runs with the same seed, so the
+// schedulers see the same workload draws.
 class SchedulerComparison {
+public:
+    // Builds a device logging to log, runs one replica seeded with seed and
+    // returns its metrics
+    using ReplicaRunner = std::function<std::unique_ptr<PerformanceAnalyzer>(uint64_t seed, std::ostream& log)>;
+
+    struct SchedulerStats {
+        std::string scheduler_name;
+        SampleSummary simulated_time_ms;
+        SampleSummary host_time_ms;
+    };
+
 private:
-    std::map<std::string, std::unique_ptr<PerformanceAnalyzer>> analyzer_map_;
+    struct Replica {
+        uint64_t seed;
+        std::unique_ptr<PerformanceAnalyzer> analyzer;
+    };
+
+    std::map<std::string, std::vector<Replica>> replica_map_;
+
+    double meanOf(const std::vector<Replica>& replicas,
+                  const std::function<double(const PerformanceAnalyzer&)>& field) const;
 
 public:
-    void addAnalyzer(const std::string& scheduler_name, std::unique_ptr<PerformanceAnalyzer> analyzer);
+    // Adds one replica
+    void addAnalyzer(const std::string& scheduler_name, std::unique_ptr<PerformanceAnalyzer> analyzer,
+                     uint64_t seed = 0);
+
+    // Runs replicas with seeds base_seed, base_seed + 1, ... on up to
+    // max_parallel host threads (0: one per hardware thread). Each running
+    // replica adds a device's worth of host threads. Replica logs are
+    // printed in seed order once all finish; returns false if any replica
+    // threw or returned no metrics, and keeps the rest.
+    bool runReplicas(const std::string& scheduler_name, const ReplicaRunner& runner, size_t replicas,
+                     uint64_t base_seed = 42, size_t max_parallel = 0);
+
+    std::vector<SchedulerStats> getStatistics() const;
 
     void printComparison() const;
-    void exportComparisonCSV(const std::string& filename) const;
+    bool exportComparisonCSV(const std::string& filename) const; // One row per replica
 
-    std::string getBestScheduler() const; // Based on total execution time
+    // Fastest by mean simulated time, or "None" unless it beats every other
+    // scheduler by a Welch t-test at the 5% level
+    std::string getBestScheduler() const;
 };
 
 } // namespace GPUSim
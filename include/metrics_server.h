@@ -0,0 +1,50 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include "types.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace GPUSim {
+
+class GPUDevice;
+
+// Serves a device's live metrics over HTTP in the Prometheus text exposition
+// format, for watching long runs. Listens on the loopback interface only.
+// Each scrape renders GPUDevice::getLiveMetrics(), which is lock-free, so
+// scraping never blocks the simulation.
+class MetricsServer {
+private:
+    const GPUDevice& device_;
+    uint16_t port_;
+    std::intptr_t listen_socket_; // Platform socket handle, -1 when closed
+    std::thread server_thread_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> requests_served_;
+
+    void serverThread();
+    void handleConnection(std::intptr_t client);
+
+public:
+    explicit MetricsServer(const GPUDevice& device, uint16_t port = 9464); // 0 picks a free port
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    bool start();
+    void stop();
+    bool isRunning() const { return running_.load(); }
+
+    uint16_t getPort() const { return port_; } // The bound port once started
+    uint64_t getRequestsServed() const { return requests_served_.load(); }
+
+    // The body served at /metrics
+    std::string renderMetrics() const;
+};
+
+} // namespace GPUSim
+
+#endif // METRICS_SERVER_H
@@ -0,0 +1,95 @@
+#ifndef OCCUPANCY_H
+#define OCCUPANCY_H
+
+#include "types.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace GPUSim {
+
+class Workload;
+
+// A compute unit's occupancy at one point on its clock
+struct OccupancySample {
+    uint64_t cycle;
+    uint16_t active_blocks;
+    uint16_t active_warps;
+    uint32_t instructions; // Issued since the previous sample
+};
+
+static_assert(sizeof(OccupancySample) == 16, "OccupancySample must stay 16 bytes");
+
+// Fixed-capacity ring of one compute unit's samples. Written by that CU's
+// thread only and read once the device stops; when full, the oldest
+// samples are overwritten so the ring always holds the latest window.
+class OccupancyRing {
+private:
+    std::vector<OccupancySample> buffer_;
+    uint64_t head_; // Samples ever pushed
+
+public:
+    explicit OccupancyRing(size_t capacity);
+
+    void push(const OccupancySample& sample) {
+        buffer_[head_ % buffer_.size()] = sample;
+        head_++;
+    }
+
+    size_t size() const { return head_ < buffer_.size() ? head_ : buffer_.size(); }
+    uint64_t getOverwrittenCount() const { return head_ - size(); }
+    std::vector<OccupancySample> getSamples() const; // Oldest first
+};
+
+// Occupancy of one workload over its run, from the samples of the compute
+// units it ran on. A co-runner's blocks on the same units count too.
+struct WorkloadOccupancy {
+    std::string workload_name;
+    uint64_t start_cycle;
+    uint64_t end_cycle;
+    size_t total_blocks;
+    uint32_t peak_resident_blocks;  // Most blocks resident at once
+    double average_resident_blocks;
+    double waves;                   // Blocks over peak residency; a fraction means a partial wave
+    uint64_t ramp_cycles;           // Launch until residency first reaches 90% of peak
+    double tail_fraction;           // Share of the run after residency last fell below 50% of peak
+};
+
+// Samples every compute unit's active blocks, active warps and issue rate
+// every interval_cycles of its clock. Idle units take no samples.
+class OccupancySampler {
+private:
+    struct WorkloadSpan {
+        std::string name;
+        uint64_t start_cycle;
+        uint64_t end_cycle;
+        size_t total_blocks;
+        std::vector<uint32_t> compute_units;
+    };
+
+    std::vector<std::unique_ptr<OccupancyRing>> rings_;
+    uint64_t interval_cycles_;
+    std::vector<WorkloadSpan> workloads_; // Appended by the distributor thread
+
+public:
+    OccupancySampler(size_t num_compute_units, uint64_t interval_cycles = 1000,
+                     size_t ring_capacity = 16 * 1024);
+
+    OccupancyRing* getRing(size_t compute_unit);
+    size_t getNumRings() const { return rings_.size(); }
+    uint64_t getInterval() const { return interval_cycles_; }
+
+    // The device reports each completed workload and the units it ran on
+    void recordWorkload(const Workload& workload, const std::vector<uint32_t>& compute_units);
+
+    // Read once the device stops
+    std::vector<WorkloadOccupancy> summarize() const;
+    void printSummary() const;
+    // CSV, one row per sample. Issue_Rate is blank on the oldest sample of a
+    // ring that has wrapped, whose interval start was overwritten.
+    bool exportTimeline(const std::string& filename) const;
+};
+
+} // namespace GPUSim
+
+#endif // OCCUPANCY_H
@@ -0,0 +1,70 @@
+#ifndef PREDICTOR_H
+#define PREDICTOR_H
+
+#include "types.h"
+#include "workload.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace GPUSim {
+
+// Learns per-block runtime, in simulated cycles, from completed workloads.
+// Observations are grouped by (workload type, shape bucket) and each group
+// keeps an exponentially weighted least-squares fit of block cycles against
+// estimated instructions per block, so recent runs dominate and the model
+// tracks drift. Host load does not enter into it.
+class RuntimePredictor {
+private:
+    // Workload type, log2(total blocks), log2(threads per block)
+    using ModelKey = std::tuple<int, int, int>;
+
+    struct Model {
+        double mean_x;   // Estimated instructions per block
+        double mean_y;   // Observed cycles per block on one CU
+        double cov_xy;
+        double var_x;
+        size_t samples;
+    };
+
+    std::map<ModelKey, Model> models_;
+    double decay_; // Weight given to each new observation
+    mutable std::mutex mutex_;
+
+    // Prediction error of completed workloads (absolute, in percent)
+    double total_error_pct_;
+    double recent_error_pct_;
+    size_t error_samples_;
+
+    static ModelKey makeKey(const Workload& workload);
+    static double instructionsPerBlock(const Workload& workload);
+    const Model* findModel(const ModelKey& key) const;
+
+public:
+    explicit RuntimePredictor(double decay = 0.3);
+
+    // Predicted cycles for one block on one CU, or a negative value when no
+    // model of this workload type has been trained yet
+    double predictBlockTime(const Workload& workload) const;
+
+    // Learn from a completed workload and score the prediction made at launch
+    void observe(const Workload& workload);
+
+    double getMeanAbsoluteErrorPct() const;
+    double getRecentAbsoluteErrorPct() const; // Exponentially weighted
+    size_t getObservationCount() const;
+    size_t getModelCount() const;
+
+    // Persistence. load() rejects a file without the model header or with
+    // another version, and keeps the current models if it fails.
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+
+    void printSummary() const;
+    void reset();
+};
+
+} // namespace GPUSim
+
+#endif // PREDICTOR_H
@@ -0,0 +1,139 @@
+#ifndef RECORD_SINK_H
+#define RECORD_SINK_H
+
+#include "types.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace GPUSim {
+
+// One retired thread block. Strings are views valid for the call only.
+struct BlockRecord {
+    uint64_t workload_id;
+    std::string_view workload_name;
+    uint32_t block_id;
+    uint32_t compute_unit;
+    uint64_t start_cycle;
+    uint64_t end_cycle;
+    uint64_t instructions;
+    uint64_t cycles;
+    uint64_t memory_ops;
+};
+
+// One completed kernel launch
+struct KernelRecord {
+    uint64_t workload_id;
+    std::string_view workload_name;
+    WorkloadType type;
+    uint64_t submit_cycle;
+    uint64_t start_cycle;
+    uint64_t end_cycle;
+    double simulated_time_ns;
+    uint64_t instructions;
+    uint64_t memory_ops;
+    uint64_t blocks;
+    uint64_t compute_units;
+    double host_time_ms;
+    std::string_view co_runner;
+};
+
+// Receives records as the device retires them, on the distributor thread.
+// Implementations must not block for long: the simulation waits on them.
+class RecordSink {
+public:
+    virtual ~RecordSink() = default;
+
+    virtual void writeBlock(const BlockRecord& record) = 0;
+    virtual void writeKernel(const KernelRecord& record) = 0;
+
+    // Makes what was written so far available; the device calls it
+    // periodically while running and once when it stops
+    virtual void flush() {}
+};
+
+enum class RecordFormat {
+    JSONL, // One object per line with a "kind" field
+    CSV    // One header, the union of block and kernel columns
+};
+
+enum class RecordCompression {
+    NONE,
+    LZ // LZ4-style blocks, see decompressRecordFile()
+};
+
+// Formats records into a batch buffer and hands full batches to a
+// background thread. Two buffers alternate: one fills while the other is
+// written, and a producer that fills its buffer first waits, so memory
+// stays at two batches however long the run.
+//
+// Compressed files start with "GPUSIMLZ" followed by one frame per batch:
+// uint32 raw size, uint32 stored size, then the stored bytes, which are
+// the raw batch when the sizes are equal.
+class StreamingRecordSink : public RecordSink {
+private:
+    std::string path_;
+    RecordFormat format_;
+    RecordCompression compression_;
+    size_t batch_bytes_;
+    std::FILE* file_;
+
+    // Producer side
+    std::string front_;
+    uint64_t block_records_;
+    uint64_t kernel_records_;
+
+    // Handoff to the writer thread
+    std::mutex batch_mutex_;
+    std::condition_variable batch_cv_;
+    std::string back_;
+    bool back_pending_;
+    bool closing_;
+    std::thread writer_;
+
+    // Writer thread side
+    std::vector<uint8_t> compressed_;
+    std::atomic<uint64_t> raw_bytes_;
+    std::atomic<uint64_t> file_bytes_;
+    bool write_failed_;
+
+    void submitBatch();
+    void writerThread();
+    void writeBatch(const std::string& batch);
+    void writeBytes(const void* data, size_t size);
+
+public:
+    StreamingRecordSink(const std::string& path, RecordFormat format,
+                        RecordCompression compression = RecordCompression::NONE,
+                        size_t batch_bytes = 256 * 1024);
+    ~StreamingRecordSink() override;
+
+    StreamingRecordSink(const StreamingRecordSink&) = delete;
+    StreamingRecordSink& operator=(const StreamingRecordSink&) = delete;
+
+    bool open();
+    bool close(); // Writes the last batch; false on I/O error
+    bool isOpen() const { return file_ != nullptr; }
+
+    void writeBlock(const BlockRecord& record) override;
+    void writeKernel(const KernelRecord& record) override;
+    void flush() override;
+
+    uint64_t getBlockRecords() const { return block_records_; }
+    uint64_t getKernelRecords() const { return kernel_records_; }
+    uint64_t getRawBytes() const { return raw_bytes_.load(); }   // Formatted, before compression
+    uint64_t getFileBytes() const { return file_bytes_.load(); } // Written to the file
+    void printSummary() const;
+};
+
+// Expands a compressed record file into the plain JSONL or CSV it holds
+bool decompressRecordFile(const std::string& input_path, const std::string& output_path);
+
+} // namespace GPUSim
+
+#endif // RECORD_SINK_H
@@ -0,0 +1,47 @@
+#ifndef ROOFLINE_H
+#define ROOFLINE_H
+
+#include "types.h"
+#include <string>
+#include <vector>
+
+namespace GPUSim {
+
+// Bytes each lane moves per memory instruction (one 32-bit word)
+constexpr size_t kBytesPerLaneAccess = 4;
+
+// Floating-point operations a lane does per arithmetic instruction of a
+// workload type: the multiply-add kernels count two, the rest one
+int flopsPerLane(WorkloadType type);
+
+// A workload placed on the device's roofline
+struct RooflinePoint {
+    std::string workload_name;
+    double intensity;              // FLOP per byte of memory traffic
+    double achieved_gflops;
+    double achieved_bandwidth_gbs;
+    double attainable_gflops;      // The roof at this intensity
+    double roof_pct;               // Achieved over attainable
+    bool memory_bound;             // Left of the ridge point; no memory traffic is compute-bound
+};
+
+// Peak compute and bandwidth; the roof is min(peak, intensity x bandwidth)
+struct RooflineModel {
+    double peak_gflops;
+    double peak_bandwidth_gbs;
+
+    double ridgeIntensity() const { return peak_bandwidth_gbs > 0 ? peak_gflops / peak_bandwidth_gbs : 0.0; }
+    double attainableGflops(double intensity) const;
+
+    // The roofs available to a workload holding `share` of the compute units
+    RooflineModel scaled(double share) const { return RooflineModel{peak_gflops * share, peak_bandwidth_gbs * share}; }
+    RooflinePoint place(const std::string& name, uint64_t flops, uint64_t bytes, double time_ns) const;
+};
+
+// Log-log roofline chart, one labelled marker per point, no external assets
+bool writeRooflineSVG(const std::string& filename, const RooflineModel& model,
+                      const std::vector<RooflinePoint>& points, const std::string& title);
+
+} // namespace GPUSim
+
+#endif // ROOFLINE_H
@@ -4,6 +4,7 @@
 #include "types.h"
 #include "workload.h"
 #include "compute_unit.h"
+#include "predictor.h"
 #include <queue>
 #include <vector>
 #include <mutex>
@@ -15,22 +16,49 @@ namespace GPUSim {
 // Base scheduler interface
 class Scheduler {
 protected:
-    std::mutex scheduler_mutex_;
+    mutable std::mutex scheduler_mutex_;
     std::vector<std::shared_ptr<Workload>> pending_workloads_;
     std::vector<std::shared_ptr<Workload>> running_workloads_;
     std::vector<std::shared_ptr<Workload>> completed_workloads_;
 
+    // Hardware availability and simulated clock as last reported by the device
+    size_t free_compute_units_;
+    size_t total_compute_units_;
+    uint64_t current_cycle_;
+
+    // Learned runtime model shared across schedulers and runs (optional)
+    std::shared_ptr<RuntimePredictor> predictor_;
+
 public:
+    Scheduler() : free_compute_units_(0), total_compute_units_(0), current_cycle_(0) {}
     virtual ~Scheduler() = default;
 
     virtual void addWorkload(std::shared_ptr<Workload> workload);
     virtual std::shared_ptr<Workload> getNextWorkload() = 0;
     virtual const char* getName() const = 0;
 
+    // Schedulers that return true may be handed a partially busy device and
+    // get a subset of the compute units per workload; the rest own the whole device
+    virtual bool supportsConcurrentWorkloads() const { return false; }
+    void updateComputeUnitAvailability(size_t free_units, size_t total_units, uint64_t current_cycle);
+
+    // Optional second workload to run on the same compute units as one just
+    // returned by getNextWorkload()
+    virtual std::shared_ptr<Workload> getCompanionWorkload(const Workload& primary);
+
+    // Runtime prediction in simulated cycles. Uses the learned predictor when
+    // it knows the workload type and falls back to the static instruction estimate
+    void setRuntimePredictor(std::shared_ptr<RuntimePredictor> predictor) { predictor_ = predictor; }
+    RuntimePredictor* getRuntimePredictor() const { return predictor_.get(); }
+
+    virtual size_t getComputeUnitDemand(const Workload& workload) const;
+    virtual double predictBlockTime(const Workload& workload) const;
+    double predictRuntime(const Workload& workload, size_t compute_units) const;
+
     bool hasPendingWorkloads() const;
-    size_t getPendingCount() const { return pending_workloads_.size(); }
-    size_t getRunningCount() const { return running_workloads_.size(); }
-    size_t getCompletedCount() const { return completed_workloads_.size(); }
+    size_t getPendingCount() const;
+    size_t getRunningCount() const;
+    size_t getCompletedCount() const;
 
     void markWorkloadRunning(std::shared_ptr<Workload> workload);
     void markWorkloadCompleted(std::shared_ptr<Workload> workload);
@@ -73,10 +101,54 @@ public:
     const char* getName() const override { return "Shortest-Job-First"; }
 };
 
+// EASY backfilling: the head of the queue holds a reservation for the compute
+// units it needs, and later workloads may jump ahead only if they fit in the
+// currently free units and are predicted to finish before that reservation
+// starts (or only use units the head job will not need)
+class BackfillScheduler : public Scheduler {
+private:
+    struct Reservation {
+        std::shared_ptr<Workload> workload;
+        size_t compute_units;
+        double predicted_end; // Simulated cycle
+    };
+
+    std::vector<Reservation> running_reservations_;
+
+    std::shared_ptr<Workload> launch(size_t index, size_t compute_units);
+
+public:
+    std::shared_ptr<Workload> getNextWorkload() override;
+    const char* getName() const override { return "Backfill"; }
+
+    bool supportsConcurrentWorkloads() const override { return true; }
+};
+
+// Co-scheduler: classifies workloads by arithmetic intensity and runs a
+// compute-bound kernel together with a memory-bound one on the same CUs
+class CoScheduler : public Scheduler {
+private:
+    double intensity_threshold_; // Instructions per memory op above which a kernel is compute-bound
+
+public:
+    explicit CoScheduler(double intensity_threshold = 1.0)
+        : intensity_threshold_(intensity_threshold) {}
+
+    std::shared_ptr<Workload> getNextWorkload() override;
+    std::shared_ptr<Workload> getCompanionWorkload(const Workload& primary) override;
+    const char* getName() const override { return "Co-Schedule"; }
+
+    bool isComputeBound(const Workload& workload) const;
+};
+
 // Factory for creating schedulers
 class SchedulerFactory {
 public:
     static std::unique_ptr<Scheduler> createScheduler(SchedulingAlgorithm algorithm);
+
+    // Command-line names: fifo, priority, round-robin, sjf, backfill, co-schedule
+    static bool parseAlgorithm(const std::string& name, SchedulingAlgorithm& algorithm);
+    static const char* algorithmName(SchedulingAlgorithm algorithm);
 };
 
 } // namespace GPUSim
@@ -0,0 +1,38 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include "types.h"
+#include <vector>
+
+namespace GPUSim {
+
+// Mean, sample standard deviation and two-sided 95% confidence interval of
+// the mean, from Student's t with n - 1 degrees of freedom
+struct SampleSummary {
+    size_t count;
+    double mean;
+    double stddev;
+    double ci95_low;
+    double ci95_high;
+
+    double ci95HalfWidth() const { return (ci95_high - ci95_low) / 2.0; }
+};
+
+SampleSummary summarizeSamples(const std::vector<double>& samples);
+
+// Two-sided 5% critical value of Student's t; fractional degrees of
+// freedom are interpolated
+double studentT95(double degrees_of_freedom);
+
+// Welch's unequal-variance t-test of mean(a) != mean(b)
+struct WelchTest {
+    double t;
+    double degrees_of_freedom;
+    bool significant; // At the 5% level
+};
+
+WelchTest welchTest(const SampleSummary& a, const SampleSummary& b);
+
+} // namespace GPUSim
+
+#endif // STATISTICS_H
@@ -0,0 +1,87 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "types.h"
+#include "gpu_device.h"
+#include "workload.h"
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace GPUSim {
+
+// A named set of workloads for a sweep; build() returns fresh workloads on
+// every call, drawn from the seed where the mix is random
+struct WorkloadMix {
+    std::string name; // No commas; it is part of the results key
+    std::function<std::vector<std::shared_ptr<Workload>>(uint64_t seed)> build;
+};
+
+// Values to sweep. Every combination is one run on a device built from
+// base with the swept fields replaced; empty lists take base's value.
+struct SweepGrid {
+    GPUConfig base;
+    std::vector<size_t> compute_units;
+    std::vector<size_t> warps_per_cu;
+    std::vector<size_t> max_blocks_per_cu;
+    std::vector<size_t> memory_latency;
+    std::vector<SchedulingAlgorithm> schedulers; // Empty: FIFO
+    std::vector<WorkloadMix> mixes;
+    std::vector<uint64_t> seeds;                 // Empty: 42
+};
+
+struct SweepPoint {
+    GPUConfig config;
+    SchedulingAlgorithm scheduler;
+    size_t mix; // Index into SweepGrid::mixes
+    uint64_t seed;
+};
+
+// Runs every point of a grid on a pool of host threads and appends one row
+// per run to a CSV results table. Each worker keeps its device and resets
+// it for the next point when the device fields match, so points are
+// ordered device-major. Memory stays bounded by the worker count: runs keep
+// no per-workload metrics and rows go straight to disk. Rerunning against
+// an existing table skips the points it already holds, so an interrupted
+// sweep resumes where it stopped; failed points are retried.
+class ParameterSweep {
+private:
+    SweepGrid grid_;
+    std::string results_path_;
+    size_t max_parallel_;
+
+    std::mutex results_mutex_;
+    std::ofstream results_;
+    std::atomic<size_t> runs_completed_;
+    std::atomic<size_t> runs_failed_;
+    std::atomic<size_t> devices_created_;
+    std::atomic<size_t> devices_reused_;
+    size_t runs_skipped_;
+
+    std::string pointKey(const SweepPoint& point) const;
+    bool loadCompletedKeys(std::set<std::string>& keys); // Rewrites the table without failed or partial rows
+    void runPoint(const SweepPoint& point, std::unique_ptr<GPUDevice>& device, std::ostream& log);
+
+public:
+    // max_parallel 0: hardware threads / (largest CU count + 1), at least one
+    ParameterSweep(const SweepGrid& grid, const std::string& results_path, size_t max_parallel = 0);
+
+    std::vector<SweepPoint> getPoints() const; // Device-major order
+
+    bool run(); // False if the results table cannot be used or a run failed
+    void printSummary() const;
+
+    size_t getRunsCompleted() const { return runs_completed_.load(); }
+    size_t getRunsFailed() const { return runs_failed_.load(); }
+    size_t getRunsSkipped() const { return runs_skipped_; }
+};
+
+} // namespace GPUSim
+
+#endif // SWEEP_H
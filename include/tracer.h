@@ -0,0 +1,93 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include "types.h"
+#include "warp.h"
+#include "workload.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace GPUSim {
+
+struct TraceConfig {
+    std::string output_path;
+    size_t block_sample_interval; // Trace every Nth block of each kernel
+    bool trace_warp_stalls;       // Memory stall spans of the sampled blocks' warps
+    size_t warp_sample_interval;  // Of those, trace every Nth warp
+    size_t max_events;            // Block and warp events past this are dropped
+
+    TraceConfig()
+        : output_path("gpu_trace.json"),
+          block_sample_interval(1),
+          trace_warp_stalls(false),
+          warp_sample_interval(8),
+          max_events(1000000) {}
+};
+
+// Records kernel, block and warp stall spans on the simulated cycle clock and
+// writes them as Chrome Trace Event JSON (chrome://tracing, ui.perfetto.dev).
+// Kernel spans are always kept; blocks are sampled by index so large grids
+// stay loadable, and a hard event cap bounds the trace size.
+class TimelineTracer {
+private:
+    enum class EventKind : uint8_t { BLOCK, WARP_STALL };
+
+    struct Event {
+        EventKind kind;
+        CoreID compute_unit;
+        uint64_t workload_id;
+        BlockID block_id;
+        WarpID warp_id;
+        uint64_t start_cycle;
+        uint64_t cycles;
+    };
+
+    struct KernelSpan {
+        uint64_t workload_id;
+        std::string name;
+        uint64_t start_cycle;
+        uint64_t cycles;
+        size_t blocks;
+        size_t compute_units;
+    };
+
+    TraceConfig config_;
+    mutable std::mutex mutex_;
+    std::vector<KernelSpan> kernels_;
+    std::vector<Event> events_;
+    std::map<uint64_t, std::string> kernel_names_;
+    size_t dropped_events_;
+
+    void addEvent(const Event& event);
+
+public:
+    explicit TimelineTracer(const TraceConfig& config = TraceConfig());
+
+    const TraceConfig& getConfig() const { return config_; }
+
+    bool isSampled(const ThreadBlock& block) const {
+        return config_.block_sample_interval <= 1 ||
+               block.getBlockID() % config_.block_sample_interval == 0;
+    }
+
+    // Called by the device as blocks and kernels retire
+    void recordKernel(const Workload& workload);
+    void recordBlock(const ThreadBlock& block, CoreID compute_unit);
+
+    // Called from compute unit threads
+    void recordWarpStall(CoreID compute_unit, const ThreadBlock& block, const Warp& warp,
+                         uint64_t start_cycle, uint64_t cycles);
+
+    size_t getEventCount() const;
+    size_t getDroppedEventCount() const;
+
+    bool write() const { return write(config_.output_path); }
+    bool write(const std::string& filename) const;
+    void clear();
+};
+
+} // namespace GPUSim
+
+#endif // TRACER_H
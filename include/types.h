@@ -1,6 +1,7 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -23,6 +24,7 @@ constexpr size_t MAX_BLOCKS_PER_GRID = 65535;
 
 // Memory sizes (in bytes)
 constexpr size_t GLOBAL_MEMORY_SIZE = 8ULL * 1024 * 1024 * 1024; // 8GB
+constexpr size_t GLOBAL_MEMORY_LATENCY = 400; // Cycles
 constexpr size_t SHARED_MEMORY_PER_BLOCK = 48 * 1024; // 48KB
 constexpr size_t REGISTERS_PER_THREAD = 255;
 
@@ -40,7 +42,9 @@ enum class SchedulingAlgorithm {
     FIFO,
     PRIORITY,
     ROUND_ROBIN,
-    SHORTEST_JOB_FIRST
+    SHORTEST_JOB_FIRST,
+    BACKFILL,
+    CO_SCHEDULING
 };
 
 // Thread/Warp states
@@ -52,6 +56,47 @@ enum class ExecutionState {
     COMPLETED
 };
 
+// Why a warp did not issue in a cycle, as a hardware profiler reports it
+enum class StallReason {
+    MEMORY_DEPENDENCY,    // Waiting on its own global memory access
+    EXECUTION_DEPENDENCY, // Waiting on pipeline latency of its previous issue
+    BARRIER,              // Finished, waiting for the rest of its block
+    STRUCTURAL,           // Eligible, but the CU pipeline was blocked
+    INSTRUCTION_FETCH,    // Waiting for its first instructions after launch
+    NOT_SELECTED,         // Eligible, another warp was picked
+    IDLE,                 // No warp resident on the CU (per CU only)
+    COUNT
+};
+
+constexpr size_t NUM_STALL_REASONS = static_cast<size_t>(StallReason::COUNT);
+
+// Cycles per stall reason
+using StallBreakdown = std::array<uint64_t, NUM_STALL_REASONS>;
+
+inline const char* workloadTypeName(WorkloadType type) {
+    switch (type) {
+        case WorkloadType::MATRIX_MULTIPLY: return "matrix_multiply";
+        case WorkloadType::CONVOLUTION: return "convolution";
+        case WorkloadType::VECTOR_ADD: return "vector_add";
+        case WorkloadType::REDUCTION: return "reduction";
+        case WorkloadType::CUSTOM: return "custom";
+        default: return "unknown";
+    }
+}
+
+inline const char* stallReasonName(StallReason reason) {
+    switch (reason) {
+        case StallReason::MEMORY_DEPENDENCY: return "Memory Dependency";
+        case StallReason::EXECUTION_DEPENDENCY: return "Execution Dependency";
+        case StallReason::BARRIER: return "Barrier";
+        case StallReason::STRUCTURAL: return "Structural";
+        case StallReason::INSTRUCTION_FETCH: return "Instruction Fetch";
+        case StallReason::NOT_SELECTED: return "Not Selected";
+        case StallReason::IDLE: return "Idle";
+        default: return "Unknown";
+    }
+}
+
 } // namespace GPUSim
 
 #endif // TYPES_H
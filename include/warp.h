@@ -9,6 +9,8 @@
 
 namespace GPUSim {
 
+class ThreadBlock;
+
 // Represents a single GPU thread
 class Thread {
 private:
@@ -35,6 +37,7 @@ class Warp {
 private:
     WarpID warp_id_;
     BlockID block_id_;
+    ThreadBlock* block_; // Owning block, for per-block accounting
     std::vector<std::unique_ptr<Thread>> threads_;
     ExecutionState state_;
     size_t program_counter_;
@@ -42,6 +45,13 @@ private:
     std::atomic<uint64_t> instructions_executed_;
     std::atomic<uint64_t> cycles_stalled_;
 
+    // Lazy stall accounting: the cycles since the warp last issued are
+    // attributed in one step when it issues again (or when its block ends)
+    StallBreakdown stall_cycles_;
+    uint64_t last_accounted_cycle_;
+    uint64_t blocked_snapshot_; // CU's blocked-cycle counter at that point
+    bool has_issued_;
+
 public:
     Warp(WarpID wid, BlockID bid, size_t num_threads = WARP_SIZE);
 
@@ -50,6 +60,9 @@ public:
     ExecutionState getState() const { return state_; }
     void setState(ExecutionState state) { state_ = state; }
 
+    ThreadBlock* getBlock() const { return block_; }
+    void setBlock(ThreadBlock* block) { block_ = block; }
+
     size_t getNumThreads() const { return threads_.size(); }
     size_t getActiveMask() const { return active_mask_; }
     void setActiveMask(size_t mask) { active_mask_ = mask; }
@@ -63,6 +76,23 @@ public:
     uint64_t getInstructionsExecuted() const { return instructions_executed_.load(); }
     uint64_t getCyclesStalled() const { return cycles_stalled_.load(); }
 
+    void addStallCycles(StallReason reason, uint64_t cycles) {
+        stall_cycles_[static_cast<size_t>(reason)] += cycles;
+    }
+    uint64_t getStallCycles(StallReason reason) const {
+        return stall_cycles_[static_cast<size_t>(reason)];
+    }
+
+    uint64_t getLastAccountedCycle() const { return last_accounted_cycle_; }
+    uint64_t getBlockedSnapshot() const { return blocked_snapshot_; }
+    void markAccounted(uint64_t cycle, uint64_t blocked_cycles) {
+        last_accounted_cycle_ = cycle;
+        blocked_snapshot_ = blocked_cycles;
+    }
+
+    bool hasIssued() const { return has_issued_; }
+    void markIssued() { has_issued_ = true; }
+
     const std::vector<std::unique_ptr<Thread>>& getThreads() const { return threads_; }
 };
 
@@ -74,8 +104,21 @@ private:
     std::shared_ptr<SharedMemory> shared_memory_;
     ExecutionState state_;
     size_t grid_x_, grid_y_, grid_z_; // Position in grid
+    uint64_t workload_id_; // Owning workload
     std::atomic<bool> completed_;
 
+    // Work done on behalf of this block. Only the CU running the block
+    // writes these; they are read once the block has completed.
+    uint64_t instructions_executed_;
+    uint64_t cycles_executed_;
+    uint64_t memory_ops_;
+
+    // Residency on the CU's cycle clock
+    uint64_t start_cycle_;
+    uint64_t end_cycle_;
+    bool issued_; // Set by the CU thread when the first warp issues
+    StallBreakdown stall_cycles_; // Summed from the warps when the block ends
+
 public:
     ThreadBlock(BlockID bid, size_t num_threads);
 
@@ -93,8 +136,37 @@ public:
         grid_x_ = x; grid_y_ = y; grid_z_ = z;
     }
 
+    uint64_t getWorkloadID() const { return workload_id_; }
+    void setWorkloadID(uint64_t id) { workload_id_ = id; }
+
     bool isCompleted() const { return completed_.load(); }
     void markCompleted() { completed_.store(true); }
+
+    void recordExecution(uint64_t instructions, uint64_t cycles, uint64_t memory_ops) {
+        instructions_executed_ += instructions;
+        cycles_executed_ += cycles;
+        memory_ops_ += memory_ops;
+    }
+
+    uint64_t getInstructionsExecuted() const { return instructions_executed_; }
+    uint64_t getCyclesExecuted() const { return cycles_executed_; }
+    uint64_t getMemoryOps() const { return memory_ops_; }
+
+    uint64_t getStartCycle() const { return start_cycle_; }
+    uint64_t getEndCycle() const { return end_cycle_; }
+    void setStartCycle(uint64_t cycle) { start_cycle_ = cycle; }
+    void setEndCycle(uint64_t cycle) { end_cycle_ = cycle; }
+
+    // True on the block's first issue only
+    bool markFirstIssue() {
+        bool first = !issued_;
+        issued_ = true;
+        return first;
+    }
+
+    // Close the warps' stall accounting at the block's end cycle and sum it
+    void finalizeStallCycles();
+    const StallBreakdown& getStallCycles() const { return stall_cycles_; }
 };
 
 } // namespace GPUSim
@@ -3,6 +3,7 @@
 
 #include "types.h"
 #include "warp.h"
+#include "energy.h"
 #include <string>
 #include <functional>
 #include <vector>
@@ -38,27 +39,58 @@ struct KernelConfig {
     }
 };
 
+// floor(log2(value)), 0 for 0 and 1; buckets grid and block sizes into
+// shape classes
+inline int log2Bucket(size_t value) {
+    int bucket = 0;
+    while (value > 1) {
+        value >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
 // Workload represents a GPU kernel/task
 class Workload {
 private:
+    uint64_t id_; // Unique per process, tags the workload's thread blocks
     std::string name_;
     WorkloadType type_;
     KernelConfig config_;
     int priority_;
     size_t estimated_instructions_;
     size_t estimated_memory_ops_;
+    InstructionMix instruction_mix_; // For the energy model, defaults by type
 
     // Execution tracking
+    std::chrono::high_resolution_clock::time_point submit_time_;
     std::chrono::high_resolution_clock::time_point start_time_;
     std::chrono::high_resolution_clock::time_point end_time_;
     bool completed_;
-
-    // Thread blocks for this workload
-    std::vector<std::unique_ptr<ThreadBlock>> thread_blocks_;
+    size_t allocated_compute_units_;
+    double predicted_cycles_; // Scheduler's runtime prediction at launch, simulated
+    std::string co_runner_;       // Workload sharing the same compute units
+
+    // Thread blocks are built on demand as the grid is dispatched, so a
+    // queued workload costs no more host memory than its descriptor
+    size_t grid_blocks_;      // Blocks in the generated grid
+    size_t next_block_index_; // Next block to hand out
+
+    // Counters of this workload's retired blocks
+    uint64_t instructions_executed_;
+    uint64_t cycles_executed_;
+    uint64_t memory_ops_executed_;
+    StallBreakdown stall_cycles_;
+
+    // Span on the device's simulated cycle clock
+    uint64_t submit_cycle_;
+    uint64_t start_cycle_;
+    uint64_t end_cycle_;
 
 public:
     Workload(const std::string& name, WorkloadType type, const KernelConfig& config);
 
+    uint64_t getID() const { return id_; }
     const std::string& getName() const { return name_; }
     WorkloadType getType() const { return type_; }
     const KernelConfig& getConfig() const { return config_; }
@@ -72,23 +104,67 @@ public:
     size_t getEstimatedMemoryOps() const { return estimated_memory_ops_; }
     void setEstimatedMemoryOps(size_t count) { estimated_memory_ops_ = count; }
 
+    const InstructionMix& getInstructionMix() const { return instruction_mix_; }
+    void setInstructionMix(const InstructionMix& mix) { instruction_mix_ = mix; }
+
+    // Estimated instructions per memory operation
+    double getArithmeticIntensity() const;
+
     // Block management
     void generateThreadBlocks();
     std::unique_ptr<ThreadBlock> getNextBlock();
     bool hasMoreBlocks() const;
-    size_t getRemainingBlocks() const { return thread_blocks_.size(); }
+    size_t getRemainingBlocks() const { return grid_blocks_ - next_block_index_; }
+
+    // Host memory the workload's thread blocks take once materialized
+    size_t getBlockFootprintBytes() const;
+    size_t getFootprintBytes() const { return config_.getTotalBlocks() * getBlockFootprintBytes(); }
 
     // Execution tracking
+    void markSubmitted();
     void start();
     void complete();
     bool isCompleted() const { return completed_; }
     double getExecutionTime() const; // in milliseconds
+    double getQueueWaitTime() const; // submit to start, in milliseconds
+
+    // Per-workload counters, aggregated from blocks as they retire
+    void recordRetiredBlock(const ThreadBlock& block);
+    uint64_t getInstructionsExecuted() const { return instructions_executed_; }
+    uint64_t getCyclesExecuted() const { return cycles_executed_; }
+    uint64_t getMemoryOpsExecuted() const { return memory_ops_executed_; }
+    const StallBreakdown& getStallCycles() const { return stall_cycles_; }
+
+    // Launch cycle, widened to cover every retired block
+    void setStartCycle(uint64_t cycle) { start_cycle_ = cycle; end_cycle_ = cycle; }
+    uint64_t getStartCycle() const { return start_cycle_; }
+    uint64_t getEndCycle() const { return end_cycle_; }
+    uint64_t getExecutionCycles() const { return end_cycle_ - start_cycle_; }
+    void setSubmitCycle(uint64_t cycle) { submit_cycle_ = cycle; }
+    uint64_t getSubmitCycle() const { return submit_cycle_; }
+    uint64_t getQueueWaitCycles() const { return start_cycle_ > submit_cycle_ ? start_cycle_ - submit_cycle_ : 0; }
+
+    size_t getAllocatedComputeUnits() const { return allocated_compute_units_; }
+    void setAllocatedComputeUnits(size_t count) { allocated_compute_units_ = count; }
+
+    double getPredictedCycles() const { return predicted_cycles_; }
+    void setPredictedCycles(double cycles) { predicted_cycles_ = cycles; }
+
+    const std::string& getCoRunner() const { return co_runner_; }
+    void setCoRunner(const std::string& name) { co_runner_ = name; }
 
     // Create common workload types
     static std::unique_ptr<Workload> createMatrixMultiply(size_t M, size_t N, size_t K);
     static std::unique_ptr<Workload> createConvolution(size_t batch, size_t channels, size_t height, size_t width);
     static std::unique_ptr<Workload> createVectorAdd(size_t size);
     static std::unique_ptr<Workload> createReduction(size_t size);
+
+    // Reads one workload per line, "<type> <sizes...> [priority=P]", with
+    // types and sizes as in the factories above:
+    //   matrix_multiply M N K | convolution BATCH CHANNELS HEIGHT WIDTH
+    //   vector_add N | reduction N
+    // Blank lines and '#' comments are skipped. Reports the first bad line.
+    static bool loadFromFile(const std::string& filename, std::vector<std::shared_ptr<Workload>>& workloads);
 };
 
 } // namespace GPUSim
@@ -1,8 +1,20 @@
 #include "compute_unit.h"
+#include "tracer.h"
 #include <algorithm>
 
 namespace GPUSim {
 
+// Cycles after an issue before a dependent instruction can issue, and before
+// a newly launched warp has its first instructions
+static constexpr uint64_t kPipelineLatency = 4;
+static constexpr uint64_t kInstructionFetchLatency = 8;
+
+// Host timing granularity: simulated cycles per execution timer, and one
+// memory access timed in this many (prime, so it does not alias with the
+// fixed access pattern of a warp issue)
+static constexpr size_t kCyclesPerExecutionTimer = 64;
+static constexpr uint64_t kMemoryTimerSampling = 61;
+
 // WarpScheduler implementation
 WarpScheduler::WarpScheduler(size_t max_warps)
     : max_warps_(max_warps) {
@@ -40,19 +52,31 @@ size_t WarpScheduler::getQueueSize() const {
 }
 
 // ComputeUnit implementation
-ComputeUnit::ComputeUnit(CoreID id, std::shared_ptr<MemoryController> mem_ctrl)
+ComputeUnit::ComputeUnit(CoreID id, std::shared_ptr<MemoryController> mem_ctrl,
+                         size_t max_warps, size_t max_blocks)
     : core_id_(id),
-      warp_scheduler_(64),
-      max_warps_per_cu_(64),
-      max_threads_per_cu_(2048),
-      max_blocks_per_cu_(16),
+      warp_scheduler_(max_warps),
+      max_warps_per_cu_(max_warps),
+      max_threads_per_cu_(max_warps * WARP_SIZE),
+      max_blocks_per_cu_(max_blocks),
       state_(ExecutionState::IDLE),
       running_(false),
       cycles_executed_(0),
       instructions_executed_(0),
       warps_executed_(0),
       idle_cycles_(0),
-      memory_controller_(mem_ctrl) {
+      cycles_stalled_(0),
+      blocked_cycles_(0),
+      stall_breakdown_{},
+      memory_timer_tick_(0),
+      occupancy_ring_(nullptr),
+      occupancy_interval_(0),
+      next_sample_cycle_(0),
+      sampled_instructions_(0),
+      last_simulated_cycle_(0),
+      memory_controller_(mem_ctrl),
+      tracer_(nullptr),
+      event_ring_(nullptr) {
 }
 
 bool ComputeUnit::canAcceptBlock(const ThreadBlock* block) const {
@@ -81,28 +105,34 @@ bool ComputeUnit::assignBlock(std::unique_ptr<ThreadBlock> block) {
 
     // Add all warps from the block to the scheduler
     for (const auto& warp : block->getWarps()) {
+        warp->markAccounted(cycles_executed_.load(), blocked_cycles_.load());
         warp_scheduler_.addWarp(warp.get());
     }
 
+    block->setStartCycle(cycles_executed_.load());
     active_blocks_.push_back(std::move(block));
     state_ = ExecutionState::RUNNING;
     return true;
 }
 
-void ComputeUnit::removeCompletedBlocks() {
+std::vector<std::unique_ptr<ThreadBlock>> ComputeUnit::removeCompletedBlocks() {
     std::lock_guard<std::mutex> lock(cu_mutex_);
 
-    active_blocks_.erase(
-        std::remove_if(active_blocks_.begin(), active_blocks_.end(),
-            [](const std::unique_ptr<ThreadBlock>& block) {
-                return block->isCompleted();
-            }),
-        active_blocks_.end()
-    );
+    auto first_completed = std::stable_partition(active_blocks_.begin(), active_blocks_.end(),
+        [](const std::unique_ptr<ThreadBlock>& block) {
+            return !block->isCompleted();
+        });
+
+    std::vector<std::unique_ptr<ThreadBlock>> retired(
+        std::make_move_iterator(first_completed),
+        std::make_move_iterator(active_blocks_.end()));
+    active_blocks_.erase(first_completed, active_blocks_.end());
 
     if (active_blocks_.empty()) {
         state_ = ExecutionState::IDLE;
     }
+
+    return retired;
 }
 
 void ComputeUnit::executeWarp(Warp* warp, size_t num_instructions) {
@@ -110,6 +140,10 @@ void ComputeUnit::executeWarp(Warp* warp, size_t num_instructions) {
 
     warp->setState(ExecutionState::RUNNING);
 
+    // Issue cycle plus any stall cycles, charged to the warp's block
+    uint64_t cycles = 1;
+    uint64_t memory_ops = 0;
+
     for (size_t i = 0; i < num_instructions; ++i) {
         warp->recordInstruction();
         warp->incrementPC();
@@ -117,7 +151,11 @@ void ComputeUnit::executeWarp(Warp* warp, size_t num_instructions) {
 
         // Simulate occasional memory accesses (20% of instructions)
         if (i % 5 == 0) {
+            SampledPhaseTimer memory_timer(phase_times_, SimPhase::MEMORY_MODEL,
+                                           memory_timer_tick_++ % kMemoryTimerSampling == 0,
+                                           kMemoryTimerSampling);
             memory_controller_->recordMemoryOp();
+            memory_ops++;
 
             // Simulate memory stalls (10% chance)
             if (i % 10 == 0) {
@@ -126,32 +164,105 @@ void ComputeUnit::executeWarp(Warp* warp, size_t num_instructions) {
                 cycles_stalled_++;
 
                 // Simulate stall duration
-                for (size_t s = 0; s < memory_controller_->getGlobalMemory()->getLatency() / 10; ++s) {
+                [[maybe_unused]] uint64_t stall_start = cycles_executed_.load();
+                size_t stall_cycles = memory_controller_->getGlobalMemory()->getLatency() / 10;
+                for (size_t s = 0; s < stall_cycles; ++s) {
                     cycles_executed_++;
+                    cycles++;
                 }
+                stall_histogram_.record(stall_cycles);
+
+                // The stall is in-line, so it blocks every other warp too
+                blocked_cycles_ += stall_cycles;
+                warp->addStallCycles(StallReason::MEMORY_DEPENDENCY, stall_cycles);
+
+#ifdef GPUSIM_ENABLE_TRACING
+                if (warp->getBlock()) {
+                    GPUSIM_TRACE_EVENT(event_ring_, TraceEventType::WARP_STALL, stall_start,
+                                       warp->getBlockID(), warp->getWarpID(),
+                                       warp->getBlock()->getWorkloadID());
+                    if (tracer_) {
+                        tracer_->recordWarpStall(core_id_, *warp->getBlock(), *warp, stall_start, stall_cycles);
+                    }
+                }
+#endif
 
                 warp->setState(ExecutionState::RUNNING);
             }
         }
     }
 
+    if (ThreadBlock* block = warp->getBlock()) {
+        block->recordExecution(num_instructions, cycles, memory_ops);
+    }
+    warp->markAccounted(cycles_executed_.load(), blocked_cycles_.load());
+
     warp->setState(ExecutionState::READY);
     warps_executed_++;
 }
 
+void ComputeUnit::accountWarpWait(Warp* warp) {
+    // Cycles before this one since the warp last issued
+    uint64_t issue_cycle = cycles_executed_.load() - 1;
+    uint64_t last = warp->getLastAccountedCycle();
+
+    if (issue_cycle > last) {
+        uint64_t gap = issue_cycle - last;
+        uint64_t structural = std::min(gap, blocked_cycles_.load() - warp->getBlockedSnapshot());
+        uint64_t remaining = gap - structural;
+
+        // The first cycles of a wait are the warp's own latency, the rest it
+        // was eligible but lost arbitration
+        StallReason startup = warp->hasIssued() ? StallReason::EXECUTION_DEPENDENCY
+                                                : StallReason::INSTRUCTION_FETCH;
+        uint64_t latency = warp->hasIssued() ? kPipelineLatency : kInstructionFetchLatency;
+        uint64_t dependent = std::min(remaining, latency);
+
+        warp->addStallCycles(StallReason::STRUCTURAL, structural);
+        warp->addStallCycles(startup, dependent);
+        warp->addStallCycles(StallReason::NOT_SELECTED, remaining - dependent);
+    }
+
+    warp->markIssued();
+}
+
 void ComputeUnit::simulateCycle() {
-    cycles_executed_++;
+    uint64_t cycle = ++cycles_executed_;
+    if (occupancy_ring_) {
+        // syncClock moves an empty CU's clock forward from the distributor;
+        // the buckets it skipped before this one were idle
+        uint64_t bucket_start = cycle / occupancy_interval_ * occupancy_interval_;
+        if (cycle > last_simulated_cycle_ + 1 && bucket_start > 0) {
+            sampleOccupancy(bucket_start - 1, true);
+        }
+        sampleOccupancy(cycle);
+    }
 
     // Try to fetch and execute a warp
     Warp* warp = warp_scheduler_.getNextWarp();
 
     if (warp) {
+        accountWarpWait(warp);
+
+#ifdef GPUSIM_ENABLE_TRACING
+        // The event ring has a single producer, this thread, so the block's
+        // start is traced on its first issue rather than in assignBlock
+        ThreadBlock* block = warp->getBlock();
+        if (block && block->markFirstIssue()) {
+            GPUSIM_TRACE_EVENT(event_ring_, TraceEventType::BLOCK_START, block->getStartCycle(),
+                               block->getBlockID(), 0, block->getWorkloadID());
+        }
+#endif
+
         // Execute one instruction batch (simulate SIMD execution)
         executeWarp(warp, 8); // Execute 8 instructions per cycle
 
         // Check if warp is completed (simplified: after certain instructions)
         if (warp->getInstructionsExecuted() >= 1000) {
             warp->setState(ExecutionState::COMPLETED);
+            GPUSIM_TRACE_EVENT(event_ring_, TraceEventType::WARP_DONE, cycles_executed_.load(),
+                               warp->getBlockID(), warp->getWarpID(),
+                               warp->getBlock() ? warp->getBlock()->getWorkloadID() : 0);
 
             // Check if all warps in the block are completed (with mutex protection)
             std::lock_guard<std::mutex> lock(cu_mutex_);
@@ -163,7 +274,14 @@ void ComputeUnit::simulateCycle() {
                         break;
                     }
                 }
-                if (all_warps_done) {
+                if (all_warps_done && !block->isCompleted()) {
+                    block->setEndCycle(cycles_executed_.load());
+                    block->finalizeStallCycles();
+                    for (size_t r = 0; r < NUM_STALL_REASONS; ++r) {
+                        stall_breakdown_[r] += block->getStallCycles()[r];
+                    }
+                    GPUSIM_TRACE_EVENT(event_ring_, TraceEventType::BLOCK_END, block->getEndCycle(),
+                                       block->getBlockID(), 0, block->getWorkloadID());
                     block->markCompleted();
                 }
             }
@@ -174,13 +292,69 @@ void ComputeUnit::simulateCycle() {
     } else {
         idle_cycles_++;
     }
+
+    // Memory stalls advance the clock in one step with the blocks resident
+    if (occupancy_ring_) {
+        last_simulated_cycle_ = cycles_executed_.load();
+        sampleOccupancy(last_simulated_cycle_);
+    }
 }
 
-void ComputeUnit::run() {
+void ComputeUnit::setOccupancyRing(OccupancyRing* ring, uint64_t interval_cycles) {
+    occupancy_ring_ = ring;
+    occupancy_interval_ = std::max<uint64_t>(1, interval_cycles);
+    // Sample from the current bucket on, not from cycle 0
+    last_simulated_cycle_ = cycles_executed_.load();
+    next_sample_cycle_ = last_simulated_cycle_ / occupancy_interval_ * occupancy_interval_;
+    sampled_instructions_ = instructions_executed_.load();
+}
+
+void ComputeUnit::sampleOccupancy(uint64_t cycle, bool idle) {
+    if (cycle < next_sample_cycle_) return;
+
+    // Blocks finished but not yet retired no longer occupy the CU
+    size_t blocks = 0;
+    size_t warps = 0;
+    if (!idle) {
+        std::lock_guard<std::mutex> lock(cu_mutex_);
+        for (const auto& block : active_blocks_) {
+            if (block->isCompleted()) continue;
+            blocks++;
+            warps += block->getNumWarps();
+        }
+    }
+
+    // Instructions since the previous sample go to the first boundary
+    uint64_t instructions = instructions_executed_.load();
+    for (uint64_t boundary = next_sample_cycle_; boundary <= cycle; boundary += occupancy_interval_) {
+        occupancy_ring_->push(OccupancySample{boundary, static_cast<uint16_t>(blocks), static_cast<uint16_t>(warps),
+                                              static_cast<uint32_t>(instructions - sampled_instructions_)});
+        sampled_instructions_ = instructions;
+    }
+    next_sample_cycle_ = (cycle / occupancy_interval_ + 1) * occupancy_interval_;
+}
+
+void ComputeUnit::start() {
     running_.store(true);
+}
+
+void ComputeUnit::syncClock(uint64_t cycle) {
+    uint64_t now = cycles_executed_.load();
+    if (cycle > now) {
+        idle_cycles_ += cycle - now;
+        cycles_executed_.store(cycle);
+    }
+}
+
+void ComputeUnit::run() {
     while (running_.load()) {
         if (!active_blocks_.empty() && warp_scheduler_.hasReadyWarps()) {
-            simulateCycle();
+            // One timer per batch keeps clock reads off the per-cycle path
+            ScopedPhaseTimer timer(phase_times_, SimPhase::EXECUTION);
+            for (size_t i = 0; i < kCyclesPerExecutionTimer; ++i) {
+                simulateCycle();
+                if (active_blocks_.empty() || !warp_scheduler_.hasReadyWarps()) break;
+            }
         } else {
             // Sleep briefly if no work
             std::this_thread::sleep_for(std::chrono::microseconds(100));
@@ -192,6 +366,12 @@ void ComputeUnit::stop() {
     running_.store(false);
 }
 
+StallBreakdown ComputeUnit::getStallBreakdown() const {
+    StallBreakdown breakdown = stall_breakdown_;
+    breakdown[static_cast<size_t>(StallReason::IDLE)] += idle_cycles_.load();
+    return breakdown;
+}
+
 size_t ComputeUnit::getActiveWarpCount() const {
     size_t count = 0;
     for (const auto& block : active_blocks_) {
@@ -223,6 +403,15 @@ void ComputeUnit::resetMetrics() {
     instructions_executed_ = 0;
     warps_executed_ = 0;
     idle_cycles_ = 0;
+    cycles_stalled_ = 0;
+    stall_histogram_.reset();
+    blocked_cycles_ = 0;
+    stall_breakdown_.fill(0);
+    phase_times_.reset();
+    memory_timer_tick_ = 0;
+    next_sample_cycle_ = 0;
+    sampled_instructions_ = 0;
+    last_simulated_cycle_ = 0;
 }
 
 } // namespace GPUSim
@@ -1,34 +1,124 @@
 #include "gpu_device.h"
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <algorithm>
+#include <stdexcept>
 
 namespace GPUSim {
 
-GPUDevice::GPUDevice(const GPUConfig& config)
+// How often the distributor refreshes the live metrics
+static constexpr std::chrono::milliseconds kLivePublishInterval(100);
+
+bool GPUConfig::fromPreset(const std::string& name, GPUConfig& config) {
+    if (name == "rtx3080") {
+        config = rtx3080();
+    } else if (name == "a100") {
+        config = a100();
+    } else if (name == "h100") {
+        config = h100();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+GPUConfig GPUConfig::a100() {
+    GPUConfig config;
+    config.num_compute_units = 108;
+    config.warps_per_cu = 64;
+    config.max_blocks_per_cu = 32;
+    config.global_memory_size = 40ULL * 1024 * 1024 * 1024;
+    config.device_name = "GPU Simulator - A100 Profile";
+    config.core_clock_mhz = 1410.0;
+    config.fp32_flops_per_cu_cycle = 128.0; // 64 FP32 lanes per SM
+    config.memory_bandwidth_gbs = 1555.0;
+
+    // 7 nm, HBM2
+    config.energy.alu_pj = 1.0;
+    config.energy.fma_pj = 2.0;
+    config.energy.mma_pj = 3.0;
+    config.energy.register_file_pj = 0.8;
+    config.energy.shared_memory_pj = 4.0;
+    config.energy.l1_pj = 6.0;
+    config.energy.l2_pj = 15.0;
+    config.energy.dram_pj_per_byte = 31.0;
+    config.energy.leakage_w_per_cu = 0.75;
+    return config;
+}
+
+GPUConfig GPUConfig::h100() {
+    GPUConfig config;
+    config.num_compute_units = 132;
+    config.warps_per_cu = 64;
+    config.max_blocks_per_cu = 32;
+    config.global_memory_size = 80ULL * 1024 * 1024 * 1024;
+    config.device_name = "GPU Simulator - H100 Profile";
+    config.core_clock_mhz = 1980.0;
+    config.fp32_flops_per_cu_cycle = 256.0; // 128 FP32 lanes per SM
+    config.memory_bandwidth_gbs = 3350.0;
+
+    // 4 nm, HBM3
+    config.energy.alu_pj = 0.8;
+    config.energy.fma_pj = 1.6;
+    config.energy.mma_pj = 2.4;
+    config.energy.register_file_pj = 0.7;
+    config.energy.shared_memory_pj = 3.5;
+    config.energy.l1_pj = 5.0;
+    config.energy.l2_pj = 12.0;
+    config.energy.dram_pj_per_byte = 28.0;
+    config.energy.leakage_w_per_cu = 1.0;
+    return config;
+}
+
+GPUDevice::GPUDevice(const GPUConfig& config, std::ostream& log)
     : config_(config),
-      memory_controller_(std::make_shared<MemoryController>()),
+      log_(&log),
+      memory_controller_(std::make_shared<MemoryController>(config.global_memory_latency)),
       scheduler_(std::make_unique<FIFOScheduler>()),
       running_(false),
       simulation_active_(false),
       performance_analyzer_(std::make_unique<PerformanceAnalyzer>()),
-      global_cycle_count_(0) {
+      global_cycle_count_(0),
+      live_metrics_(config.num_compute_units),
+      last_live_instructions_(0),
+      pending_workloads_(0),
+      pending_blocks_(0),
+      pending_memory_bytes_(0),
+      workloads_admitted_(0),
+      workloads_rejected_(0),
+      total_admission_wait_ms_(0.0),
+      max_admission_wait_ms_(0.0) {
 
     initializeComputeUnits();
 }
 
 GPUDevice::~GPUDevice() {
     stop();
+
+    // Anyone still holding a future learns the work will never finish
+    std::lock_guard<std::mutex> lock(completion_mutex_);
+    for (auto& [id, completion] : pending_completions_) {
+        completion.promise.set_exception(std::make_exception_ptr(
+            std::runtime_error("GPU device destroyed before workload completed")));
+    }
+    pending_completions_.clear();
 }
 
 void GPUDevice::initializeComputeUnits() {
     compute_units_.reserve(config_.num_compute_units);
 
     for (size_t i = 0; i < config_.num_compute_units; ++i) {
-        compute_units_.push_back(std::make_unique<ComputeUnit>(i, memory_controller_));
+        compute_units_.push_back(std::make_unique<ComputeUnit>(i, memory_controller_, config_.warps_per_cu,
+                                                               config_.max_blocks_per_cu));
     }
 
-    std::cout << "Initialized " << config_.num_compute_units << " compute units\n";
+    logStatus("Initialized " + std::to_string(config_.num_compute_units) + " compute units");
+}
+
+void GPUDevice::logStatus(const std::string& line) {
+    std::lock_guard<std::mutex> lock(log_mutex_);
+    *log_ << line << "\n";
 }
 
 void GPUDevice::setScheduler(std::unique_ptr<Scheduler> scheduler) {
@@ -36,87 +126,617 @@ void GPUDevice::setScheduler(std::unique_ptr<Scheduler> scheduler) {
     scheduler_ = std::move(scheduler);
 }
 
-void GPUDevice::submitWorkload(std::shared_ptr<Workload> workload) {
-    if (!workload) return;
+bool GPUDevice::fitsComputeUnit(const Workload& workload) const {
+    // Otherwise no compute unit would ever accept one of its blocks
+    size_t warps = (workload.getConfig().getThreadsPerBlock() + WARP_SIZE - 1) / WARP_SIZE;
+    return warps <= config_.warps_per_cu;
+}
 
-    // Generate thread blocks for the workload
-    workload->generateThreadBlocks();
+bool GPUDevice::fitsAdmissionLimits(const Workload& workload) const {
+    // An empty queue admits anything, otherwise one oversized workload
+    // could never get in
+    if (pending_workloads_ == 0) return true;
+
+    const auto& limits = config_.admission;
+    if (limits.max_pending_workloads > 0 &&
+        pending_workloads_ + 1 > limits.max_pending_workloads) {
+        return false;
+    }
+    if (limits.max_pending_blocks > 0 &&
+        pending_blocks_ + workload.getConfig().getTotalBlocks() > limits.max_pending_blocks) {
+        return false;
+    }
+    if (limits.max_pending_memory_bytes > 0 &&
+        pending_memory_bytes_ + workload.getFootprintBytes() > limits.max_pending_memory_bytes) {
+        return false;
+    }
+    return true;
+}
+
+void GPUDevice::reserveAdmission(const Workload& workload, double wait_ms) {
+    pending_workloads_++;
+    pending_blocks_ += workload.getConfig().getTotalBlocks();
+    pending_memory_bytes_ += workload.getFootprintBytes();
+    workloads_admitted_++;
+    total_admission_wait_ms_ += wait_ms;
+    max_admission_wait_ms_ = std::max(max_admission_wait_ms_, wait_ms);
+}
+
+void GPUDevice::admitWorkload(std::shared_ptr<Workload> workload) {
+    workload->markSubmitted();
+    workload->setSubmitCycle(global_cycle_count_.load());
 
     // Add to scheduler
     scheduler_->addWorkload(workload);
 
-    std::cout << "Submitted workload: " << workload->getName()
-              << " (" << workload->getConfig().getTotalBlocks() << " blocks, "
-              << workload->getConfig().getTotalThreads() << " threads)\n";
+    std::ostringstream line;
+    line << "Submitted workload: " << workload->getName()
+         << " (" << workload->getConfig().getTotalBlocks() << " blocks, "
+         << workload->getConfig().getTotalThreads() << " threads)";
+    logStatus(line.str());
 }
 
-void GPUDevice::distributorThread() {
-    while (running_.load()) {
-        // Check if there are pending workloads
-        if (!scheduler_->hasPendingWorkloads()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            continue;
+void GPUDevice::rejectWorkload(const Workload& workload, const char* reason) {
+    workloads_rejected_++;
+    logStatus("Rejected workload: " + workload.getName() + " (" + reason + ")");
+}
+
+void GPUDevice::releaseAdmission(const Workload& workload) {
+    {
+        std::lock_guard<std::mutex> lock(admission_mutex_);
+        pending_workloads_--;
+        pending_blocks_ -= workload.getConfig().getTotalBlocks();
+        pending_memory_bytes_ -= workload.getFootprintBytes();
+    }
+    admission_cv_.notify_all();
+}
+
+bool GPUDevice::submitWorkload(std::shared_ptr<Workload> workload) {
+    if (!workload) return false;
+
+    auto arrival = std::chrono::steady_clock::now();
+    {
+        std::unique_lock<std::mutex> lock(admission_mutex_);
+
+        if (!fitsComputeUnit(*workload)) {
+            rejectWorkload(*workload, "thread block has more warps than a compute unit holds");
+            return false;
+        }
+
+        // Only a running device drains the queue, so only then is waiting useful
+        admission_cv_.wait(lock, [this, &workload]() {
+            return fitsAdmissionLimits(*workload) || !running_.load();
+        });
+
+        if (!fitsAdmissionLimits(*workload)) {
+            rejectWorkload(*workload, "admission limits exceeded while device is stopped");
+            return false;
+        }
+
+        double wait_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - arrival).count();
+        reserveAdmission(*workload, wait_ms);
+    }
+
+    admitWorkload(workload);
+    return true;
+}
+
+bool GPUDevice::trySubmitWorkload(std::shared_ptr<Workload> workload) {
+    if (!workload) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(admission_mutex_);
+        if (!fitsComputeUnit(*workload)) {
+            rejectWorkload(*workload, "thread block has more warps than a compute unit holds");
+            return false;
+        }
+        if (!fitsAdmissionLimits(*workload)) {
+            rejectWorkload(*workload, "admission limits exceeded");
+            return false;
+        }
+        reserveAdmission(*workload, 0.0);
+    }
+
+    admitWorkload(workload);
+    return true;
+}
+
+std::future<WorkloadMetrics> GPUDevice::submitAsync(std::shared_ptr<Workload> workload,
+                                                    CompletionCallback on_complete) {
+    std::promise<WorkloadMetrics> promise;
+    auto future = promise.get_future();
+
+    if (!workload) {
+        promise.set_exception(std::make_exception_ptr(
+            std::invalid_argument("submitAsync called with a null workload")));
+        return future;
+    }
+
+    // Register before submitting so a fast completion cannot be missed
+    uint64_t id = workload->getID();
+    {
+        std::lock_guard<std::mutex> lock(completion_mutex_);
+        pending_completions_[id] = PendingCompletion{std::move(promise), std::move(on_complete)};
+    }
+
+    if (!trySubmitWorkload(workload)) {
+        std::lock_guard<std::mutex> lock(completion_mutex_);
+        auto it = pending_completions_.find(id);
+        it->second.promise.set_exception(std::make_exception_ptr(
+            std::runtime_error("Workload rejected by admission control: " + workload->getName())));
+        pending_completions_.erase(it);
+    }
+
+    return future;
+}
+
+void GPUDevice::resolveCompletion(const Workload& workload, const WorkloadMetrics& metrics) {
+    PendingCompletion completion;
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lock(completion_mutex_);
+        auto it = pending_completions_.find(workload.getID());
+        if (it != pending_completions_.end()) {
+            completion = std::move(it->second);
+            pending_completions_.erase(it);
+            found = true;
+        }
+    }
+
+    if (found) {
+        // Callback first, so whoever waits on the future sees its effects
+        if (completion.callback) {
+            try {
+                completion.callback(metrics);
+            } catch (const std::exception& e) {
+                std::cerr << "Completion callback for " << workload.getName()
+                          << " threw: " << e.what() << "\n";
+            }
         }
+        completion.promise.set_value(metrics);
+    }
+
+    // Wake waitForIdle() after the state change is visible
+    {
+        std::lock_guard<std::mutex> lock(completion_mutex_);
+    }
+    idle_cv_.notify_all();
+}
+
+void GPUDevice::setAdmissionLimits(const AdmissionLimits& limits) {
+    {
+        std::lock_guard<std::mutex> lock(admission_mutex_);
+        config_.admission = limits;
+    }
+    admission_cv_.notify_all();
+}
+
+AdmissionStats GPUDevice::getAdmissionStats() const {
+    std::lock_guard<std::mutex> lock(admission_mutex_);
+
+    AdmissionStats stats;
+    stats.admitted = workloads_admitted_;
+    stats.rejected = workloads_rejected_;
+    stats.average_wait_ms = workloads_admitted_ > 0
+        ? total_admission_wait_ms_ / workloads_admitted_ : 0.0;
+    stats.max_wait_ms = max_admission_wait_ms_;
+    return stats;
+}
+
+size_t GPUDevice::getPendingWorkloadCount() const {
+    std::lock_guard<std::mutex> lock(admission_mutex_);
+    return pending_workloads_;
+}
+
+bool GPUDevice::launchWorkloads(std::vector<ActiveWorkload>& active, std::vector<bool>& allocated) {
+    // setScheduler swaps the scheduler under this lock, and the demand and
+    // availability it reads must come from the same scheduler
+    std::lock_guard<std::mutex> lock(device_mutex_);
+
+    bool launched = false;
+    size_t total_units = compute_units_.size();
+    size_t free_units = std::count(allocated.begin(), allocated.end(), false);
+    bool concurrent = scheduler_->supportsConcurrentWorkloads();
+
+    // Serial schedulers get the whole device for one workload at a time
+    while (scheduler_->hasPendingWorkloads() && free_units > 0 &&
+           (concurrent || active.empty())) {
+        scheduler_->updateComputeUnitAvailability(free_units, total_units, global_cycle_count_.load());
 
-        // Get next workload from scheduler
         auto workload = scheduler_->getNextWorkload();
-        if (!workload) continue;
-
-        std::cout << "Starting workload: " << workload->getName() << "\n";
-        workload->start();
-
-        // Distribute blocks to available compute units
-        while (workload->hasMoreBlocks()) {
-            auto block = workload->getNextBlock();
-            if (!block) break;
-
-            // Find an available compute unit
-            bool assigned = false;
-            while (!assigned && running_.load()) {
-                for (auto& cu : compute_units_) {
-                    if (cu->canAcceptBlock(block.get())) {
-                        cu->assignBlock(std::move(block));
-                        assigned = true;
-                        break;
-                    }
-                }
+        if (!workload) break;
 
-                if (!assigned) {
-                    // Wait a bit and clean up completed blocks
-                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                    for (auto& cu : compute_units_) {
-                        cu->removeCompletedBlocks();
-                    }
-                }
+        size_t width = total_units;
+        if (concurrent) {
+            width = std::min(std::max<size_t>(1, scheduler_->getComputeUnitDemand(*workload)),
+                             free_units);
+        }
+
+        std::vector<ComputeUnit*> reserved;
+        for (size_t i = 0; i < total_units && reserved.size() < width; ++i) {
+            if (!allocated[i]) {
+                allocated[i] = true;
+                reserved.push_back(compute_units_[i].get());
             }
         }
+        free_units -= reserved.size();
+
+        // A companion shares the reserved units with the workload
+        auto companion = scheduler_->getCompanionWorkload(*workload);
+        if (companion) {
+            workload->setCoRunner(companion->getName());
+            companion->setCoRunner(workload->getName());
+        }
+
+        launchOnComputeUnits(active, workload, reserved);
+        if (companion) {
+            launchOnComputeUnits(active, companion, reserved);
+        }
 
-        // Wait for all blocks to complete
-        bool all_idle = false;
-        while (!all_idle && running_.load()) {
-            all_idle = true;
-            for (auto& cu : compute_units_) {
-                cu->removeCompletedBlocks();
-                if (!cu->isIdle()) {
-                    all_idle = false;
+        launched = true;
+    }
+
+    return launched;
+}
+
+void GPUDevice::launchOnComputeUnits(std::vector<ActiveWorkload>& active,
+                                     std::shared_ptr<Workload> workload,
+                                     const std::vector<ComputeUnit*>& compute_units) {
+    std::ostringstream line;
+    line << "Starting workload: " << workload->getName();
+    if (scheduler_->supportsConcurrentWorkloads()) {
+        line << " on " << compute_units.size() << " CUs";
+    }
+    if (!workload->getCoRunner().empty()) {
+        line << " alongside " << workload->getCoRunner();
+    }
+    logStatus(line.str());
+
+    // The workload leaves the admission queue and its grid is built on demand
+    releaseAdmission(*workload);
+    workload->generateThreadBlocks();
+
+    workload->setAllocatedComputeUnits(compute_units.size());
+    workload->setStartCycle(global_cycle_count_.load());
+    workload->setPredictedCycles(scheduler_->predictRuntime(*workload, compute_units.size()));
+    workload->start();
+
+    ActiveWorkload entry;
+    entry.workload = workload;
+    entry.compute_units = compute_units;
+    entry.blocks_retired = 0;
+    active.push_back(std::move(entry));
+}
+
+bool GPUDevice::dispatchBlocks(std::vector<ActiveWorkload>& active) {
+    bool dispatched = false;
+
+    // One block per workload per pass so co-runners interleave on shared CUs
+    bool placed = true;
+    while (placed) {
+        placed = false;
+
+        for (auto& entry : active) {
+            if (!entry.next_block) {
+                entry.next_block = entry.workload->getNextBlock();
+                if (!entry.next_block) continue;
+            }
+
+            // The least-loaded compute unit among those reserved for the
+            // workload, so its blocks spread over the whole reservation
+            ComputeUnit* target = nullptr;
+            for (auto* cu : entry.compute_units) {
+                if (!cu->canAcceptBlock(entry.next_block.get())) continue;
+                if (!target || cu->getActiveBlockCount() < target->getActiveBlockCount()) {
+                    target = cu;
                 }
             }
+            if (!target) continue;
 
-            if (!all_idle) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (target->getActiveBlockCount() == 0) {
+                target->syncClock(global_cycle_count_.load());
+            }
+            if (target->assignBlock(std::move(entry.next_block))) {
+                placed = true;
             }
         }
 
+        dispatched |= placed;
+    }
+
+    return dispatched;
+}
+
+bool GPUDevice::retireWorkloads(std::vector<ActiveWorkload>& active, std::vector<bool>& allocated) {
+    bool retired = false;
+
+    for (auto& cu : compute_units_) {
+        for (const auto& block : cu->removeCompletedBlocks()) {
+            for (auto& entry : active) {
+                if (entry.workload->getID() == block->getWorkloadID()) {
+                    entry.workload->recordRetiredBlock(*block);
+                    entry.blocks_retired++;
+                    performance_analyzer_->recordBlockResidency(block->getEndCycle() - block->getStartCycle());
+                    if (tracer_) {
+                        tracer_->recordBlock(*block, cu->getCoreID());
+                    }
+                    if (block_record_writer_) {
+                        recordBlockRow(*entry.workload, *block, cu->getCoreID());
+                    }
+                    if (record_sink_) {
+                        record_sink_->writeBlock(BlockRecord{
+                            entry.workload->getID(), entry.workload->getName(),
+                            static_cast<uint32_t>(block->getBlockID()), static_cast<uint32_t>(cu->getCoreID()),
+                            block->getStartCycle(), block->getEndCycle(), block->getInstructionsExecuted(),
+                            block->getCyclesExecuted(), block->getMemoryOps()});
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    for (auto it = active.begin(); it != active.end();) {
+        bool done = !it->next_block && !it->workload->hasMoreBlocks() &&
+                    it->blocks_retired >= it->workload->getConfig().getTotalBlocks();
+        if (!done) {
+            ++it;
+            continue;
+        }
+
         // Workload completed
+        auto workload = it->workload;
+        auto compute_units = it->compute_units;
+        it = active.erase(it);
+
         workload->complete();
         scheduler_->markWorkloadCompleted(workload);
+        if (tracer_) {
+            tracer_->recordKernel(*workload);
+        }
+        if (occupancy_sampler_) {
+            std::vector<uint32_t> units;
+            for (auto* cu : compute_units) {
+                units.push_back(cu->getCoreID());
+            }
+            occupancy_sampler_->recordWorkload(*workload, units);
+        }
 
-        std::cout << "Completed workload: " << workload->getName()
-                  << " in " << std::fixed << std::setprecision(2)
-                  << workload->getExecutionTime() << " ms\n";
+        std::ostringstream line;
+        line << "Completed workload: " << workload->getName()
+             << " in " << std::fixed << std::setprecision(2)
+             << workload->getExecutionTime() << " ms";
+        logStatus(line.str());
 
         // Record metrics
-        performance_analyzer_->recordWorkloadMetrics(workload.get(), this);
+        WorkloadMetrics metrics = performance_analyzer_->recordWorkloadMetrics(workload.get(), this);
+        if (record_sink_) {
+            record_sink_->writeKernel(KernelRecord{
+                workload->getID(), workload->getName(), workload->getType(),
+                workload->getSubmitCycle(), workload->getStartCycle(), workload->getEndCycle(),
+                metrics.simulated_time_ns, metrics.instructions_executed, metrics.memory_operations,
+                metrics.total_blocks, metrics.compute_units_allocated, metrics.execution_time_ms,
+                metrics.co_runner});
+        }
+
+        // Release units no longer shared with a co-runner
+        for (auto* cu : compute_units) {
+            bool shared = std::any_of(active.begin(), active.end(),
+                [cu](const ActiveWorkload& other) {
+                    return std::find(other.compute_units.begin(), other.compute_units.end(), cu) !=
+                           other.compute_units.end();
+                });
+            if (!shared) {
+                allocated[cu->getCoreID()] = false;
+            }
+        }
+
+        resolveCompletion(*workload, metrics);
+        retired = true;
+    }
+
+    return retired;
+}
+
+void GPUDevice::distributorThread() {
+    std::vector<ActiveWorkload> active;
+    std::vector<bool> allocated(compute_units_.size(), false);
+
+    while (running_.load()) {
+        bool progress = false;
+        {
+            ScopedPhaseTimer timer(distributor_phase_times_, SimPhase::DISPATCH);
+            advanceGlobalClock();
+            progress |= launchWorkloads(active, allocated);
+            progress |= dispatchBlocks(active);
+        }
+        {
+            ScopedPhaseTimer timer(distributor_phase_times_, SimPhase::METRICS);
+            progress |= retireWorkloads(active, allocated);
+            if (std::chrono::steady_clock::now() - last_live_publish_ >= kLivePublishInterval) {
+                publishLiveMetrics();
+                if (record_sink_) {
+                    record_sink_->flush();
+                }
+            }
+        }
+
+        if (!progress) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+void GPUDevice::advanceGlobalClock() {
+    uint64_t furthest = 0;
+    for (const auto& cu : compute_units_) {
+        furthest = std::max(furthest, cu->getCyclesExecuted());
+    }
+    raiseGlobalClock(furthest);
+}
+
+void GPUDevice::raiseGlobalClock(uint64_t cycle) {
+    // advanceIdleClock raises the clock from outside the distributor
+    uint64_t current = global_cycle_count_.load();
+    while (current < cycle && !global_cycle_count_.compare_exchange_weak(current, cycle)) {
+    }
+}
+
+bool GPUDevice::advanceIdleClock(uint64_t cycle) {
+    if (hasOutstandingWork()) return false;
+    raiseGlobalClock(cycle);
+    return true;
+}
+
+void GPUDevice::publishLiveMetrics() {
+    // Only the distributor changes CU block lists, so it may walk them here
+    uint64_t instructions = 0;
+    for (size_t i = 0; i < compute_units_.size(); ++i) {
+        const auto& cu = compute_units_[i];
+        auto& live = live_metrics_.compute_units[i];
+        live.utilization.store(cu->getUtilization(), std::memory_order_relaxed);
+        live.active_blocks.store(cu->getActiveBlockCount(), std::memory_order_relaxed);
+        live.active_warps.store(cu->getActiveWarpCount(), std::memory_order_relaxed);
+        live.cycles.store(cu->getCyclesExecuted(), std::memory_order_relaxed);
+        live.instructions.store(cu->getInstructionsExecuted(), std::memory_order_relaxed);
+        instructions += cu->getInstructionsExecuted();
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    double elapsed_us = std::chrono::duration<double, std::micro>(now - last_live_publish_).count();
+    if (elapsed_us > 0 && instructions >= last_live_instructions_) {
+        live_metrics_.host_mips.store((instructions - last_live_instructions_) / elapsed_us,
+                                      std::memory_order_relaxed);
+    }
+    last_live_publish_ = now;
+    last_live_instructions_ = instructions;
+
+    AdmissionStats admission = getAdmissionStats();
+    live_metrics_.simulated_cycles.store(global_cycle_count_.load(), std::memory_order_relaxed);
+    live_metrics_.instructions.store(instructions, std::memory_order_relaxed);
+    live_metrics_.admission_queue_depth.store(getPendingWorkloadCount(), std::memory_order_relaxed);
+    live_metrics_.scheduler_queue_depth.store(scheduler_->getPendingCount(), std::memory_order_relaxed);
+    live_metrics_.running_workloads.store(scheduler_->getRunningCount(), std::memory_order_relaxed);
+    live_metrics_.completed_workloads.store(scheduler_->getCompletedCount(), std::memory_order_relaxed);
+    live_metrics_.rejected_workloads.store(admission.rejected, std::memory_order_relaxed);
+    live_metrics_.publishes.fetch_add(1, std::memory_order_relaxed);
+}
+
+PhaseTimes GPUDevice::getPhaseTimes() const {
+    PhaseTimes times = distributor_phase_times_;
+    for (const auto& cu : compute_units_) {
+        times.merge(cu->getPhaseTimes());
+    }
+    return times;
+}
+
+std::vector<ColumnSpec> GPUDevice::getBlockRecordSchema() {
+    return {
+        {"workload", ColumnType::DICT},
+        {"workload_id", ColumnType::U64},
+        {"block_id", ColumnType::U32},
+        {"compute_unit", ColumnType::U32},
+        {"start_cycle", ColumnType::U64},
+        {"end_cycle", ColumnType::U64},
+        {"instructions", ColumnType::U64},
+        {"cycles", ColumnType::U64},
+        {"memory_ops", ColumnType::U64}};
+}
+
+void GPUDevice::setBlockRecordWriter(std::shared_ptr<ColumnarWriter> writer) {
+    if (running_.load()) {
+        std::cerr << "Cannot change the block record writer while the GPU is running\n";
+        return;
+    }
+    if (writer) {
+        // recordBlockRow sets columns by index and type
+        const auto& schema = writer->getSchema();
+        const auto expected = getBlockRecordSchema();
+        bool matches = schema.size() == expected.size();
+        for (size_t i = 0; matches && i < schema.size(); ++i) {
+            matches = schema[i].type == expected[i].type;
+        }
+        if (!matches) {
+            std::cerr << "Block record writer does not use the block record schema\n";
+            return;
+        }
+        if (!writer->isOpen()) {
+            std::cerr << "Block record writer is not open\n";
+            return;
+        }
+    }
+
+    block_record_writer_ = writer;
+}
+
+void GPUDevice::setRecordSink(std::shared_ptr<RecordSink> sink) {
+    if (running_.load()) {
+        std::cerr << "Cannot change the record sink while the GPU is running\n";
+        return;
+    }
+
+    record_sink_ = sink;
+}
+
+void GPUDevice::recordBlockRow(const Workload& workload, const ThreadBlock& block, size_t compute_unit) {
+    ColumnarWriter& writer = *block_record_writer_;
+    writer.setString(0, workload.getName());
+    writer.setU64(1, workload.getID());
+    writer.setU32(2, static_cast<uint32_t>(block.getBlockID()));
+    writer.setU32(3, static_cast<uint32_t>(compute_unit));
+    writer.setU64(4, block.getStartCycle());
+    writer.setU64(5, block.getEndCycle());
+    writer.setU64(6, block.getInstructionsExecuted());
+    writer.setU64(7, block.getCyclesExecuted());
+    writer.setU64(8, block.getMemoryOps());
+    writer.endRow();
+}
+
+void GPUDevice::setTracer(std::shared_ptr<TimelineTracer> tracer) {
+    if (running_.load()) {
+        std::cerr << "Cannot change the tracer while the GPU is running\n";
+        return;
+    }
+
+    tracer_ = tracer;
+    for (auto& cu : compute_units_) {
+        cu->setTracer(tracer_.get());
+    }
+}
+
+void GPUDevice::setEventTracer(std::shared_ptr<EventTracer> tracer) {
+    if (running_.load()) {
+        std::cerr << "Cannot change the event tracer while the GPU is running\n";
+        return;
+    }
+    if (tracer && tracer->getNumRings() < compute_units_.size()) {
+        std::cerr << "Event tracer has " << tracer->getNumRings() << " rings for "
+                  << compute_units_.size() << " compute units\n";
+        return;
+    }
+
+    event_tracer_ = tracer;
+    for (auto& cu : compute_units_) {
+        cu->setEventRing(event_tracer_ ? event_tracer_->getRing(cu->getCoreID()) : nullptr);
+    }
+}
+
+void GPUDevice::setOccupancySampler(std::shared_ptr<OccupancySampler> sampler) {
+    if (running_.load()) {
+        std::cerr << "Cannot change the occupancy sampler while the GPU is running\n";
+        return;
+    }
+    if (sampler && sampler->getNumRings() < compute_units_.size()) {
+        std::cerr << "Occupancy sampler has " << sampler->getNumRings() << " rings for "
+                  << compute_units_.size() << " compute units\n";
+        return;
+    }
+
+    occupancy_sampler_ = sampler;
+    for (auto& cu : compute_units_) {
+        cu->setOccupancyRing(occupancy_sampler_ ? occupancy_sampler_->getRing(cu->getCoreID()) : nullptr,
+                             occupancy_sampler_ ? occupancy_sampler_->getInterval() : 0);
     }
 }
 
@@ -134,11 +754,24 @@ void GPUDevice::executeWorkloads() {
     start();
 }
 
+bool GPUDevice::hasOutstandingWork() const {
+    // A workload is always counted by at least one of these: admission holds
+    // it until launch, and the scheduler moves it to running before launch
+    return getPendingWorkloadCount() > 0 ||
+           scheduler_->hasPendingWorkloads() ||
+           scheduler_->getRunningCount() > 0;
+}
+
+void GPUDevice::waitForIdle() {
+    std::unique_lock<std::mutex> lock(completion_mutex_);
+    idle_cv_.wait(lock, [this]() {
+        return !hasOutstandingWork() || !running_.load();
+    });
+}
+
 void GPUDevice::waitForCompletion() {
     // Wait until all workloads are completed
-    while (scheduler_->hasPendingWorkloads() || scheduler_->getRunningCount() > 0) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
+    waitForIdle();
 
     stop();
 }
@@ -151,15 +784,26 @@ void GPUDevice::start() {
 
     performance_analyzer_->startSimulation();
 
+    last_live_publish_ = std::chrono::steady_clock::now();
+    last_live_instructions_ = 0;
+    for (const auto& cu : compute_units_) {
+        last_live_instructions_ += cu->getInstructionsExecuted();
+    }
+
+    if (event_tracer_) {
+        event_tracer_->start();
+    }
+
     // Start compute unit threads
     for (auto& cu : compute_units_) {
+        cu->start();
         cu_threads_.emplace_back(&GPUDevice::cuExecutionThread, this, cu.get());
     }
 
     // Start distributor thread
     cu_threads_.emplace_back(&GPUDevice::distributorThread, this);
 
-    std::cout << "GPU Device started with " << config_.num_compute_units << " compute units\n";
+    logStatus("GPU Device started with " + std::to_string(config_.num_compute_units) + " compute units");
 }
 
 void GPUDevice::stop() {
@@ -167,6 +811,16 @@ void GPUDevice::stop() {
 
     running_.store(false);
 
+    // Blocked submitters and idle waiters give up once nothing drains the queue
+    {
+        std::lock_guard<std::mutex> lock(admission_mutex_);
+    }
+    admission_cv_.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(completion_mutex_);
+    }
+    idle_cv_.notify_all();
+
     // Stop all compute units FIRST
     for (auto& cu : compute_units_) {
         cu->stop();
@@ -180,13 +834,24 @@ void GPUDevice::stop() {
     }
     cu_threads_.clear();
 
+    // Producers are gone, so the final drain sees every record
+    if (event_tracer_) {
+        event_tracer_->stop();
+    }
+
+    // Final values for anyone still scraping
+    publishLiveMetrics();
+    if (record_sink_) {
+        record_sink_->flush();
+    }
+
     if (simulation_active_.load()) {
         performance_analyzer_->endSimulation();
         performance_analyzer_->recordGPUMetrics(this);
         simulation_active_.store(false);
     }
 
-    std::cout << "GPU Device stopped\n";
+    logStatus("GPU Device stopped");
 }
 
 size_t GPUDevice::getTotalActiveBlocks() const {
@@ -225,8 +890,17 @@ void GPUDevice::printDeviceInfo() const {
     std::cout << "Warps per CU: " << config_.warps_per_cu << "\n";
     std::cout << "Threads per Warp: " << config_.threads_per_warp << "\n";
     std::cout << "Max Blocks per CU: " << config_.max_blocks_per_cu << "\n";
-    std::cout << "Global Memory: " << (config_.global_memory_size / (1024*1024*1024)) << " GB\n";
+    std::cout << "Global Memory: " << (config_.global_memory_size / (1024*1024*1024)) << " GB, "
+              << config_.global_memory_latency << " cycles latency\n";
     std::cout << "Shared Memory per Block: " << (config_.shared_memory_per_block / 1024) << " KB\n";
+    std::cout << "Peak Compute: " << std::fixed << std::setprecision(0) << getPeakGflops() << " GFLOP/s\n";
+    std::cout << "Peak Memory Bandwidth: " << getPeakBandwidthGBs() << " GB/s\n";
+    const auto& limits = config_.admission;
+    if (limits.max_pending_workloads || limits.max_pending_blocks || limits.max_pending_memory_bytes) {
+        std::cout << "Admission Limits: " << limits.max_pending_workloads << " workloads, "
+                  << limits.max_pending_blocks << " blocks, "
+                  << (limits.max_pending_memory_bytes / (1024*1024)) << " MB (0 = unlimited)\n";
+    }
     std::cout << "========================================\n\n";
 }
 
@@ -237,10 +911,22 @@ void GPUDevice::reset() {
         cu->resetMetrics();
     }
 
+    memory_controller_->reset();
     performance_analyzer_->reset();
     global_cycle_count_ = 0;
+    distributor_phase_times_.reset();
+    live_metrics_.reset();
+    last_live_instructions_ = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(admission_mutex_);
+        workloads_admitted_ = 0;
+        workloads_rejected_ = 0;
+        total_admission_wait_ms_ = 0.0;
+        max_admission_wait_ms_ = 0.0;
+    }
 
-    std::cout << "GPU Device reset\n";
+    logStatus("GPU Device reset");
 }
 
 } // namespace GPUSim
@@ -17,11 +17,16 @@ Thread::Thread(ThreadID tid, WarpID wid, BlockID bid)
 Warp::Warp(WarpID wid, BlockID bid, size_t num_threads)
     : warp_id_(wid),
       block_id_(bid),
+      block_(nullptr),
       state_(ExecutionState::READY),
       program_counter_(0),
       active_mask_((1ULL << num_threads) - 1), 
       instructions_executed_(0),
-      cycles_stalled_(0) {
+      cycles_stalled_(0),
+      stall_cycles_{},
+      last_accounted_cycle_(0),
+      blocked_snapshot_(0),
+      has_issued_(false) {
 
     threads_.reserve(num_threads);
     for (size_t i = 0; i < num_threads; ++i) {
@@ -36,7 +41,15 @@ ThreadBlock::ThreadBlock(BlockID bid, size_t num_threads)
       shared_memory_(std::make_shared<SharedMemory>()),
       state_(ExecutionState::READY),
       grid_x_(0), grid_y_(0), grid_z_(0),
-      completed_(false) {
+      workload_id_(0),
+      completed_(false),
+      instructions_executed_(0),
+      cycles_executed_(0),
+      memory_ops_(0),
+      start_cycle_(0),
+      end_cycle_(0),
+      issued_(false),
+      stall_cycles_{} {
 
     shared_memory_->setOwner(bid);
 
@@ -47,6 +60,21 @@ ThreadBlock::ThreadBlock(BlockID bid, size_t num_threads)
     for (size_t i = 0; i < num_warps; ++i) {
         size_t threads_in_warp = std::min(WARP_SIZE, num_threads - i * WARP_SIZE);
         warps_.push_back(std::make_unique<Warp>(i, bid, threads_in_warp));
+        warps_.back()->setBlock(this);
+    }
+}
+
+void ThreadBlock::finalizeStallCycles() {
+    stall_cycles_.fill(0);
+    for (auto& warp : warps_) {
+        // Finished warps wait at the block boundary for their siblings
+        if (end_cycle_ > warp->getLastAccountedCycle()) {
+            warp->addStallCycles(StallReason::BARRIER, end_cycle_ - warp->getLastAccountedCycle());
+            warp->markAccounted(end_cycle_, warp->getBlockedSnapshot());
+        }
+        for (size_t r = 0; r < NUM_STALL_REASONS; ++r) {
+            stall_cycles_[r] += warp->getStallCycles(static_cast<StallReason>(r));
+        }
     }
 }
 
@@ -1,51 +1,98 @@
 #include "workload.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
 
 namespace GPUSim {
 
+static std::atomic<uint64_t> next_workload_id{1};
+
 Workload::Workload(const std::string& name, WorkloadType type, const KernelConfig& config)
-    : name_(name),
+    : id_(next_workload_id++),
+      name_(name),
       type_(type),
       config_(config),
       priority_(0),
       estimated_instructions_(0),
       estimated_memory_ops_(0),
-      completed_(false) {
+      instruction_mix_(InstructionMix::forType(type)),
+      completed_(false),
+      allocated_compute_units_(0),
+      predicted_cycles_(0.0),
+      grid_blocks_(0),
+      next_block_index_(0),
+      instructions_executed_(0),
+      cycles_executed_(0),
+      memory_ops_executed_(0),
+      stall_cycles_{},
+      submit_cycle_(0),
+      start_cycle_(0),
+      end_cycle_(0) {
+    submit_time_ = std::chrono::high_resolution_clock::now();
 }
 
 void Workload::generateThreadBlocks() {
-    thread_blocks_.clear();
-    size_t total_blocks = config_.getTotalBlocks();
-
-    for (size_t i = 0; i < total_blocks; ++i) {
-        size_t threads_per_block = config_.getThreadsPerBlock();
-        auto block = std::make_unique<ThreadBlock>(i, threads_per_block);
-
-        // Calculate 3D grid position
-        size_t grid_xy = config_.grid_dim_x * config_.grid_dim_y;
-        size_t z = i / grid_xy;
-        size_t remaining = i % grid_xy;
-        size_t y = remaining / config_.grid_dim_x;
-        size_t x = remaining % config_.grid_dim_x;
-
-        block->setGridPosition(x, y, z);
-        thread_blocks_.push_back(std::move(block));
-    }
+    grid_blocks_ = config_.getTotalBlocks();
+    next_block_index_ = 0;
 }
 
 std::unique_ptr<ThreadBlock> Workload::getNextBlock() {
-    if (thread_blocks_.empty()) {
+    if (next_block_index_ >= grid_blocks_) {
         return nullptr;
     }
 
-    auto block = std::move(thread_blocks_.back());
-    thread_blocks_.pop_back();
+    size_t i = next_block_index_++;
+    auto block = std::make_unique<ThreadBlock>(i, config_.getThreadsPerBlock());
+
+    // Calculate 3D grid position
+    size_t grid_xy = config_.grid_dim_x * config_.grid_dim_y;
+    size_t z = i / grid_xy;
+    size_t remaining = i % grid_xy;
+    size_t y = remaining / config_.grid_dim_x;
+    size_t x = remaining % config_.grid_dim_x;
+
+    block->setGridPosition(x, y, z);
+    block->setWorkloadID(id_);
     return block;
 }
 
 bool Workload::hasMoreBlocks() const {
-    return !thread_blocks_.empty();
+    return next_block_index_ < grid_blocks_;
+}
+
+size_t Workload::getBlockFootprintBytes() const {
+    size_t threads = config_.getThreadsPerBlock();
+    size_t warps = (threads + WARP_SIZE - 1) / WARP_SIZE;
+
+    return sizeof(ThreadBlock) + sizeof(SharedMemory) + SHARED_MEMORY_PER_BLOCK +
+           warps * sizeof(Warp) +
+           threads * (sizeof(Thread) + sizeof(RegisterFile) + REGISTERS_PER_THREAD * sizeof(uint32_t));
+}
+
+double Workload::getArithmeticIntensity() const {
+    if (estimated_memory_ops_ == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return static_cast<double>(estimated_instructions_) / estimated_memory_ops_;
+}
+
+void Workload::recordRetiredBlock(const ThreadBlock& block) {
+    instructions_executed_ += block.getInstructionsExecuted();
+    cycles_executed_ += block.getCyclesExecuted();
+    memory_ops_executed_ += block.getMemoryOps();
+    for (size_t r = 0; r < NUM_STALL_REASONS; ++r) {
+        stall_cycles_[r] += block.getStallCycles()[r];
+    }
+    start_cycle_ = std::min(start_cycle_, block.getStartCycle());
+    end_cycle_ = std::max(end_cycle_, block.getEndCycle());
+}
+
+void Workload::markSubmitted() {
+    submit_time_ = std::chrono::high_resolution_clock::now();
 }
 
 void Workload::start() {
@@ -65,6 +112,14 @@ double Workload::getExecutionTime() const {
     return duration.count() / 1000.0; // Convert to milliseconds
 }
 
+double Workload::getQueueWaitTime() const {
+    if (!completed_) return 0.0;
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        start_time_ - submit_time_);
+    return duration.count() / 1000.0;
+}
+
 // Factory methods for common workloads
 std::unique_ptr<Workload> Workload::createMatrixMultiply(size_t M, size_t N, size_t K) {
 
@@ -146,4 +201,56 @@ std::unique_ptr<Workload> Workload::createReduction(size_t size) {
     return workload;
 }
 
+bool Workload::loadFromFile(const std::string& filename, std::vector<std::shared_ptr<Workload>>& workloads) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << "\n";
+        return false;
+    }
+
+    std::string line;
+    for (size_t line_number = 1; std::getline(file, line); ++line_number) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string type;
+        if (!(fields >> type)) continue;
+
+        std::vector<size_t> sizes;
+        int priority = 0;
+        std::string field;
+        bool ok = true;
+        while (ok && fields >> field) {
+            if (field.rfind("priority=", 0) == 0) {
+                std::istringstream value(field.substr(9));
+                ok = static_cast<bool>(value >> priority);
+            } else {
+                std::istringstream value(field);
+                size_t size = 0;
+                ok = static_cast<bool>(value >> size) && value.eof() && size > 0;
+                sizes.push_back(size);
+            }
+        }
+
+        std::unique_ptr<Workload> workload;
+        if (ok && type == "matrix_multiply" && sizes.size() == 3) {
+            workload = createMatrixMultiply(sizes[0], sizes[1], sizes[2]);
+        } else if (ok && type == "convolution" && sizes.size() == 4) {
+            workload = createConvolution(sizes[0], sizes[1], sizes[2], sizes[3]);
+        } else if (ok && type == "vector_add" && sizes.size() == 1) {
+            workload = createVectorAdd(sizes[0]);
+        } else if (ok && type == "reduction" && sizes.size() == 1) {
+            workload = createReduction(sizes[0]);
+        }
+
+        if (!workload) {
+            std::cerr << filename << ":" << line_number << ": invalid workload: " << line << "\n";
+            return false;
+        }
+        workload->setPriority(priority);
+        workloads.push_back(std::move(workload));
+    }
+
+    return true;
+}
+
 } // namespace GPUSim
@@ -2,13 +2,32 @@
 #include "workload.h"
 #include "scheduler.h"
 #include "metrics.h"
+#include "predictor.h"
+#include "batcher.h"
+#include "load_generator.h"
+#include "metrics_server.h"
+#include "sweep.h"
 #include <iostream>
+#include <iomanip>
 #include <memory>
 #include <vector>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <optional>
+#include <filesystem>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
 
 using namespace GPUSim;
 
-void runBasicSimulation() {
+bool runBasicSimulation() {
     std::cout << "\n==============================================\n";
     std::cout << "  BASIC GPU SIMULATION\n";
     std::cout << "==============================================\n\n";
@@ -30,16 +49,46 @@ void runBasicSimulation() {
     gpu.submitWorkload(std::move(vecadd));
     gpu.submitWorkload(std::move(reduction));
 
+    // Per-block records in the columnar format
+    auto block_writer = std::make_shared<ColumnarWriter>("basic_simulation_blocks.gcol",
+                                                         GPUDevice::getBlockRecordSchema());
+    bool ok = block_writer->open();
+    if (ok) {
+        gpu.setBlockRecordWriter(block_writer);
+    }
+
     // Execute and wait for completion
     gpu.executeWorkloads();
     gpu.waitForCompletion();
+    ok = block_writer->close() && ok;
 
     // Print performance results
-    gpu.getPerformanceAnalyzer()->printDetailedReport();
-    gpu.getPerformanceAnalyzer()->exportToCSV("basic_simulation_results.csv");
+    PerformanceAnalyzer* analyzer = gpu.getPerformanceAnalyzer();
+    analyzer->printDetailedReport();
+    analyzer->printLatencyReport();
+    analyzer->printStallReport();
+    ok = analyzer->exportToCSV("basic_simulation_results.csv") && ok;
+    ok = analyzer->exportSimulatorPerformance("basic_simulation_simperf.csv") && ok;
+    ok = analyzer->exportToColumnar("basic_simulation_results.gcol") && ok;
+
+    // Scan a column of the block records in place
+    ColumnarReader blocks;
+    if (ok && blocks.open("basic_simulation_blocks.gcol")) {
+        int column = blocks.findColumn("instructions");
+        uint64_t total = 0;
+        for (size_t chunk = 0; column >= 0 && chunk < blocks.getNumChunks(); ++chunk) {
+            const uint64_t* values = blocks.getChunkData<uint64_t>(chunk, column);
+            for (uint64_t row = 0; row < blocks.getChunkRows(chunk); ++row) {
+                total += values[row];
+            }
+        }
+        std::cout << "Block records: " << blocks.getNumRows() << " rows in "
+                  << blocks.getNumChunks() << " chunks, " << total << " instructions\n";
+    }
+    return ok && analyzer->getWorkloadCount() == 3;
 }
 
-void runSchedulerComparison() {
+bool runSchedulerComparison(uint64_t seed = 42) {
     std::cout << "\n==============================================\n";
     std::cout << "  SCHEDULER COMPARISON\n";
     std::cout << "==============================================\n\n";
@@ -52,67 +101,82 @@ void runSchedulerComparison() {
         SchedulingAlgorithm::FIFO,
         SchedulingAlgorithm::PRIORITY,
         SchedulingAlgorithm::SHORTEST_JOB_FIRST,
-        SchedulingAlgorithm::ROUND_ROBIN
+        SchedulingAlgorithm::ROUND_ROBIN,
+        SchedulingAlgorithm::BACKFILL,
+        SchedulingAlgorithm::CO_SCHEDULING
     };
 
     const char* algorithm_names[] = {
         "FIFO",
         "Priority",
         "Shortest-Job-First",
-        "Round-Robin"
+        "Round-Robin",
+        "Backfill",
+        "Co-Schedule"
     };
 
+    // Each replica runs a full device, one host thread per CU; a few at a
+    // time keeps the host from being oversubscribed
+    const size_t replicas = 5;
+    const size_t parallel_replicas = std::min<size_t>(4, std::max(1u, std::thread::hardware_concurrency()));
+
+    bool ok = true;
     for (size_t i = 0; i < algorithms.size(); ++i) {
-        std::cout << "\nTesting " << algorithm_names[i] << " scheduler...\n";
+        std::cout << "\nTesting " << algorithm_names[i] << " scheduler (" << replicas << " replicas)...\n";
 
-        GPUConfig config;
-        config.num_compute_units = 16;
-        GPUDevice gpu(config);
+        ok = comparison.runReplicas(algorithm_names[i], [algorithm = algorithms[i]](uint64_t seed, std::ostream& log) {
+            GPUConfig config;
+            config.num_compute_units = 16;
+            GPUDevice gpu(config, log);
 
-        // Set scheduler
-        auto scheduler = SchedulerFactory::createScheduler(algorithms[i]);
-        gpu.setScheduler(std::move(scheduler));
+            // Set scheduler
+            auto scheduler = SchedulerFactory::createScheduler(algorithm);
+            gpu.setScheduler(std::move(scheduler));
 
-        // Create diverse workloads
-        auto small_matmul = Workload::createMatrixMultiply(256, 256, 256);
-        small_matmul->setPriority(3);
+            // Create diverse workloads
+            auto small_matmul = Workload::createMatrixMultiply(256, 256, 256);
+            small_matmul->setPriority(3);
 
-        auto large_matmul = Workload::createMatrixMultiply(1024, 1024, 1024);
-        large_matmul->setPriority(1);
+            auto large_matmul = Workload::createMatrixMultiply(1024, 1024, 1024);
+            large_matmul->setPriority(1);
 
-        auto conv = Workload::createConvolution(4, 64, 224, 224);
-        conv->setPriority(2);
+            auto conv = Workload::createConvolution(4, 64, 224, 224);
+            conv->setPriority(2);
 
-        auto vecadd = Workload::createVectorAdd(2 * 1024 * 1024);
-        vecadd->setPriority(2);
+            auto vecadd = Workload::createVectorAdd(2 * 1024 * 1024);
+            vecadd->setPriority(2);
 
-        auto reduction = Workload::createReduction(1024 * 1024);
-        reduction->setPriority(3);
+            auto reduction = Workload::createReduction(1024 * 1024);
+            reduction->setPriority(3);
 
-        // Submit workloads
-        gpu.submitWorkload(std::move(small_matmul));
-        gpu.submitWorkload(std::move(large_matmul));
-        gpu.submitWorkload(std::move(conv));
-        gpu.submitWorkload(std::move(vecadd));
-        gpu.submitWorkload(std::move(reduction));
+            // The seed draws the arrival order, the same draw for every scheduler
+            std::vector<std::shared_ptr<Workload>> workloads = {
+                std::move(small_matmul), std::move(large_matmul), std::move(conv),
+                std::move(vecadd), std::move(reduction)
+            };
+            std::mt19937_64 rng(seed);
+            std::shuffle(workloads.begin(), workloads.end(), rng);
 
-        // Execute
-        gpu.executeWorkloads();
-        gpu.waitForCompletion();
+            // Submit workloads
+            for (auto& workload : workloads) {
+                gpu.submitWorkload(workload);
+            }
+
+            // Execute
+            gpu.executeWorkloads();
+            gpu.waitForCompletion();
 
-        // Store results
-        auto analyzer = std::make_unique<PerformanceAnalyzer>(
-            *gpu.getPerformanceAnalyzer()
-        );
-        comparison.addAnalyzer(algorithm_names[i], std::move(analyzer));
+            // Store results
+            return std::make_unique<PerformanceAnalyzer>(*gpu.getPerformanceAnalyzer());
+        }, replicas, seed, parallel_replicas) && ok;
     }
 
     // Print comparison
     comparison.printComparison();
-    comparison.exportComparisonCSV("scheduler_comparison.csv");
+    return comparison.exportComparisonCSV("scheduler_comparison.csv") && ok;
 }
 
-void runMLWorkloadSimulation() {
+bool runMLWorkloadSimulation() {
     std::cout << "\n==============================================\n";
     std::cout << "  MACHINE LEARNING WORKLOAD SIMULATION\n";
     std::cout << "==============================================\n\n";
@@ -160,11 +224,17 @@ void runMLWorkloadSimulation() {
     gpu.waitForCompletion();
 
     // Results
-    gpu.getPerformanceAnalyzer()->printDetailedReport();
-    gpu.getPerformanceAnalyzer()->exportToCSV("ml_workload_results.csv");
+    PerformanceAnalyzer* analyzer = gpu.getPerformanceAnalyzer();
+    analyzer->printDetailedReport();
+    analyzer->printRooflineReport();
+    analyzer->printEnergyReport();
+    bool ok = analyzer->exportToCSV("ml_workload_results.csv");
+    ok = analyzer->exportRooflineCSV("ml_workload_roofline.csv") && ok;
+    ok = analyzer->exportRooflineSVG("ml_workload_roofline.svg") && ok;
+    return ok && analyzer->getWorkloadCount() == 7;
 }
 
-void runCustomWorkloadBenchmark() {
+bool runCustomWorkloadBenchmark() {
     std::cout << "\n==============================================\n";
     std::cout << "  CUSTOM WORKLOAD BENCHMARK\n";
     std::cout << "==============================================\n\n";
@@ -212,6 +282,559 @@ void runCustomWorkloadBenchmark() {
               << gpu.getPerformanceAnalyzer()->getFastestWorkload().workload_name << "\n";
     std::cout << "Slowest workload: "
               << gpu.getPerformanceAnalyzer()->getSlowestWorkload().workload_name << "\n";
+    return gpu.getPerformanceAnalyzer()->getWorkloadCount() == workloads.size();
+}
+
+bool runBackfillComparison() {
+    std::cout << "\n==============================================\n";
+    std::cout << "  BACKFILLING VS FIFO\n";
+    std::cout << "==============================================\n\n";
+
+    SchedulerComparison comparison;
+
+    std::vector<SchedulingAlgorithm> algorithms = {
+        SchedulingAlgorithm::FIFO,
+        SchedulingAlgorithm::BACKFILL
+    };
+
+    const char* algorithm_names[] = {
+        "FIFO",
+        "Backfill"
+    };
+
+    // The trace is fixed, so replicas differ only by host thread timing
+    const size_t replicas = 3;
+    const size_t parallel_replicas = std::min<size_t>(4, std::max(1u, std::thread::hardware_concurrency()));
+
+    bool ok = true;
+    for (size_t i = 0; i < algorithms.size(); ++i) {
+        std::cout << "\nTesting " << algorithm_names[i] << " scheduler (" << replicas << " replicas)...\n";
+
+        ok = comparison.runReplicas(algorithm_names[i], [algorithm = algorithms[i]](uint64_t, std::ostream& log) {
+            GPUConfig config;
+            config.num_compute_units = 16;
+            GPUDevice gpu(config, log);
+            gpu.setScheduler(SchedulerFactory::createScheduler(algorithm));
+
+            // Trace mix: wide kernels interleaved with narrow ones that leave
+            // most of the device idle when run on their own
+            std::vector<std::shared_ptr<Workload>> trace = {
+                Workload::createMatrixMultiply(256, 256, 256),
+                Workload::createVectorAdd(2 * 1024),
+                Workload::createReduction(4 * 1024),
+                Workload::createConvolution(1, 16, 64, 64),
+                Workload::createMatrixMultiply(64, 64, 64),
+                Workload::createVectorAdd(1024),
+                Workload::createVectorAdd(512 * 1024),
+                Workload::createReduction(2 * 1024),
+                Workload::createMatrixMultiply(32, 64, 128)
+            };
+
+            for (auto& workload : trace) {
+                gpu.submitWorkload(workload);
+            }
+
+            gpu.executeWorkloads();
+            gpu.waitForCompletion();
+
+            return std::make_unique<PerformanceAnalyzer>(*gpu.getPerformanceAnalyzer());
+        }, replicas, 42, parallel_replicas) && ok;
+    }
+
+    comparison.printComparison();
+    return comparison.exportComparisonCSV("backfill_comparison.csv") && ok;
+}
+
+bool runPredictorWarmup() {
+    std::cout << "\n==============================================\n";
+    std::cout << "  RUNTIME PREDICTOR WARM-UP\n";
+    std::cout << "==============================================\n\n";
+
+    const std::string model_file = "runtime_model.txt";
+
+    auto predictor = std::make_shared<RuntimePredictor>();
+    if (predictor->load(model_file)) {
+        std::cout << "Loaded " << predictor->getModelCount() << " runtime models from "
+                  << model_file << "\n";
+    }
+
+    const size_t rounds = 4;
+    std::vector<double> round_errors;
+
+    for (size_t round = 0; round < rounds; ++round) {
+        std::cout << "\nRound " << (round + 1) << " of " << rounds << "...\n";
+
+        GPUConfig config;
+        config.num_compute_units = 16;
+        GPUDevice gpu(config);
+
+        auto scheduler = SchedulerFactory::createScheduler(SchedulingAlgorithm::SHORTEST_JOB_FIRST);
+        scheduler->setRuntimePredictor(predictor);
+        gpu.setScheduler(std::move(scheduler));
+
+        // Same kernel families each round, with shapes that drift between rounds
+        size_t scale = round + 1;
+        gpu.submitWorkload(Workload::createMatrixMultiply(64 * scale, 64 * scale, 128));
+        gpu.submitWorkload(Workload::createVectorAdd(64 * 1024 * scale));
+        gpu.submitWorkload(Workload::createReduction(32 * 1024 * scale));
+        gpu.submitWorkload(Workload::createConvolution(1, 8, 32 * scale, 32));
+        gpu.submitWorkload(Workload::createVectorAdd(16 * 1024 * scale));
+
+        gpu.executeWorkloads();
+        gpu.waitForCompletion();
+
+        round_errors.push_back(gpu.getPerformanceAnalyzer()->getMeanPredictionError());
+        predictor->printSummary();
+    }
+
+    std::cout << "\nPrediction error by round:\n";
+    for (size_t round = 0; round < round_errors.size(); ++round) {
+        std::cout << "  Round " << (round + 1) << ": " << std::fixed << std::setprecision(2)
+                  << round_errors[round] << "%\n";
+    }
+
+    if (!predictor->save(model_file)) {
+        return false;
+    }
+    std::cout << "Runtime model saved to " << model_file << "\n";
+    return true;
+}
+
+std::vector<std::shared_ptr<Workload>> createCoSchedulingMix() {
+    // Compute-bound GEMMs and convolutions next to bandwidth-bound vector adds
+    return {
+        Workload::createMatrixMultiply(256, 256, 256),
+        Workload::createVectorAdd(256 * 1024),
+        Workload::createConvolution(1, 16, 64, 64),
+        Workload::createVectorAdd(128 * 1024),
+        Workload::createMatrixMultiply(128, 128, 512)
+    };
+}
+
+bool runCoSchedulingExperiment() {
+    std::cout << "\n==============================================\n";
+    std::cout << "  CO-SCHEDULING COMPUTE AND MEMORY BOUND KERNELS\n";
+    std::cout << "==============================================\n\n";
+
+    GPUConfig config;
+    config.num_compute_units = 16;
+
+    // Isolated baseline: every kernel alone on the device
+    std::cout << "Running kernels in isolation...\n";
+    GPUDevice isolated_gpu(config);
+    for (auto& workload : createCoSchedulingMix()) {
+        isolated_gpu.submitWorkload(workload);
+    }
+    isolated_gpu.executeWorkloads();
+    isolated_gpu.waitForCompletion();
+
+    // Complementary pairs share the device
+    std::cout << "\nRunning complementary pairs together...\n";
+    GPUDevice shared_gpu(config);
+    auto scheduler = std::make_unique<CoScheduler>();
+    CoScheduler* co_scheduler = scheduler.get();
+    shared_gpu.setScheduler(std::move(scheduler));
+
+    for (auto& workload : createCoSchedulingMix()) {
+        std::cout << workload->getName() << ": "
+                  << std::fixed << std::setprecision(2) << workload->getArithmeticIntensity()
+                  << " instr/mem op, "
+                  << (co_scheduler->isComputeBound(*workload) ? "compute-bound" : "memory-bound") << "\n";
+        shared_gpu.submitWorkload(workload);
+    }
+    shared_gpu.executeWorkloads();
+    shared_gpu.waitForCompletion();
+
+    shared_gpu.getPerformanceAnalyzer()->printInterferenceReport(*isolated_gpu.getPerformanceAnalyzer());
+    return shared_gpu.getPerformanceAnalyzer()->exportToCSV("co_scheduling_results.csv");
+}
+
+bool runAdmissionControlDemo() {
+    std::cout << "\n==============================================\n";
+    std::cout << "  ADMISSION CONTROL AND LOAD SHEDDING\n";
+    std::cout << "==============================================\n\n";
+
+    GPUConfig config;
+    config.num_compute_units = 16;
+    config.admission.max_pending_workloads = 4;
+    config.admission.max_pending_blocks = 1024;
+    config.admission.max_pending_memory_bytes = 512ULL * 1024 * 1024;
+    GPUDevice gpu(config);
+
+    gpu.printDeviceInfo();
+    gpu.executeWorkloads();
+
+    // A burst the frontend sheds: non-blocking submits fail once the queue is full
+    std::cout << "Burst of 12 requests with non-blocking submit...\n";
+    size_t shed = 0;
+    for (int i = 0; i < 12; ++i) {
+        if (!gpu.trySubmitWorkload(Workload::createVectorAdd(32 * 1024 * (i % 3 + 1)))) {
+            shed++;
+        }
+    }
+    std::cout << "Shed " << shed << " of 12 requests\n\n";
+
+    // Blocking submits apply backpressure to the producer instead
+    std::cout << "6 requests with blocking submit...\n";
+    for (int i = 0; i < 6; ++i) {
+        gpu.submitWorkload(Workload::createReduction(64 * 1024));
+    }
+
+    gpu.waitForCompletion();
+
+    gpu.getPerformanceAnalyzer()->printSummary();
+
+    // Shedding is the point; every request that got in must still finish
+    return gpu.getPerformanceAnalyzer()->getWorkloadCount() == 12 - shed + 6;
+}
+
+bool runClosedLoopAsyncDemo() {
+    std::cout << "\n==============================================\n";
+    std::cout << "  CLOSED-LOOP ASYNCHRONOUS SUBMISSION\n";
+    std::cout << "==============================================\n\n";
+
+    GPUConfig config;
+    config.num_compute_units = 16;
+    GPUDevice gpu(config);
+    gpu.setScheduler(SchedulerFactory::createScheduler(SchedulingAlgorithm::BACKFILL));
+
+    // The device stays up across both batches
+    gpu.executeWorkloads();
+
+    // Batch 1: each client resubmits from its completion callback until it
+    // has issued its share of requests
+    const size_t clients = 4;
+    const size_t requests_per_client = 3;
+    std::atomic<size_t> completed{0};
+    std::function<void(size_t, size_t)> issue = [&](size_t client, size_t request) {
+        gpu.submitAsync(Workload::createVectorAdd(16 * 1024 * (client + 1)),
+            [&, client, request](const WorkloadMetrics& metrics) {
+                completed++;
+                std::cout << "  client " << client << " request " << request << " done: "
+                          << metrics.workload_name << " in " << std::fixed << std::setprecision(2)
+                          << metrics.simulated_time_ns / 1000.0 << " us simulated ("
+                          << metrics.execution_time_ms << " ms host)\n";
+                if (request + 1 < requests_per_client) {
+                    issue(client, request + 1);
+                }
+            });
+    };
+
+    std::cout << "Batch 1: " << clients << " closed-loop clients, callbacks...\n";
+    for (size_t client = 0; client < clients; ++client) {
+        issue(client, 0);
+    }
+    while (completed.load() < clients * requests_per_client) {
+        gpu.waitForIdle();
+    }
+    std::cout << "Batch 1 complete: " << completed.load() << " requests\n\n";
+
+    // Batch 2: futures, submitted while the device is already running
+    std::cout << "Batch 2: futures on a running device...\n";
+    std::vector<std::future<WorkloadMetrics>> futures;
+    futures.push_back(gpu.submitAsync(Workload::createMatrixMultiply(128, 128, 128)));
+    futures.push_back(gpu.submitAsync(Workload::createReduction(128 * 1024)));
+    futures.push_back(gpu.submitAsync(Workload::createConvolution(1, 8, 32, 32)));
+
+    for (auto& future : futures) {
+        WorkloadMetrics metrics = future.get();
+        std::cout << "  future resolved: " << metrics.workload_name << " waited "
+                  << std::fixed << std::setprecision(2) << metrics.simulated_queue_wait_ns / 1000.0
+                  << " us, ran " << metrics.simulated_time_ns / 1000.0 << " us simulated ("
+                  << metrics.execution_time_ms << " ms host)\n";
+    }
+
+    gpu.waitForCompletion();
+    gpu.getPerformanceAnalyzer()->printSummary();
+    return gpu.getPerformanceAnalyzer()->getWorkloadCount() == clients * requests_per_client + futures.size();
+}
+
+bool runBatchingSweep() {
+    std::cout << "\n==============================================\n";
+    std::cout << "  DYNAMIC REQUEST BATCHING\n";
+    std::cout << "==============================================\n\n";
+
+    const size_t num_requests = 48;
+    const auto inter_arrival = std::chrono::microseconds(500);
+    const std::vector<size_t> batch_sizes = {1, 4, 16};
+    const std::vector<double> wait_times_ms = {1.0, 10.0};
+
+    std::cout << num_requests << " small inference requests, one every "
+              << inter_arrival.count() << " us\n";
+
+    std::vector<BatchingStats> results;
+    std::vector<BatchingPolicy> policies;
+
+    for (size_t batch_size : batch_sizes) {
+        for (double wait_ms : wait_times_ms) {
+            GPUConfig config;
+            config.num_compute_units = 16;
+            GPUDevice gpu(config);
+            gpu.executeWorkloads();
+
+            BatchingPolicy policy(batch_size, wait_ms);
+            BatchingFrontend frontend(gpu, policy);
+            for (size_t i = 0; i < num_requests; ++i) {
+                std::shared_ptr<Workload> request = Workload::createVectorAdd(4 * 1024);
+                frontend.submit(request);
+                std::this_thread::sleep_for(inter_arrival);
+            }
+            frontend.drain();
+            gpu.waitForCompletion();
+
+            frontend.printReport();
+            policies.push_back(policy);
+            results.push_back(frontend.getStats());
+        }
+    }
+
+    std::cout << "\n=== Batching Trade-off ===\n";
+    std::cout << std::left << std::setw(8) << "Batch"
+              << std::setw(12) << "Wait(ms)"
+              << std::setw(12) << "Avg Size"
+              << std::setw(12) << "p50(ms)"
+              << std::setw(12) << "p95(ms)"
+              << std::setw(12) << "p99(ms)"
+              << std::setw(12) << "Req/s" << "\n";
+    std::cout << std::string(80, '-') << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < results.size(); ++i) {
+        std::cout << std::left << std::setw(8) << policies[i].max_batch_size
+                  << std::setw(12) << policies[i].max_wait_ms
+                  << std::setw(12) << results[i].average_batch_size
+                  << std::setw(12) << results[i].p50_latency_ms
+                  << std::setw(12) << results[i].p95_latency_ms
+                  << std::setw(12) << results[i].p99_latency_ms
+                  << std::setw(12) << results[i].throughput_rps << "\n";
+    }
+    return std::all_of(results.begin(), results.end(), [&](const BatchingStats& stats) {
+        return stats.requests_completed == num_requests;
+    });
+}
+
+bool runOpenLoopLoadSweep(uint64_t seed = 42) {
+    std::cout << "\n==============================================\n";
+    std::cout << "  OPEN-LOOP LOAD SWEEP\n";
+    std::cout << "==============================================\n\n";
+
+    LoadProfile profile;
+    profile.seed = seed;
+    profile.sizes = SizeDistribution::LOG_UNIFORM;
+    profile.min_elements = 4 * 1024;
+    profile.max_elements = 32 * 1024;
+    // Simulated time: a request runs for tens of microseconds on 16 CUs
+    profile.duration_ms = 5.0;
+    profile.mean_calm_ms = 1.0;
+    profile.mean_burst_ms = 0.25;
+
+    auto runOnce = [](SchedulingAlgorithm algo, const LoadProfile& load) {
+        GPUConfig config;
+        config.num_compute_units = 16;
+        GPUDevice gpu(config);
+        gpu.setScheduler(SchedulerFactory::createScheduler(algo));
+        // The load curve comes from the generator; keep the analyzer flat
+        gpu.getPerformanceAnalyzer()->setRetainWorkloadMetrics(false);
+        gpu.executeWorkloads();
+
+        LoadRunResult result = LoadGenerator(load).run(gpu);
+        gpu.waitForCompletion();
+        return result;
+    };
+
+    // Poisson arrivals at increasing rates find each scheduler's knee
+    std::vector<SchedulingAlgorithm> algorithms = {
+        SchedulingAlgorithm::FIFO,
+        SchedulingAlgorithm::SHORTEST_JOB_FIRST,
+        SchedulingAlgorithm::BACKFILL
+    };
+    std::vector<double> rates = {2000.0, 6000.0, 15000.0};
+
+    std::vector<LoadRunResult> results;
+    for (auto algo : algorithms) {
+        for (double rate : rates) {
+            LoadProfile load = profile;
+            load.arrival_rate = rate;
+            results.push_back(runOnce(algo, load));
+        }
+    }
+    LoadGenerator::printLoadCurve(results);
+
+    // Same mean rate, different burstiness
+    std::vector<LoadRunResult> shaped;
+    for (auto process : {ArrivalProcess::POISSON, ArrivalProcess::MMPP, ArrivalProcess::DIURNAL}) {
+        LoadProfile load = profile;
+        load.arrivals = process;
+        load.arrival_rate = 8000.0;
+        load.period_ms = load.duration_ms;
+        std::cout << "\n" << LoadGenerator::arrivalProcessName(process) << " arrivals at "
+                  << load.arrival_rate << " requests/s (Backfill)\n";
+        shaped.push_back(runOnce(SchedulingAlgorithm::BACKFILL, load));
+        shaped.back().scheduler_name = LoadGenerator::arrivalProcessName(process);
+    }
+    LoadGenerator::printLoadCurve(shaped);
+
+    // Rejections are part of the curve; a request that vanished is not
+    results.insert(results.end(), shaped.begin(), shaped.end());
+    return std::all_of(results.begin(), results.end(), [](const LoadRunResult& result) {
+        return result.requests_completed + result.requests_rejected == result.requests_offered;
+    });
+}
+
+bool runTimelineTrace() {
+    std::cout << "\n==============================================\n";
+    std::cout << "  TIMELINE TRACE EXPORT\n";
+    std::cout << "==============================================\n\n";
+
+    GPUConfig config;
+    config.num_compute_units = 8;
+    GPUDevice gpu(config);
+    gpu.setScheduler(SchedulerFactory::createScheduler(SchedulingAlgorithm::BACKFILL));
+
+    TraceConfig trace_config;
+    trace_config.output_path = "gpu_trace.json";
+    trace_config.block_sample_interval = 2;
+    trace_config.trace_warp_stalls = true;
+    trace_config.max_events = 200000;
+    auto tracer = std::make_shared<TimelineTracer>(trace_config);
+    gpu.setTracer(tracer);
+
+    // Raw per-CU event stream alongside the JSON timeline
+    auto event_tracer = std::make_shared<EventTracer>(config.num_compute_units, "gpu_events.bin");
+    gpu.setEventTracer(event_tracer);
+
+    // Active blocks, warps and issue rate per CU every 2000 cycles
+    auto occupancy = std::make_shared<OccupancySampler>(config.num_compute_units, 2000);
+    gpu.setOccupancySampler(occupancy);
+
+    // Per-block and per-kernel records, streamed while the run progresses
+    auto record_sink = std::make_shared<StreamingRecordSink>("gpu_records.jsonl", RecordFormat::JSONL);
+    bool ok = record_sink->open();
+    if (ok) {
+        gpu.setRecordSink(record_sink);
+    }
+
+    // Overlapping kernels of different widths show waves and idle gaps
+    gpu.submitWorkload(Workload::createMatrixMultiply(128, 128, 128));
+    gpu.submitWorkload(Workload::createVectorAdd(16 * 1024));
+    gpu.submitWorkload(Workload::createReduction(32 * 1024));
+    gpu.submitWorkload(Workload::createVectorAdd(4 * 1024));
+
+    gpu.executeWorkloads();
+    gpu.waitForCompletion();
+
+    bool trace_written = tracer->write();
+    if (trace_written) {
+        std::cout << "\nWrote " << tracer->getEventCount() << " events ("
+                  << tracer->getDroppedEventCount() << " dropped) over "
+                  << gpu.getCurrentCycle() << " cycles to " << trace_config.output_path << "\n";
+        std::cout << "Open in chrome://tracing or ui.perfetto.dev\n";
+    }
+    event_tracer->printSummary();
+    occupancy->printSummary();
+    ok = occupancy->exportTimeline("gpu_occupancy.csv") && trace_written && ok;
+
+    gpu.stop();
+    if (!record_sink->close()) {
+        return false;
+    }
+    record_sink->printSummary();
+    return ok;
+}
+
+// The menu keeps the standard port so the curl line stays the same;
+// headless runs pass 0 so concurrent runs do not collide
+bool runLiveMetricsDemo(uint16_t port = 9464) {
+    std::cout << "\n==============================================\n";
+    std::cout << "  LIVE METRICS ENDPOINT\n";
+    std::cout << "==============================================\n\n";
+
+    GPUConfig config;
+    config.num_compute_units = 16;
+    GPUDevice gpu(config);
+    gpu.setScheduler(SchedulerFactory::createScheduler(SchedulingAlgorithm::BACKFILL));
+
+    MetricsServer server(gpu, port);
+    if (!server.start()) {
+        return false;
+    }
+    std::cout << "Scrape while the run is in progress, e.g.\n";
+    std::cout << "  curl http://127.0.0.1:" << server.getPort() << "/metrics\n\n";
+
+    // A steady stream of mixed kernels keeps the gauges moving
+    const uint64_t num_workloads = 12;
+    gpu.executeWorkloads();
+    for (uint64_t i = 0; i < num_workloads; ++i) {
+        switch (i % 3) {
+            case 0: gpu.submitWorkload(Workload::createMatrixMultiply(128, 128, 128)); break;
+            case 1: gpu.submitWorkload(Workload::createVectorAdd(64 * 1024)); break;
+            default: gpu.submitWorkload(Workload::createReduction(64 * 1024)); break;
+        }
+    }
+
+    // The same lock-free view the server renders
+    const LiveMetrics& live = gpu.getLiveMetrics();
+    while (live.completed_workloads.load() < num_workloads) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::cout << "  cycle " << live.simulated_cycles.load()
+                  << ", queued " << live.scheduler_queue_depth.load()
+                  << ", running " << live.running_workloads.load()
+                  << ", completed " << live.completed_workloads.load()
+                  << ", " << std::fixed << std::setprecision(2) << live.host_mips.load() << " MIPS\n";
+    }
+
+    gpu.waitForCompletion();
+    server.stop();
+    std::cout << "\nServed " << server.getRequestsServed() << " scrapes\n";
+    gpu.getPerformanceAnalyzer()->printSummary();
+    return true;
+}
+
+bool runParameterSweep(uint64_t seed = 42) {
+    std::cout << "\n==============================================\n";
+    std::cout << "  PARAMETER SWEEP\n";
+    std::cout << "==============================================\n\n";
+
+    SweepGrid grid;
+    grid.compute_units = {8, 16};
+    grid.warps_per_cu = {32, 64};
+    grid.max_blocks_per_cu = {8, 16};
+    grid.memory_latency = {200, 400};
+    grid.schedulers = {
+        SchedulingAlgorithm::FIFO,
+        SchedulingAlgorithm::SHORTEST_JOB_FIRST,
+        SchedulingAlgorithm::BACKFILL
+    };
+    grid.seeds = {seed};
+
+    // Sizes vary with the seed; the kernel types set the character of a mix
+    grid.mixes.push_back({"compute", [](uint64_t mix_seed) {
+        std::mt19937_64 rng(mix_seed);
+        std::uniform_int_distribution<size_t> dim(2, 4);
+        std::vector<std::shared_ptr<Workload>> workloads;
+        for (int i = 0; i < 4; ++i) {
+            size_t n = dim(rng) * 32;
+            workloads.push_back(Workload::createMatrixMultiply(n, n, n));
+        }
+        workloads.push_back(Workload::createConvolution(1, 16, 32, 32));
+        return workloads;
+    }});
+    grid.mixes.push_back({"streaming", [](uint64_t mix_seed) {
+        std::mt19937_64 rng(mix_seed);
+        std::uniform_int_distribution<size_t> elements(8, 32);
+        std::vector<std::shared_ptr<Workload>> workloads;
+        for (int i = 0; i < 3; ++i) {
+            workloads.push_back(Workload::createVectorAdd(elements(rng) * 1024));
+            workloads.push_back(Workload::createReduction(elements(rng) * 1024));
+        }
+        return workloads;
+    }});
+
+    // Rerunning picks up from the points already in the table
+    ParameterSweep sweep(grid, "parameter_sweep.csv");
+    std::cout << sweep.getPoints().size() << " points\n";
+    bool ok = sweep.run();
+    sweep.printSummary();
+    return ok;
 }
 
 void printMenu() {
@@ -224,7 +847,7 @@ void printMenu() {
     std::cout << "     - Demonstrates core GPU functionality\n\n";
     std::cout << "  2. Scheduler Comparison\n";
     std::cout << "     - Compare all scheduling algorithms\n";
-    std::cout << "     - FIFO, Priority, SJF, Round-Robin\n\n";
+    std::cout << "     - FIFO, Priority, SJF, Round-Robin, Backfill, Co-Schedule\n\n";
     std::cout << "  3. ML Workload Simulation\n";
     std::cout << "     - Simulate neural network inference\n";
     std::cout << "     - ResNet-like architecture\n\n";
@@ -232,11 +855,317 @@ void printMenu() {
     std::cout << "     - Mix of different workload sizes\n";
     std::cout << "     - Performance analysis\n\n";
     std::cout << "  5. Run All Simulations\n\n";
+    std::cout << "  6. Backfilling vs FIFO\n";
+    std::cout << "     - EASY backfilling on a mixed trace\n";
+    std::cout << "     - Utilization and queue wait\n\n";
+    std::cout << "  7. Runtime Predictor Warm-up\n";
+    std::cout << "     - SJF driven by a learned runtime model\n";
+    std::cout << "     - Prediction error as the model warms up\n\n";
+    std::cout << "  8. Co-Scheduling\n";
+    std::cout << "     - Pair compute- and memory-bound kernels\n";
+    std::cout << "     - Interference slowdown vs isolated runs\n\n";
+    std::cout << "  9. Admission Control\n";
+    std::cout << "     - Bounded submission queue under a burst\n";
+    std::cout << "     - Load shedding and backpressure metrics\n\n";
+    std::cout << " 10. Closed-Loop Async Submission\n";
+    std::cout << "     - Futures and completion callbacks\n";
+    std::cout << "     - Device kept running across batches\n\n";
+    std::cout << " 11. Dynamic Request Batching\n";
+    std::cout << "     - Coalesce small requests into larger grids\n";
+    std::cout << "     - Latency percentiles vs throughput per knob\n\n";
+    std::cout << " 12. Open-Loop Load Sweep\n";
+    std::cout << "     - Poisson, bursty and diurnal arrivals\n";
+    std::cout << "     - Response time vs offered load per scheduler\n\n";
+    std::cout << " 13. Timeline Trace\n";
+    std::cout << "     - Kernel, block and warp stall spans\n";
+    std::cout << "     - Chrome trace JSON on the simulated clock\n\n";
+    std::cout << " 14. Live Metrics Endpoint\n";
+    std::cout << "     - Prometheus text format over local HTTP\n";
+    std::cout << "     - Per-CU gauges, queue depths, host MIPS\n\n";
+    std::cout << " 15. Parameter Sweep\n";
+    std::cout << "     - Device config x scheduler x workload mix\n";
+    std::cout << "     - Parallel, resumable results table\n\n";
     std::cout << "  0. Exit\n\n";
     std::cout << "Enter your choice: ";
 }
 
-int main() {
+// Headless command line: one or more named scenarios, or a workload file
+// run on a chosen device and scheduler. Without arguments the interactive
+// menu runs instead.
+struct Scenario {
+    const char* name;
+    bool (*run)(uint64_t seed); // False if the run failed
+    const char* description;
+};
+
+const Scenario kScenarios[] = {
+    {"basic", [](uint64_t) { return runBasicSimulation(); }, "Simple workloads with FIFO scheduling"},
+    {"compare", [](uint64_t seed) { return runSchedulerComparison(seed); }, "All schedulers, seeded replicas"},
+    {"ml", [](uint64_t) { return runMLWorkloadSimulation(); }, "ResNet-like inference"},
+    {"custom", [](uint64_t) { return runCustomWorkloadBenchmark(); }, "Mix of workload sizes"},
+    {"backfill", [](uint64_t) { return runBackfillComparison(); }, "Backfilling vs FIFO"},
+    {"predictor", [](uint64_t) { return runPredictorWarmup(); }, "Runtime predictor warm-up"},
+    {"co-schedule", [](uint64_t) { return runCoSchedulingExperiment(); }, "Co-scheduling interference"},
+    {"admission", [](uint64_t) { return runAdmissionControlDemo(); }, "Admission control under a burst"},
+    {"closed-loop", [](uint64_t) { return runClosedLoopAsyncDemo(); }, "Closed-loop async submission"},
+    {"batching", [](uint64_t) { return runBatchingSweep(); }, "Dynamic request batching"},
+    {"load-sweep", [](uint64_t seed) { return runOpenLoopLoadSweep(seed); }, "Open-loop load sweep, seeded arrivals"},
+    {"timeline", [](uint64_t) { return runTimelineTrace(); }, "Timeline trace export"},
+    {"live-metrics", [](uint64_t) { return runLiveMetricsDemo(0); }, "Live metrics endpoint, on a free port"},
+    {"sweep", [](uint64_t seed) { return runParameterSweep(seed); }, "Parallel parameter sweep, resumable"}
+};
+
+struct CommandLineOptions {
+    std::vector<std::string> scenarios;
+    std::string workload_file;
+    std::string preset = "rtx3080";
+    size_t compute_units = 0; // 0: the preset's
+    SchedulingAlgorithm scheduler = SchedulingAlgorithm::FIFO;
+    std::optional<uint64_t> seed;
+    std::string output_dir;
+    std::string csv_path = "results.csv";
+    std::string records_path;
+    std::string trace_path;
+    bool list_scenarios = false;
+};
+
+void printUsage() {
+    std::cout << "Usage: gpu_simulator [options]\n"
+                 "       gpu_simulator                 (interactive menu)\n\n"
+                 "  --scenario NAME[,NAME...]  Run named scenarios, or 'all' (see --list)\n"
+                 "  --workload-file FILE       Run the workloads in FILE, one per line:\n"
+                 "                               matrix_multiply M N K | convolution B C H W |\n"
+                 "                               vector_add N | reduction N  [priority=P]\n"
+                 "  --preset NAME              rtx3080 (default), a100 or h100\n"
+                 "  --cus N                    Override the preset's compute unit count\n"
+                 "  --scheduler NAME           fifo (default), priority, round-robin, sjf,\n"
+                 "                             backfill or co-schedule\n"
+                 "  --seed N                   Workload file: shuffle arrival order with this seed.\n"
+                 "                             Scenarios: seed replicas and load generators (default 42)\n"
+                 "  --output-dir DIR           Create DIR and write every output there\n"
+                 "  --csv FILE                 Per-workload results (default results.csv)\n"
+                 "  --records FILE             Stream block and kernel records (.csv, else JSONL)\n"
+                 "  --trace FILE               Chrome trace of the run\n"
+                 "  --list                     List scenarios\n"
+                 "  --help                     Show this help\n\n"
+                 "Scenarios keep their own devices, schedulers and file names; --preset, --cus,\n"
+                 "--scheduler, --csv, --records and --trace apply to --workload-file runs.\n"
+                 "Exit status: 0 on success, 1 if a run fails, 2 on bad arguments.\n";
+}
+
+bool parseCommandLine(int argc, char** argv, CommandLineOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--list") {
+            options.list_scenarios = true;
+            continue;
+        }
+
+        static const char* kValueOptions[] = {
+            "--scenario", "--workload-file", "--preset", "--cus", "--scheduler",
+            "--seed", "--output-dir", "--csv", "--records", "--trace"
+        };
+        if (std::none_of(std::begin(kValueOptions), std::end(kValueOptions),
+                         [&](const char* option) { return arg == option; })) {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--scenario") {
+            std::istringstream names(value);
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                bool known = name == "all" || std::any_of(std::begin(kScenarios), std::end(kScenarios),
+                    [&](const Scenario& scenario) { return name == scenario.name; });
+                if (!known) {
+                    std::cerr << "Unknown scenario: " << name << "\n";
+                    return false;
+                }
+                options.scenarios.push_back(name);
+            }
+        } else if (arg == "--workload-file") {
+            // Resolved now, before --output-dir changes the working directory
+            options.workload_file = std::filesystem::absolute(value).string();
+        } else if (arg == "--preset") {
+            GPUConfig config;
+            if (!GPUConfig::fromPreset(value, config)) {
+                std::cerr << "Unknown preset: " << value << "\n";
+                return false;
+            }
+            options.preset = value;
+        } else if (arg == "--cus") {
+            // strtoull would take a sign, so the first character must be a digit
+            char* end = nullptr;
+            errno = 0;
+            unsigned long long count = std::strtoull(value.c_str(), &end, 10);
+            if (!std::isdigit(static_cast<unsigned char>(value[0])) || *end != '\0' || errno == ERANGE ||
+                count == 0) {
+                std::cerr << "Invalid compute unit count: " << value << "\n";
+                return false;
+            }
+            options.compute_units = static_cast<size_t>(count);
+        } else if (arg == "--scheduler") {
+            if (!SchedulerFactory::parseAlgorithm(value, options.scheduler)) {
+                std::cerr << "Unknown scheduler: " << value << "\n";
+                return false;
+            }
+        } else if (arg == "--seed") {
+            // Same rules as --cus: no sign, nothing trailing, no overflow
+            char* end = nullptr;
+            errno = 0;
+            options.seed = std::strtoull(value.c_str(), &end, 10);
+            if (!std::isdigit(static_cast<unsigned char>(value[0])) || *end != '\0' || errno == ERANGE) {
+                std::cerr << "Invalid seed: " << value << "\n";
+                return false;
+            }
+        } else if (arg == "--output-dir") {
+            options.output_dir = value;
+        } else if (arg == "--csv") {
+            options.csv_path = value;
+        } else if (arg == "--records") {
+            options.records_path = value;
+        } else if (arg == "--trace") {
+            options.trace_path = value;
+        }
+    }
+
+    if (options.list_scenarios) return true;
+    if (options.scenarios.empty() == options.workload_file.empty()) {
+        std::cerr << "Give exactly one of --scenario or --workload-file\n";
+        return false;
+    }
+    return true;
+}
+
+int runScenarios(const CommandLineOptions& options) {
+    uint64_t seed = options.seed.value_or(42);
+    for (const auto& name : options.scenarios) {
+        for (const auto& scenario : kScenarios) {
+            if (name != "all" && name != scenario.name) continue;
+            try {
+                if (!scenario.run(seed)) {
+                    std::cerr << "Scenario " << scenario.name << " failed\n";
+                    return 1;
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Scenario " << scenario.name << " failed: " << e.what() << "\n";
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int runWorkloadFile(const CommandLineOptions& options) {
+    std::vector<std::shared_ptr<Workload>> workloads;
+    if (!Workload::loadFromFile(options.workload_file, workloads)) {
+        return 1;
+    }
+    if (workloads.empty()) {
+        std::cerr << "No workloads in " << options.workload_file << "\n";
+        return 1;
+    }
+    if (options.seed) {
+        std::mt19937_64 rng(*options.seed);
+        std::shuffle(workloads.begin(), workloads.end(), rng);
+    }
+
+    GPUConfig config;
+    GPUConfig::fromPreset(options.preset, config);
+    if (options.compute_units > 0) {
+        config.num_compute_units = options.compute_units;
+    }
+    GPUDevice gpu(config);
+    gpu.setScheduler(SchedulerFactory::createScheduler(options.scheduler));
+    gpu.printDeviceInfo();
+
+    std::shared_ptr<TimelineTracer> tracer;
+    if (!options.trace_path.empty()) {
+        TraceConfig trace_config;
+        trace_config.output_path = options.trace_path;
+        tracer = std::make_shared<TimelineTracer>(trace_config);
+        gpu.setTracer(tracer);
+    }
+
+    std::shared_ptr<StreamingRecordSink> record_sink;
+    if (!options.records_path.empty()) {
+        const std::string& path = options.records_path;
+        bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+        record_sink = std::make_shared<StreamingRecordSink>(path, csv ? RecordFormat::CSV : RecordFormat::JSONL);
+        if (!record_sink->open()) {
+            return 1;
+        }
+        gpu.setRecordSink(record_sink);
+    }
+
+    for (auto& workload : workloads) {
+        gpu.submitWorkload(workload);
+    }
+
+    gpu.executeWorkloads();
+    gpu.waitForCompletion();
+
+    bool ok = true;
+    if (record_sink) {
+        ok = record_sink->close() && ok;
+    }
+    if (tracer) {
+        ok = tracer->write() && ok;
+    }
+
+    PerformanceAnalyzer* analyzer = gpu.getPerformanceAnalyzer();
+    analyzer->printSummary();
+    ok = analyzer->exportToCSV(options.csv_path) && ok;
+
+    size_t completed = analyzer->getWorkloadCount();
+    if (completed != workloads.size()) {
+        std::cerr << "Only " << completed << " of " << workloads.size() << " workloads completed\n";
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
+
+int runCommandLine(int argc, char** argv) {
+    CommandLineOptions options;
+    if (!parseCommandLine(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    if (options.list_scenarios) {
+        for (const auto& scenario : kScenarios) {
+            std::cout << std::left << std::setw(16) << scenario.name << scenario.description << "\n";
+        }
+        return 0;
+    }
+
+    if (!options.output_dir.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(options.output_dir, error);
+        std::filesystem::current_path(options.output_dir, error);
+        if (error) {
+            std::cerr << "Failed to use output directory " << options.output_dir << ": " << error.message() << "\n";
+            return 1;
+        }
+    }
+
+    return options.workload_file.empty() ? runScenarios(options) : runWorkloadFile(options);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        if (std::strcmp(argv[1], "--help") == 0 || std::strcmp(argv[1], "-h") == 0) {
+            printUsage();
+            return 0;
+        }
+        return runCommandLine(argc, argv);
+    }
+
     int choice;
 
     while (true) {
@@ -276,10 +1205,60 @@ int main() {
                 runSchedulerComparison();
                 runMLWorkloadSimulation();
                 runCustomWorkloadBenchmark();
+                runBackfillComparison();
+                runPredictorWarmup();
+                runCoSchedulingExperiment();
+                runAdmissionControlDemo();
+                runClosedLoopAsyncDemo();
+                runBatchingSweep();
+                runOpenLoopLoadSweep();
+                runTimelineTrace();
+                runLiveMetricsDemo();
+                runParameterSweep();
+                break;
+
+            case 6:
+                runBackfillComparison();
+                break;
+
+            case 7:
+                runPredictorWarmup();
+                break;
+
+            case 8:
+                runCoSchedulingExperiment();
+                break;
+
+            case 9:
+                runAdmissionControlDemo();
+                break;
+
+            case 10:
+                runClosedLoopAsyncDemo();
+                break;
+
+            case 11:
+                runBatchingSweep();
+                break;
+
+            case 12:
+                runOpenLoopLoadSweep();
+                break;
+
+            case 13:
+                runTimelineTrace();
+                break;
+
+            case 14:
+                runLiveMetricsDemo();
+                break;
+
+            case 15:
+                runParameterSweep();
                 break;
 
             default:
-                std::cout << "\nInvalid choice. Please select 0-5.\n";
+                std::cout << "\nInvalid choice. Please select 0-15.\n";
         }
 
         std::cout << "\nPress Enter to continue...";
@@ -5,9 +5,8 @@
 namespace GPUSim {
 
 // GlobalMemory implementation
-GlobalMemory::GlobalMemory(size_t size)
-    : Memory(size, 400), // ~400 cycles latency for global memory
-      data_(size, 0),
+GlobalMemory::GlobalMemory(size_t size, size_t latency)
+    : Memory(size, latency),
       read_count_(0),
       write_count_(0),
       bytes_read_(0),
@@ -49,7 +48,6 @@ void GlobalMemory::reset() {
     write_count_ = 0;
     bytes_read_ = 0;
     bytes_written_ = 0;
-    std::fill(data_.begin(), data_.end(), 0);
 }
 
 // SharedMemory implementation
@@ -113,8 +111,8 @@ void RegisterFile::clear() {
 }
 
 // MemoryController implementation
-MemoryController::MemoryController()
-    : global_memory_(std::make_shared<GlobalMemory>()),
+MemoryController::MemoryController(size_t global_memory_latency)
+    : global_memory_(std::make_shared<GlobalMemory>(GLOBAL_MEMORY_SIZE, global_memory_latency)),
       total_memory_ops_(0),
       cache_hits_(0),
       cache_misses_(0) {
@@ -126,4 +124,11 @@ double MemoryController::getCacheHitRate() const {
     return static_cast<double>(cache_hits_.load()) / total;
 }
 
+void MemoryController::reset() {
+    global_memory_->reset();
+    total_memory_ops_ = 0;
+    cache_hits_ = 0;
+    cache_misses_ = 0;
+}
+
 } // namespace GPUSim
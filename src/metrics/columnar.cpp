@@ -0,0 +1,494 @@
+#include "columnar.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace GPUSim {
+
+static const char kColumnarMagic[8] = {'G', 'P', 'U', 'S', 'I', 'M', 'C', 'R'};
+static const uint32_t kColumnarVersion = 1;
+static const uint32_t kByteOrderMark = 0x01020304;
+static const size_t kHeaderSize = 16;
+static const size_t kTrailerSize = 16;
+static const size_t kMaxPendingChunks = 2;
+
+static size_t alignTo8(size_t size) {
+    return (size + 7) & ~static_cast<size_t>(7);
+}
+
+size_t columnTypeWidth(ColumnType type) {
+    switch (type) {
+        case ColumnType::U32: return 4;
+        case ColumnType::U64: return 8;
+        case ColumnType::F64: return 8;
+        case ColumnType::DICT: return 4;
+        default: return 0;
+    }
+}
+
+// ColumnarWriter implementation
+ColumnarWriter::ColumnarWriter(const std::string& path, std::vector<ColumnSpec> schema,
+                               size_t rows_per_chunk)
+    : path_(path),
+      schema_(std::move(schema)),
+      rows_per_chunk_(std::max<size_t>(1, rows_per_chunk)),
+      file_(nullptr),
+      rows_written_(0),
+      closing_(false),
+      file_offset_(0),
+      write_failed_(false) {
+}
+
+ColumnarWriter::~ColumnarWriter() {
+    close();
+}
+
+int ColumnarWriter::findColumn(const std::string& name) const {
+    for (size_t i = 0; i < schema_.size(); ++i) {
+        if (schema_[i].name == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+ColumnarWriter::Chunk ColumnarWriter::makeChunk() const {
+    Chunk chunk;
+    chunk.columns.resize(schema_.size());
+    for (size_t i = 0; i < schema_.size(); ++i) {
+        chunk.columns[i].reserve(rows_per_chunk_ * columnTypeWidth(schema_[i].type));
+    }
+    return chunk;
+}
+
+bool ColumnarWriter::open() {
+    if (file_) return true;
+
+    file_ = std::fopen(path_.c_str(), "wb");
+    if (!file_) {
+        std::cerr << "Failed to open file: " << path_ << "\n";
+        return false;
+    }
+    file_buffer_.resize(1 << 20);
+    std::setvbuf(file_, file_buffer_.data(), _IOFBF, file_buffer_.size());
+
+    file_offset_ = 0;
+    write_failed_ = false;
+    writeBytes(kColumnarMagic, sizeof(kColumnarMagic));
+    writeBytes(&kColumnarVersion, sizeof(kColumnarVersion));
+    writeBytes(&kByteOrderMark, sizeof(kByteOrderMark));
+
+    current_ = makeChunk();
+    row_set_.assign(schema_.size(), false);
+    rows_written_ = 0;
+    chunks_.clear();
+    dictionary_.clear();
+    dictionary_index_.clear();
+    closing_ = false;
+    writer_ = std::thread(&ColumnarWriter::writerThread, this);
+    return true;
+}
+
+void ColumnarWriter::setValue(size_t column, ColumnType type, const void* value) {
+    // The current chunk only has its columns once open() has run
+    if (!file_) return;
+    if (column >= schema_.size() || schema_[column].type != type) {
+        std::cerr << "Column " << column << " of " << path_ << " does not hold this type\n";
+        return;
+    }
+
+    size_t width = columnTypeWidth(type);
+    auto& data = current_.columns[column];
+    if (row_set_[column]) {
+        std::memcpy(data.data() + data.size() - width, value, width);
+        return;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(value);
+    data.insert(data.end(), bytes, bytes + width);
+    row_set_[column] = true;
+}
+
+void ColumnarWriter::setU32(size_t column, uint32_t value) {
+    setValue(column, ColumnType::U32, &value);
+}
+
+void ColumnarWriter::setU64(size_t column, uint64_t value) {
+    setValue(column, ColumnType::U64, &value);
+}
+
+void ColumnarWriter::setF64(size_t column, double value) {
+    setValue(column, ColumnType::F64, &value);
+}
+
+void ColumnarWriter::setString(size_t column, const std::string& value) {
+    if (!file_) return;
+
+    auto it = dictionary_index_.find(value);
+    uint32_t code;
+    if (it != dictionary_index_.end()) {
+        code = it->second;
+    } else {
+        code = static_cast<uint32_t>(dictionary_.size());
+        dictionary_index_.emplace(value, code);
+        dictionary_.push_back(value);
+    }
+    setValue(column, ColumnType::DICT, &code);
+}
+
+void ColumnarWriter::endRow() {
+    if (!file_) return;
+
+    // Unset columns read back as zero
+    for (size_t i = 0; i < schema_.size(); ++i) {
+        if (!row_set_[i]) {
+            current_.columns[i].resize(current_.columns[i].size() + columnTypeWidth(schema_[i].type), 0);
+        }
+        row_set_[i] = false;
+    }
+
+    current_.rows++;
+    rows_written_++;
+    if (current_.rows >= rows_per_chunk_) {
+        submitChunk();
+    }
+}
+
+void ColumnarWriter::submitChunk() {
+    if (current_.rows == 0) return;
+
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        queue_cv_.wait(lock, [this]() { return queue_.size() < kMaxPendingChunks; });
+        queue_.push_back(std::move(current_));
+    }
+    queue_cv_.notify_all();
+    current_ = makeChunk();
+}
+
+void ColumnarWriter::writeBytes(const void* data, size_t size) {
+    if (size == 0) return;
+    if (std::fwrite(data, 1, size, file_) != size) {
+        write_failed_ = true;
+    }
+    file_offset_ += size;
+}
+
+void ColumnarWriter::writerThread() {
+    static const uint8_t kPadding[8] = {};
+
+    while (true) {
+        Chunk chunk;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait(lock, [this]() { return !queue_.empty() || closing_; });
+            if (queue_.empty()) break;
+            chunk = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        queue_cv_.notify_all();
+
+        chunks_.push_back(ChunkInfo{file_offset_, chunk.rows});
+        for (const auto& column : chunk.columns) {
+            writeBytes(column.data(), column.size());
+            writeBytes(kPadding, alignTo8(column.size()) - column.size());
+        }
+    }
+}
+
+bool ColumnarWriter::close() {
+    if (!file_) return true;
+
+    submitChunk();
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        closing_ = true;
+    }
+    queue_cv_.notify_all();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+
+    // Footer, then the trailer that locates it
+    uint64_t footer_offset = file_offset_;
+
+    uint32_t num_columns = static_cast<uint32_t>(schema_.size());
+    writeBytes(&num_columns, sizeof(num_columns));
+    for (const auto& column : schema_) {
+        uint8_t type = static_cast<uint8_t>(column.type);
+        uint32_t name_length = static_cast<uint32_t>(column.name.size());
+        writeBytes(&type, sizeof(type));
+        writeBytes(&name_length, sizeof(name_length));
+        writeBytes(column.name.data(), column.name.size());
+    }
+
+    uint64_t rows_per_chunk = rows_per_chunk_;
+    uint64_t num_chunks = chunks_.size();
+    writeBytes(&rows_per_chunk, sizeof(rows_per_chunk));
+    writeBytes(&num_chunks, sizeof(num_chunks));
+    for (const auto& chunk : chunks_) {
+        writeBytes(&chunk.offset, sizeof(chunk.offset));
+        writeBytes(&chunk.rows, sizeof(chunk.rows));
+    }
+
+    uint32_t dictionary_size = static_cast<uint32_t>(dictionary_.size());
+    writeBytes(&dictionary_size, sizeof(dictionary_size));
+    for (const auto& entry : dictionary_) {
+        uint32_t length = static_cast<uint32_t>(entry.size());
+        writeBytes(&length, sizeof(length));
+        writeBytes(entry.data(), entry.size());
+    }
+
+    writeBytes(&footer_offset, sizeof(footer_offset));
+    writeBytes(kColumnarMagic, sizeof(kColumnarMagic));
+
+    bool ok = !write_failed_;
+    if (std::fclose(file_) != 0) ok = false;
+    file_ = nullptr;
+
+    if (!ok) {
+        std::cerr << "Failed to write file: " << path_ << "\n";
+    }
+    return ok;
+}
+
+// ColumnarReader implementation
+ColumnarReader::ColumnarReader()
+    : data_(nullptr),
+      size_(0),
+#if defined(_WIN32)
+      file_handle_(nullptr),
+      mapping_handle_(nullptr),
+#else
+      fd_(-1),
+#endif
+      rows_per_chunk_(0),
+      num_rows_(0) {
+}
+
+ColumnarReader::~ColumnarReader() {
+    close();
+}
+
+bool ColumnarReader::open(const std::string& path) {
+    close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Failed to open file: " << path << "\n";
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(file, &file_size);
+    file_handle_ = file;
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    if (size_ > 0) {
+        mapping_handle_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_handle_) {
+            data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+        }
+    }
+#else
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        std::cerr << "Failed to open file: " << path << "\n";
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd_, &info) == 0 && info.st_size > 0) {
+        size_ = static_cast<size_t>(info.st_size);
+        void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (mapped != MAP_FAILED) {
+            data_ = static_cast<const uint8_t*>(mapped);
+        }
+    }
+#endif
+
+    if (!data_ || !parseFooter()) {
+        std::cerr << "Not a columnar results file: " << path << "\n";
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ColumnarReader::close() {
+#if defined(_WIN32)
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_handle_) CloseHandle(mapping_handle_);
+    if (file_handle_) CloseHandle(file_handle_);
+    mapping_handle_ = nullptr;
+    file_handle_ = nullptr;
+#else
+    if (data_) munmap(const_cast<uint8_t*>(data_), size_);
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    columns_.clear();
+    chunks_.clear();
+    dictionary_.clear();
+    rows_per_chunk_ = 0;
+    num_rows_ = 0;
+}
+
+bool ColumnarReader::parseFooter() {
+    if (size_ < kHeaderSize + kTrailerSize) return false;
+
+    uint32_t version, byte_order;
+    std::memcpy(&version, data_ + 8, sizeof(version));
+    std::memcpy(&byte_order, data_ + 12, sizeof(byte_order));
+    if (std::memcmp(data_, kColumnarMagic, sizeof(kColumnarMagic)) != 0 ||
+        std::memcmp(data_ + size_ - 8, kColumnarMagic, sizeof(kColumnarMagic)) != 0 ||
+        version != kColumnarVersion || byte_order != kByteOrderMark) {
+        return false;
+    }
+
+    uint64_t footer_offset;
+    std::memcpy(&footer_offset, data_ + size_ - kTrailerSize, sizeof(footer_offset));
+    size_t footer_end = size_ - kTrailerSize;
+    if (footer_offset < kHeaderSize || footer_offset > footer_end) return false;
+
+    // Bounds-checked cursor over the footer
+    size_t pos = static_cast<size_t>(footer_offset);
+    auto read = [&](void* out, size_t size) {
+        if (footer_end - pos < size) return false;
+        std::memcpy(out, data_ + pos, size);
+        pos += size;
+        return true;
+    };
+    auto readView = [&](std::string_view& out, size_t size) {
+        if (footer_end - pos < size) return false;
+        out = std::string_view(reinterpret_cast<const char*>(data_ + pos), size);
+        pos += size;
+        return true;
+    };
+
+    uint32_t num_columns;
+    if (!read(&num_columns, sizeof(num_columns))) return false;
+    for (uint32_t i = 0; i < num_columns; ++i) {
+        uint8_t type;
+        uint32_t name_length;
+        std::string_view name;
+        if (!read(&type, sizeof(type)) || !read(&name_length, sizeof(name_length)) ||
+            !readView(name, name_length) || type > static_cast<uint8_t>(ColumnType::DICT)) {
+            return false;
+        }
+        columns_.push_back(ColumnSpec{std::string(name), static_cast<ColumnType>(type)});
+    }
+
+    uint64_t num_chunks;
+    if (!read(&rows_per_chunk_, sizeof(rows_per_chunk_)) || !read(&num_chunks, sizeof(num_chunks)) ||
+        (num_chunks > 0 && rows_per_chunk_ == 0)) {
+        return false;
+    }
+    for (uint64_t i = 0; i < num_chunks; ++i) {
+        ChunkInfo chunk;
+        if (!read(&chunk.offset, sizeof(chunk.offset)) || !read(&chunk.rows, sizeof(chunk.rows))) {
+            return false;
+        }
+
+        // Rows are located by row / rows_per_chunk, so every chunk but the
+        // last must be full
+        bool last = i + 1 == num_chunks;
+        if (chunk.rows == 0 || chunk.rows > rows_per_chunk_ ||
+            (!last && chunk.rows != rows_per_chunk_)) {
+            return false;
+        }
+
+        // Every column of the chunk must lie between the header and the
+        // footer; no column can be wider than that span, which also keeps
+        // the sizes below from overflowing
+        if (chunk.offset % 8 != 0 || chunk.offset < kHeaderSize || chunk.offset > footer_offset) {
+            return false;
+        }
+        uint64_t span = footer_offset - chunk.offset;
+        uint64_t chunk_stride = 0;
+        for (const auto& column : columns_) {
+            if (chunk.rows > span / columnTypeWidth(column.type)) return false;
+            chunk_stride += alignTo8(chunk.rows * columnTypeWidth(column.type));
+            if (chunk_stride > span) return false;
+        }
+        chunks_.push_back(chunk);
+        num_rows_ += chunk.rows;
+    }
+
+    uint32_t dictionary_size;
+    if (!read(&dictionary_size, sizeof(dictionary_size))) return false;
+    for (uint32_t i = 0; i < dictionary_size; ++i) {
+        uint32_t length;
+        std::string_view entry;
+        if (!read(&length, sizeof(length)) || !readView(entry, length)) return false;
+        dictionary_.push_back(entry);
+    }
+
+    return true;
+}
+
+int ColumnarReader::findColumn(const std::string& name) const {
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        if (columns_[i].name == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+const uint8_t* ColumnarReader::columnData(size_t chunk, size_t column) const {
+    if (chunk >= chunks_.size() || column >= columns_.size()) return nullptr;
+
+    // Columns before this one, each padded to 8 bytes
+    uint64_t rows = chunks_[chunk].rows;
+    size_t offset = static_cast<size_t>(chunks_[chunk].offset);
+    for (size_t i = 0; i < column; ++i) {
+        offset += alignTo8(rows * columnTypeWidth(columns_[i].type));
+    }
+    return data_ + offset;
+}
+
+const uint8_t* ColumnarReader::cell(size_t column, uint64_t row) const {
+    if (row >= num_rows_ || rows_per_chunk_ == 0) return nullptr;
+
+    // Every chunk but the last is full
+    size_t chunk = static_cast<size_t>(row / rows_per_chunk_);
+    uint64_t index = row % rows_per_chunk_;
+    const uint8_t* data = columnData(chunk, column);
+    if (!data || index >= chunks_[chunk].rows) return nullptr;
+    return data + index * columnTypeWidth(columns_[column].type);
+}
+
+uint32_t ColumnarReader::getU32(size_t column, uint64_t row) const {
+    uint32_t value = 0;
+    if (const uint8_t* data = cell(column, row)) std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint64_t ColumnarReader::getU64(size_t column, uint64_t row) const {
+    uint64_t value = 0;
+    if (const uint8_t* data = cell(column, row)) std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+double ColumnarReader::getF64(size_t column, uint64_t row) const {
+    double value = 0.0;
+    if (const uint8_t* data = cell(column, row)) std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+std::string_view ColumnarReader::getString(size_t column, uint64_t row) const {
+    return getDictionaryEntry(getU32(column, row));
+}
+
+std::string_view ColumnarReader::getDictionaryEntry(uint32_t code) const {
+    return code < dictionary_.size() ? dictionary_[code] : std::string_view();
+}
+
+} // namespace GPUSim
@@ -0,0 +1,47 @@
+#include "energy.h"
+#include "roofline.h"
+#include <algorithm>
+
+namespace GPUSim {
+
+InstructionMix InstructionMix::forType(WorkloadType type) {
+    switch (type) {
+        // Tiled kernels stage operands through shared memory; most of their
+        // multiply-adds go to the tensor cores, convolution's via an implicit GEMM
+        case WorkloadType::MATRIX_MULTIPLY: return InstructionMix{0.1, 0.3, 0.6, 0.5, 0.5, 0.6};
+        case WorkloadType::CONVOLUTION: return InstructionMix{0.2, 0.4, 0.4, 0.3, 0.6, 0.5};
+        // Streaming kernels touch each element once
+        case WorkloadType::VECTOR_ADD: return InstructionMix{1.0, 0.0, 0.0, 0.0, 0.0, 0.1};
+        case WorkloadType::REDUCTION: return InstructionMix{1.0, 0.0, 0.0, 0.5, 0.1, 0.2};
+        default: return InstructionMix{0.5, 0.5, 0.0, 0.0, 0.3, 0.3};
+    }
+}
+
+EnergyBreakdown estimateEnergy(const EnergyCoefficients& coefficients, const InstructionMix& mix,
+                               uint64_t instructions, uint64_t memory_ops, size_t lanes,
+                               double active_cu_seconds) {
+    const double pj = 1e-12;
+    double arithmetic = static_cast<double>(instructions - std::min(instructions, memory_ops)) * lanes;
+    double accesses = static_cast<double>(memory_ops) * lanes;
+
+    EnergyBreakdown energy{};
+    energy.compute_j = arithmetic * (mix.alu_fraction * coefficients.alu_pj +
+                                     mix.fma_fraction * coefficients.fma_pj +
+                                     mix.mma_fraction * coefficients.mma_pj) * pj;
+
+    // Two source operands and a result per arithmetic op, one per access
+    energy.register_file_j = (arithmetic * 3 + accesses) * coefficients.register_file_pj * pj;
+
+    double shared = accesses * mix.shared_fraction;
+    double global = accesses - shared;
+    double l1_misses = global * (1.0 - mix.l1_hit_rate);
+    double l2_misses = l1_misses * (1.0 - mix.l2_hit_rate);
+    energy.shared_memory_j = shared * coefficients.shared_memory_pj * pj;
+    energy.cache_j = (global * coefficients.l1_pj + l1_misses * coefficients.l2_pj) * pj;
+    energy.dram_j = l2_misses * kBytesPerLaneAccess * coefficients.dram_pj_per_byte * pj;
+
+    energy.static_j = coefficients.leakage_w_per_cu * active_cu_seconds;
+    return energy;
+}
+
+} // namespace GPUSim
@@ -0,0 +1,161 @@
+#include "event_trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace GPUSim {
+
+static const char kTraceMagic[8] = {'G', 'P', 'U', 'S', 'I', 'M', 'E', 'V'};
+static const uint32_t kTraceVersion = 1;
+
+EventRing::EventRing(size_t capacity)
+    : head_(0),
+      cached_tail_(0),
+      dropped_(0),
+      tail_(0) {
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+    buffer_.resize(size);
+    mask_ = size - 1;
+}
+
+bool EventRing::drainTo(std::FILE* file, uint32_t compute_unit, size_t& drained) {
+    drained = 0;
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    if (head == tail) return true;
+
+    uint32_t header[2] = {compute_unit, static_cast<uint32_t>(head - tail)};
+    size_t first = tail & mask_;
+    size_t count = head - tail;
+    size_t until_wrap = std::min(count, buffer_.size() - first);
+    if (std::fwrite(header, sizeof(header), 1, file) != 1 ||
+        std::fwrite(&buffer_[first], sizeof(TraceRecord), until_wrap, file) != until_wrap) {
+        return false;
+    }
+    if (count > until_wrap &&
+        std::fwrite(&buffer_[0], sizeof(TraceRecord), count - until_wrap, file) != count - until_wrap) {
+        return false;
+    }
+
+    tail_.store(head, std::memory_order_release);
+    drained = count;
+    return true;
+}
+
+EventTracer::EventTracer(size_t num_compute_units, const std::string& output_path,
+                         size_t ring_capacity)
+    : output_path_(output_path),
+      file_(nullptr),
+      running_(false),
+      records_written_(0),
+      write_failed_(false) {
+    rings_.reserve(num_compute_units);
+    for (size_t i = 0; i < num_compute_units; ++i) {
+        rings_.push_back(std::make_unique<EventRing>(ring_capacity));
+    }
+}
+
+EventTracer::~EventTracer() {
+    stop();
+}
+
+EventRing* EventTracer::getRing(size_t compute_unit) {
+    if (compute_unit >= rings_.size()) {
+        return nullptr;
+    }
+    return rings_[compute_unit].get();
+}
+
+bool EventTracer::start() {
+    if (running_.load()) return true;
+
+    file_ = std::fopen(output_path_.c_str(), "wb");
+    if (!file_) {
+        std::cerr << "Failed to open file: " << output_path_ << "\n";
+        return false;
+    }
+    file_buffer_.resize(1 << 20);
+    std::setvbuf(file_, file_buffer_.data(), _IOFBF, file_buffer_.size());
+
+    uint32_t record_size = sizeof(TraceRecord);
+    uint32_t num_rings = static_cast<uint32_t>(rings_.size());
+    if (std::fwrite(kTraceMagic, 1, sizeof(kTraceMagic), file_) != sizeof(kTraceMagic) ||
+        std::fwrite(&kTraceVersion, sizeof(kTraceVersion), 1, file_) != 1 ||
+        std::fwrite(&record_size, sizeof(record_size), 1, file_) != 1 ||
+        std::fwrite(&num_rings, sizeof(num_rings), 1, file_) != 1) {
+        std::cerr << "Failed to write file: " << output_path_ << "\n";
+        std::fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+
+    write_failed_.store(false);
+    running_.store(true);
+    drainer_ = std::thread(&EventTracer::drainerThread, this);
+    return true;
+}
+
+bool EventTracer::stop() {
+    if (!running_.exchange(false)) return !write_failed_.load();
+
+    if (drainer_.joinable()) {
+        drainer_.join();
+    }
+
+    // Producers have stopped by now; pick up their last records
+    drainOnce();
+
+    if (std::fclose(file_) != 0 && !write_failed_.exchange(true)) {
+        std::cerr << "Failed to write file: " << output_path_ << "\n";
+    }
+    file_ = nullptr;
+    return !write_failed_.load();
+}
+
+size_t EventTracer::drainOnce() {
+    // After a failed write the file is cut mid-chunk; what the rings still
+    // hold stays there and later records count as dropped
+    if (write_failed_.load()) return 0;
+
+    size_t drained = 0;
+    for (size_t i = 0; i < rings_.size(); ++i) {
+        size_t count = 0;
+        if (!rings_[i]->drainTo(file_, static_cast<uint32_t>(i), count)) {
+            write_failed_.store(true);
+            std::cerr << "Failed to write file: " << output_path_ << "\n";
+            break;
+        }
+        drained += count;
+    }
+    records_written_ += drained;
+    return drained;
+}
+
+void EventTracer::drainerThread() {
+    // Large batches keep the drainer's share of the host small; the rings are
+    // sized to absorb a period's worth of records
+    while (running_.load()) {
+        drainOnce();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+uint64_t EventTracer::getDroppedCount() const {
+    uint64_t dropped = 0;
+    for (const auto& ring : rings_) {
+        dropped += ring->getDroppedCount();
+    }
+    return dropped;
+}
+
+void EventTracer::printSummary() const {
+    uint64_t written = records_written_.load();
+    std::cout << "Event Tracer: " << written << " records ("
+              << written * sizeof(TraceRecord) / 1024 << " KB) written to "
+              << output_path_ << ", " << getDroppedCount() << " dropped"
+              << (write_failed_.load() ? ", write failed" : "") << "\n";
+}
+
+} // namespace GPUSim
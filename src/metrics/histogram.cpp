@@ -0,0 +1,198 @@
+#include "histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace GPUSim {
+
+static const int kMinPrecisionBits = 2;
+static const int kMaxPrecisionBits = 16;
+
+static int highestBit(uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) ++bit;
+    return bit;
+}
+
+LatencyHistogram::LatencyHistogram(int precision_bits)
+    : precision_bits_(std::min(kMaxPrecisionBits, std::max(kMinPrecisionBits, precision_bits))),
+      total_count_(0),
+      min_(std::numeric_limits<uint64_t>::max()),
+      max_(0),
+      sum_(0.0) {
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) const {
+    uint64_t linear_limit = 1ULL << precision_bits_;
+    if (value < linear_limit) {
+        return static_cast<size_t>(value);
+    }
+
+    // value >> shift lands in [half, 2 * half)
+    uint64_t half = linear_limit >> 1;
+    int shift = highestBit(value) - (precision_bits_ - 1);
+    uint64_t mantissa = value >> shift;
+    return static_cast<size_t>(linear_limit + (shift - 1) * half + (mantissa - half));
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t index) const {
+    uint64_t linear_limit = 1ULL << precision_bits_;
+    if (index < linear_limit) {
+        return index;
+    }
+
+    uint64_t half = linear_limit >> 1;
+    uint64_t offset = index - linear_limit;
+    int shift = static_cast<int>(offset / half) + 1;
+    uint64_t mantissa = half + offset % half;
+    return mantissa << shift;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) const {
+    uint64_t linear_limit = 1ULL << precision_bits_;
+    if (index < linear_limit) {
+        return index;
+    }
+
+    uint64_t half = linear_limit >> 1;
+    int shift = static_cast<int>((index - linear_limit) / half) + 1;
+    return bucketLowerBound(index) + ((1ULL << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t value, uint64_t count) {
+    if (count == 0) return;
+
+    size_t index = bucketIndex(value);
+    if (index >= counts_.size()) {
+        counts_.resize(index + 1, 0);
+    }
+    counts_[index] += count;
+
+    total_count_ += count;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    sum_ += static_cast<double>(value) * count;
+}
+
+bool LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.precision_bits_ != precision_bits_) {
+        std::cerr << "Cannot merge histograms of different precision ("
+                  << precision_bits_ << " vs " << other.precision_bits_ << " bits)\n";
+        return false;
+    }
+    if (other.total_count_ == 0) return true;
+
+    if (other.counts_.size() > counts_.size()) {
+        counts_.resize(other.counts_.size(), 0);
+    }
+    for (size_t i = 0; i < other.counts_.size(); ++i) {
+        counts_[i] += other.counts_[i];
+    }
+
+    total_count_ += other.total_count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+    return true;
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+    if (total_count_ == 0) return 0;
+
+    percentile = std::min(100.0, std::max(0.0, percentile));
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * total_count_));
+    rank = std::max<uint64_t>(1, rank);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            return std::min(max_, std::max(min_, bucketUpperBound(i)));
+        }
+    }
+    return max_;
+}
+
+void LatencyHistogram::serialize(std::ostream& out) const {
+    out << "hdr-histogram v1 " << precision_bits_ << " " << total_count_ << " "
+        << getMin() << " " << max_ << " " << std::setprecision(17) << sum_ << "\n";
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        if (counts_[i] > 0) {
+            out << i << " " << counts_[i] << "\n";
+        }
+    }
+    out << "end\n";
+}
+
+bool LatencyHistogram::deserialize(std::istream& in) {
+    std::string line;
+    if (!std::getline(in, line)) return false;
+
+    std::istringstream header(line);
+    std::string magic, version;
+    int precision_bits;
+    uint64_t total_count, min_value, max_value;
+    double sum;
+    if (!(header >> magic >> version >> precision_bits >> total_count >> min_value >> max_value >> sum) ||
+        magic != "hdr-histogram" || version != "v1") {
+        std::cerr << "Malformed histogram header\n";
+        return false;
+    }
+
+    // Bucket indices only mean something at the precision they were written with
+    if (precision_bits < kMinPrecisionBits || precision_bits > kMaxPrecisionBits) {
+        std::cerr << "Histogram precision out of range: " << precision_bits << " bits\n";
+        return false;
+    }
+
+    LatencyHistogram loaded(precision_bits);
+    size_t max_index = loaded.bucketIndex(std::numeric_limits<uint64_t>::max());
+    while (std::getline(in, line) && line != "end") {
+        std::istringstream fields(line);
+        size_t index;
+        uint64_t count;
+        if (!(fields >> index >> count) || index > max_index) {
+            std::cerr << "Malformed histogram bucket: " << line << "\n";
+            return false;
+        }
+        if (index >= loaded.counts_.size()) {
+            loaded.counts_.resize(index + 1, 0);
+        }
+        loaded.counts_[index] += count;
+    }
+
+    loaded.total_count_ = total_count;
+    loaded.min_ = total_count ? min_value : std::numeric_limits<uint64_t>::max();
+    loaded.max_ = max_value;
+    loaded.sum_ = sum;
+    *this = std::move(loaded);
+    return true;
+}
+
+void LatencyHistogram::print(const std::string& label, const std::string& unit, double scale) const {
+    std::cout << std::left << std::setw(22) << label << std::right << std::fixed << std::setprecision(2);
+    if (total_count_ == 0) {
+        std::cout << "no samples\n";
+        return;
+    }
+    std::cout << "n=" << total_count_
+              << "  mean " << getMean() * scale
+              << "  p50 " << getPercentile(50.0) * scale
+              << "  p90 " << getPercentile(90.0) * scale
+              << "  p99 " << getPercentile(99.0) * scale
+              << "  p99.9 " << getPercentile(99.9) * scale
+              << "  max " << max_ * scale << " " << unit << "\n";
+}
+
+void LatencyHistogram::reset() {
+    counts_.clear();
+    total_count_ = 0;
+    min_ = std::numeric_limits<uint64_t>::max();
+    max_ = 0;
+    sum_ = 0.0;
+}
+
+} // namespace GPUSim
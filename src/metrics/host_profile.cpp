@@ -0,0 +1,68 @@
+#include "host_profile.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
+#else
+#include <sys/resource.h>
+#include <time.h>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace GPUSim {
+
+uint64_t threadCpuTimeNs() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+    }
+#endif
+    // Windows thread times tick too coarsely for short scopes; fall back to
+    // the steady clock there
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t threadCpuTimeOverheadNs() {
+    // Median of many back-to-back reads: the read costs a system call whose
+    // length varies, and the minimum would leave most of it in every sample
+    static const uint64_t overhead = []() {
+        std::vector<uint64_t> reads(1001);
+        for (auto& read : reads) {
+            uint64_t start = threadCpuTimeNs();
+            read = threadCpuTimeNs() - start;
+        }
+        std::nth_element(reads.begin(), reads.begin() + reads.size() / 2, reads.end());
+        return reads[reads.size() / 2];
+    }();
+    return overhead;
+}
+
+size_t getPeakRSSBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<size_t>(counters.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss); // Bytes on macOS
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024; // Kilobytes on Linux
+#endif
+#endif
+}
+
+} // namespace GPUSim
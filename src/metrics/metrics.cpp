@@ -1,76 +1,206 @@
 #include "metrics.h"
 #include "workload.h"
 #include "gpu_device.h"
+#include "columnar.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <algorithm>
 #include <numeric>
+#include <cmath>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <exception>
 
 namespace GPUSim {
 
 PerformanceAnalyzer::PerformanceAnalyzer()
-    : gpu_metrics_{} {
+    : retain_workload_metrics_(true),
+      gpu_metrics_{} {
     gpu_metrics_.total_cycles = 0;
     gpu_metrics_.total_instructions = 0;
     gpu_metrics_.total_memory_ops = 0;
     gpu_metrics_.total_execution_time_ms = 0.0;
     gpu_metrics_.average_utilization = 0.0;
     gpu_metrics_.memory_bandwidth_utilization = 0.0;
+    gpu_metrics_.cu_allocation_utilization = 0.0;
+    gpu_metrics_.core_clock_mhz = 0.0;
+    gpu_metrics_.num_compute_units = 0;
+    gpu_metrics_.average_queue_wait_ns = 0.0;
+    gpu_metrics_.p99_queue_wait_ns = 0.0;
+    gpu_metrics_.p99_service_time_ns = 0.0;
+    gpu_metrics_.mean_prediction_error_pct = 0.0;
     gpu_metrics_.total_workloads_executed = 0;
+    gpu_metrics_.workloads_admitted = 0;
+    gpu_metrics_.workloads_rejected = 0;
+    gpu_metrics_.average_admission_wait_ms = 0.0;
+    gpu_metrics_.max_admission_wait_ms = 0.0;
 }
 
-void PerformanceAnalyzer::recordWorkloadMetrics(const Workload* workload, const GPUDevice* device) {
-    if (!workload || !device) return;
+WorkloadMetrics PerformanceAnalyzer::recordWorkloadMetrics(const Workload* workload, const GPUDevice* device) {
+    if (!workload || !device) return WorkloadMetrics{};
 
     WorkloadMetrics metrics;
     metrics.workload_name = workload->getName();
     metrics.type = workload->getType();
+    metrics.simulated_cycles = workload->getExecutionCycles();
+    metrics.simulated_time_ns = device->cyclesToNs(metrics.simulated_cycles);
+    metrics.queue_wait_cycles = workload->getQueueWaitCycles();
+    metrics.simulated_queue_wait_ns = device->cyclesToNs(metrics.queue_wait_cycles);
     metrics.execution_time_ms = workload->getExecutionTime();
+    metrics.queue_wait_ms = workload->getQueueWaitTime();
+    metrics.predicted_time_ns = device->cyclesToNs(static_cast<uint64_t>(workload->getPredictedCycles()));
+    metrics.prediction_error_pct = 0.0;
+    if (metrics.simulated_cycles > 0) {
+        metrics.prediction_error_pct = std::abs(workload->getPredictedCycles() - metrics.simulated_cycles) /
+                                       metrics.simulated_cycles * 100.0;
+    }
     metrics.total_threads = workload->getConfig().getTotalThreads();
     metrics.total_blocks = workload->getConfig().getTotalBlocks();
-
-    // Aggregate metrics from all compute units
-    metrics.instructions_executed = 0;
-    metrics.cycles_executed = 0;
-    double total_utilization = 0.0;
-
-    for (const auto& cu : device->getComputeUnits()) {
-        metrics.instructions_executed += cu->getInstructionsExecuted();
-        metrics.cycles_executed += cu->getCyclesExecuted();
-        total_utilization += cu->getUtilization();
-    }
-
-    metrics.average_cu_utilization = total_utilization / device->getNumComputeUnits();
-
-    // Calculate throughput
-    if (metrics.execution_time_ms > 0) {
-        metrics.throughput = static_cast<double>(metrics.instructions_executed) / metrics.execution_time_ms;
+    metrics.compute_units_allocated = workload->getAllocatedComputeUnits();
+    metrics.co_runner = workload->getCoRunner();
+
+    // Counters attributed to this workload's own blocks
+    metrics.instructions_executed = workload->getInstructionsExecuted();
+    metrics.cycles_executed = workload->getCyclesExecuted();
+    metrics.memory_operations = workload->getMemoryOpsExecuted();
+    metrics.stall_cycles = workload->getStallCycles();
+
+    // Every arithmetic instruction runs on all lanes of the warp, every
+    // memory instruction moves one word per lane
+    size_t lanes = device->getConfig().threads_per_warp;
+    uint64_t arithmetic = metrics.instructions_executed -
+                          std::min(metrics.instructions_executed, metrics.memory_operations);
+    metrics.flops = arithmetic * lanes * flopsPerLane(metrics.type);
+    metrics.memory_bytes = metrics.memory_operations * lanes * kBytesPerLaneAccess;
+
+    // Energy over simulated time; leakage on the CUs the workload could use
+    double simulated_s = metrics.simulated_time_ns / 1e9;
+    size_t held_units = std::min(metrics.compute_units_allocated, metrics.total_blocks);
+    metrics.energy = estimateEnergy(device->getConfig().energy, workload->getInstructionMix(),
+                                    metrics.instructions_executed, metrics.memory_operations, lanes,
+                                    held_units * simulated_s);
+    double energy_j = metrics.energy.totalJoules();
+    metrics.average_power_w = simulated_s > 0 ? energy_j / simulated_s : 0.0;
+    metrics.gflops_per_watt = energy_j > 0 ? metrics.flops / energy_j / 1e9 : 0.0;
+
+    // Cycles its own blocks kept the CUs busy, over the CU-cycles it held
+    double held_cycles = static_cast<double>(held_units) * metrics.simulated_cycles;
+    metrics.average_cu_utilization = held_cycles > 0
+        ? std::min(100.0, metrics.cycles_executed / held_cycles * 100.0) : 0.0;
+
+    // Throughput over the workload's simulated run
+    if (metrics.simulated_time_ns > 0) {
+        metrics.throughput = metrics.instructions_executed / (metrics.simulated_time_ns / 1000.0);
     } else {
         metrics.throughput = 0.0;
     }
 
-    metrics.memory_operations = device->getMemoryController()->getTotalMemoryOps();
+    // The latency histograms print on this clock before recordGPUMetrics runs
+    gpu_metrics_.core_clock_mhz = device->getConfig().core_clock_mhz;
+    gpu_metrics_.num_compute_units = device->getNumComputeUnits();
+    queue_wait_cycles_.record(metrics.queue_wait_cycles);
+    service_cycles_.record(metrics.simulated_cycles);
 
-    workload_metrics_.push_back(metrics);
+    if (totals_.count == 0 || metrics.simulated_cycles < totals_.fastest.simulated_cycles) {
+        totals_.fastest = metrics;
+    }
+    if (totals_.count == 0 || metrics.simulated_cycles > totals_.slowest.simulated_cycles) {
+        totals_.slowest = metrics;
+    }
+    totals_.count++;
+    totals_.execution_time_ms += metrics.execution_time_ms;
+    totals_.queue_wait_ms += metrics.queue_wait_ms;
+    totals_.prediction_error_pct += metrics.prediction_error_pct;
+    totals_.throughput += metrics.throughput;
+    totals_.queue_wait_cycles += metrics.queue_wait_cycles;
+    // A workload never occupies more CUs than it has blocks
+    totals_.reserved_cu_cycles += static_cast<double>(metrics.simulated_cycles) * held_units;
+    totals_.flops += metrics.flops;
+    totals_.dynamic_energy_j += metrics.energy.dynamicJoules();
+
+    if (retain_workload_metrics_) {
+        workload_metrics_.push_back(metrics);
+    }
+    return metrics;
 }
 
 void PerformanceAnalyzer::recordGPUMetrics(const GPUDevice* device) {
     if (!device) return;
 
+    gpu_metrics_.simulated_cycles = 0;
     gpu_metrics_.total_cycles = 0;
     gpu_metrics_.total_instructions = 0;
     double total_utilization = 0.0;
+    warp_stall_cycles_.reset();
+    cu_stall_cycles_.clear();
 
     for (const auto& cu : device->getComputeUnits()) {
+        gpu_metrics_.simulated_cycles = std::max(gpu_metrics_.simulated_cycles, cu->getCyclesExecuted());
         gpu_metrics_.total_cycles += cu->getCyclesExecuted();
         gpu_metrics_.total_instructions += cu->getInstructionsExecuted();
         total_utilization += cu->getUtilization();
+        warp_stall_cycles_.merge(cu->getStallHistogram());
+        cu_stall_cycles_.push_back(cu->getStallBreakdown());
     }
 
+    gpu_metrics_.core_clock_mhz = device->getConfig().core_clock_mhz;
+    gpu_metrics_.num_compute_units = device->getNumComputeUnits();
+    gpu_metrics_.simulated_time_ns = device->cyclesToNs(gpu_metrics_.simulated_cycles);
     gpu_metrics_.average_utilization = total_utilization / device->getNumComputeUnits();
     gpu_metrics_.total_memory_ops = device->getMemoryController()->getTotalMemoryOps();
-    gpu_metrics_.total_workloads_executed = workload_metrics_.size();
+    gpu_metrics_.peak_gflops = device->getPeakGflops();
+
+    // Device leakage counts every CU while it held work, shared or not
+    uint64_t active_cu_cycles = 0;
+    for (const auto& cu : device->getComputeUnits()) {
+        active_cu_cycles += cu->getCyclesExecuted() - std::min(cu->getCyclesExecuted(), cu->getIdleCycles());
+    }
+    gpu_metrics_.static_energy_j = device->getConfig().energy.leakage_w_per_cu * device->cyclesToNs(active_cu_cycles) / 1e9;
+    gpu_metrics_.energy_j = totals_.dynamic_energy_j + gpu_metrics_.static_energy_j;
+    gpu_metrics_.average_power_w =
+        gpu_metrics_.simulated_time_ns > 0 ? gpu_metrics_.energy_j / (gpu_metrics_.simulated_time_ns / 1e9) : 0.0;
+    gpu_metrics_.gflops_per_watt = gpu_metrics_.energy_j > 0 ? totals_.flops / gpu_metrics_.energy_j / 1e9 : 0.0;
+    gpu_metrics_.peak_bandwidth_gbs = device->getPeakBandwidthGBs();
+    double memory_bytes = static_cast<double>(gpu_metrics_.total_memory_ops) *
+                          device->getConfig().threads_per_warp * kBytesPerLaneAccess;
+    gpu_metrics_.memory_bandwidth_utilization =
+        gpu_metrics_.simulated_time_ns > 0 && gpu_metrics_.peak_bandwidth_gbs > 0
+            ? memory_bytes / gpu_metrics_.simulated_time_ns / gpu_metrics_.peak_bandwidth_gbs * 100.0
+            : 0.0;
+    gpu_metrics_.total_workloads_executed = totals_.count;
+    gpu_metrics_.average_queue_wait_ns =
+        totals_.count > 0 ? device->cyclesToNs(totals_.queue_wait_cycles) / totals_.count : 0.0;
+    gpu_metrics_.p99_queue_wait_ns = device->cyclesToNs(queue_wait_cycles_.getPercentile(99.0));
+    gpu_metrics_.p99_service_time_ns = device->cyclesToNs(service_cycles_.getPercentile(99.0));
+    gpu_metrics_.mean_prediction_error_pct = getMeanPredictionError();
+
+    AdmissionStats admission = device->getAdmissionStats();
+    gpu_metrics_.workloads_admitted = admission.admitted;
+    gpu_metrics_.workloads_rejected = admission.rejected;
+    gpu_metrics_.average_admission_wait_ms = admission.average_wait_ms;
+    gpu_metrics_.max_admission_wait_ms = admission.max_wait_ms;
+
+    // Memory accesses are timed inside execution; keep the phases exclusive
+    PhaseTimes phases = device->getPhaseTimes();
+    uint64_t memory_ns = std::min(phases.get(SimPhase::MEMORY_MODEL), phases.get(SimPhase::EXECUTION));
+    phases.ns[static_cast<size_t>(SimPhase::EXECUTION)] -= memory_ns;
+    phases.ns[static_cast<size_t>(SimPhase::MEMORY_MODEL)] = memory_ns;
+    for (size_t i = 0; i < NUM_SIM_PHASES; ++i) {
+        gpu_metrics_.phase_time_ms[i] = phases.ns[i] / 1e6;
+    }
+
+    double host_ms = gpu_metrics_.total_execution_time_ms;
+    gpu_metrics_.simulated_mips = host_ms > 0 ? gpu_metrics_.total_instructions / (host_ms * 1000.0) : 0.0;
+    gpu_metrics_.simulated_cycles_per_host_second =
+        host_ms > 0 ? gpu_metrics_.simulated_cycles / (host_ms / 1000.0) : 0.0;
+    gpu_metrics_.peak_rss_bytes = getPeakRSSBytes();
+
+    // CU-cycles workloads could keep busy over the CU-cycles of the run
+    double available_cu_cycles = static_cast<double>(gpu_metrics_.simulated_cycles) * device->getNumComputeUnits();
+    gpu_metrics_.cu_allocation_utilization = available_cu_cycles > 0
+        ? std::min(100.0, totals_.reserved_cu_cycles / available_cu_cycles * 100.0) : 0.0;
 }
 
 void PerformanceAnalyzer::startSimulation() {
@@ -83,49 +213,41 @@ void PerformanceAnalyzer::endSimulation() {
 }
 
 double PerformanceAnalyzer::getTotalSimulationTime() const {
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-        sim_end_time_ - sim_start_time_);
+    std::chrono::duration<double, std::milli> duration = sim_end_time_ - sim_start_time_;
     return duration.count();
 }
 
 double PerformanceAnalyzer::getAverageThroughput() const {
-    if (workload_metrics_.empty()) return 0.0;
-
-    double total_throughput = 0.0;
-    for (const auto& metrics : workload_metrics_) {
-        total_throughput += metrics.throughput;
-    }
+    if (totals_.count == 0) return 0.0;
+    return totals_.throughput / totals_.count;
+}
 
-    return total_throughput / workload_metrics_.size();
+double PerformanceAnalyzer::getSimulatedIPC() const {
+    if (gpu_metrics_.simulated_cycles == 0) return 0.0;
+    return static_cast<double>(gpu_metrics_.total_instructions) / gpu_metrics_.simulated_cycles;
 }
 
 double PerformanceAnalyzer::getAverageWorkloadTime() const {
-    if (workload_metrics_.empty()) return 0.0;
+    if (totals_.count == 0) return 0.0;
+    return totals_.execution_time_ms / totals_.count;
+}
 
-    double total_time = 0.0;
-    for (const auto& metrics : workload_metrics_) {
-        total_time += metrics.execution_time_ms;
-    }
+double PerformanceAnalyzer::getAverageQueueWaitTime() const {
+    if (totals_.count == 0) return 0.0;
+    return totals_.queue_wait_ms / totals_.count;
+}
 
-    return total_time / workload_metrics_.size();
+double PerformanceAnalyzer::getMeanPredictionError() const {
+    if (totals_.count == 0) return 0.0;
+    return totals_.prediction_error_pct / totals_.count;
 }
 
 WorkloadMetrics PerformanceAnalyzer::getFastestWorkload() const {
-    if (workload_metrics_.empty()) return WorkloadMetrics{};
-
-    return *std::min_element(workload_metrics_.begin(), workload_metrics_.end(),
-        [](const WorkloadMetrics& a, const WorkloadMetrics& b) {
-            return a.execution_time_ms < b.execution_time_ms;
-        });
+    return totals_.count ? totals_.fastest : WorkloadMetrics{};
 }
 
 WorkloadMetrics PerformanceAnalyzer::getSlowestWorkload() const {
-    if (workload_metrics_.empty()) return WorkloadMetrics{};
-
-    return *std::max_element(workload_metrics_.begin(), workload_metrics_.end(),
-        [](const WorkloadMetrics& a, const WorkloadMetrics& b) {
-            return a.execution_time_ms < b.execution_time_ms;
-        });
+    return totals_.count ? totals_.slowest : WorkloadMetrics{};
 }
 
 void PerformanceAnalyzer::printSummary() const {
@@ -133,15 +255,61 @@ void PerformanceAnalyzer::printSummary() const {
     std::cout << "      PERFORMANCE SUMMARY\n";
     std::cout << "========================================\n\n";
 
-    std::cout << "Total Simulation Time: " << std::fixed << std::setprecision(2)
-              << gpu_metrics_.total_execution_time_ms << " ms\n";
+    std::cout << "Simulated Time: " << std::fixed << std::setprecision(3)
+              << gpu_metrics_.simulated_time_ns / 1e6 << " ms ("
+              << gpu_metrics_.simulated_cycles << " cycles at "
+              << std::setprecision(0) << gpu_metrics_.core_clock_mhz << " MHz)\n";
+    std::cout << "Host Wall Time: " << std::fixed << std::setprecision(2)
+              << gpu_metrics_.total_execution_time_ms << " ms (simulator cost)\n";
     std::cout << "Workloads Executed: " << gpu_metrics_.total_workloads_executed << "\n";
+    std::cout << "Workloads Admitted/Rejected: " << gpu_metrics_.workloads_admitted
+              << "/" << gpu_metrics_.workloads_rejected << "\n";
+    std::cout << "Admission Wait: " << std::fixed << std::setprecision(2)
+              << gpu_metrics_.average_admission_wait_ms << " ms avg, "
+              << gpu_metrics_.max_admission_wait_ms << " ms max\n";
     std::cout << "Total Instructions: " << gpu_metrics_.total_instructions << "\n";
     std::cout << "Total Memory Operations: " << gpu_metrics_.total_memory_ops << "\n";
     std::cout << "Average GPU Utilization: " << std::fixed << std::setprecision(2)
               << gpu_metrics_.average_utilization << "%\n";
+    std::cout << "CU Allocation Utilization: " << std::fixed << std::setprecision(2)
+              << gpu_metrics_.cu_allocation_utilization << "%\n";
+    std::cout << "Memory Bandwidth Utilization: " << std::fixed << std::setprecision(2)
+              << gpu_metrics_.memory_bandwidth_utilization << "% of "
+              << gpu_metrics_.peak_bandwidth_gbs << " GB/s\n";
+    std::cout << "Energy: " << std::fixed << std::setprecision(3) << gpu_metrics_.energy_j * 1e3
+              << " mJ (" << gpu_metrics_.static_energy_j * 1e3 << " mJ static), Average Power: "
+              << std::setprecision(2) << gpu_metrics_.average_power_w << " W, "
+              << gpu_metrics_.gflops_per_watt << " GFLOPS/W\n";
+    std::cout << "Average Queue Wait: " << std::fixed << std::setprecision(2)
+              << gpu_metrics_.average_queue_wait_ns / 1000.0 << " us (p99 "
+              << gpu_metrics_.p99_queue_wait_ns / 1000.0 << " us)\n";
+    std::cout << "P99 Service Time: " << std::fixed << std::setprecision(2)
+              << gpu_metrics_.p99_service_time_ns / 1000.0 << " us\n";
+    std::cout << "Mean Runtime Prediction Error: " << std::fixed << std::setprecision(2)
+              << gpu_metrics_.mean_prediction_error_pct << "%\n";
+    std::cout << "Simulated IPC: " << std::fixed << std::setprecision(2)
+              << getSimulatedIPC() << " instr/cycle\n";
     std::cout << "Average Throughput: " << std::fixed << std::setprecision(2)
-              << getAverageThroughput() << " instr/ms\n";
+              << getAverageThroughput() << " instr/us\n";
+
+    std::cout << "\nSimulator Performance:\n";
+    std::cout << "  Simulated MIPS: " << std::fixed << std::setprecision(2)
+              << gpu_metrics_.simulated_mips << "\n";
+    std::cout << "  Simulated Cycles/Host Second: " << std::fixed << std::setprecision(0)
+              << gpu_metrics_.simulated_cycles_per_host_second << "\n";
+    std::cout << "  Peak RSS: " << std::fixed << std::setprecision(1)
+              << gpu_metrics_.peak_rss_bytes / (1024.0 * 1024.0) << " MB\n";
+
+    double phase_total = std::accumulate(gpu_metrics_.phase_time_ms.begin(),
+                                         gpu_metrics_.phase_time_ms.end(), 0.0);
+    std::cout << "  Host Thread Time by Phase:\n";
+    for (size_t i = 0; i < NUM_SIM_PHASES; ++i) {
+        double share = phase_total > 0 ? gpu_metrics_.phase_time_ms[i] / phase_total * 100.0 : 0.0;
+        std::cout << "    " << std::left << std::setw(14) << simPhaseName(static_cast<SimPhase>(i))
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << gpu_metrics_.phase_time_ms[i] << " ms"
+                  << std::setw(8) << std::setprecision(1) << share << "%\n";
+    }
 
     std::cout << "\n========================================\n\n";
 }
@@ -154,57 +322,505 @@ void PerformanceAnalyzer::printDetailedReport() const {
 
     for (const auto& metrics : workload_metrics_) {
         std::cout << "\nWorkload: " << metrics.workload_name << "\n";
-        std::cout << "  Execution Time: " << std::fixed << std::setprecision(2)
-                  << metrics.execution_time_ms << " ms\n";
+        std::cout << "  Simulated Time: " << std::fixed << std::setprecision(2)
+                  << metrics.simulated_time_ns / 1000.0 << " us ("
+                  << metrics.simulated_cycles << " cycles)\n";
+        std::cout << "  Simulated Queue Wait: " << std::fixed << std::setprecision(2)
+                  << metrics.simulated_queue_wait_ns / 1000.0 << " us ("
+                  << metrics.queue_wait_cycles << " cycles)\n";
+        std::cout << "  Host Time: " << std::fixed << std::setprecision(2)
+                  << metrics.execution_time_ms << " ms (queue wait "
+                  << metrics.queue_wait_ms << " ms)\n";
+        std::cout << "  Predicted Time: " << std::fixed << std::setprecision(2)
+                  << metrics.predicted_time_ns / 1000.0 << " us (error "
+                  << metrics.prediction_error_pct << "%)\n";
         std::cout << "  Instructions: " << metrics.instructions_executed << "\n";
         std::cout << "  Memory Ops: " << metrics.memory_operations << "\n";
+        std::cout << "  Cycles: " << metrics.cycles_executed << "\n";
         std::cout << "  Threads: " << metrics.total_threads << "\n";
         std::cout << "  Blocks: " << metrics.total_blocks << "\n";
+        std::cout << "  Compute Units: " << metrics.compute_units_allocated << "\n";
+        if (!metrics.co_runner.empty()) {
+            std::cout << "  Co-scheduled With: " << metrics.co_runner << "\n";
+        }
         std::cout << "  Avg CU Utilization: " << std::fixed << std::setprecision(2)
                   << metrics.average_cu_utilization << "%\n";
         std::cout << "  Throughput: " << std::fixed << std::setprecision(2)
-                  << metrics.throughput << " instr/ms\n";
+                  << metrics.throughput << " instr/us\n";
     }
 
     std::cout << "\n========================================\n";
 }
 
-void PerformanceAnalyzer::exportToCSV(const std::string& filename) const {
+bool PerformanceAnalyzer::exportToCSV(const std::string& filename) const {
     std::ofstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Failed to open file: " << filename << "\n";
-        return;
+        return false;
     }
 
     // Header
-    file << "Workload,Type,Execution_Time_ms,Instructions,Memory_Ops,Threads,Blocks,Utilization_%,Throughput_instr_ms\n";
+    file << "Workload,Type,Sim_Cycles,Sim_Time_ns,Sim_Queue_Wait_Cycles,Execution_Time_ms,Queue_Wait_ms,Predicted_Time_ns,Prediction_Error_%,Instructions,Memory_Ops,Threads,Blocks,Compute_Units,Co_Runner,Utilization_%,Throughput_instr_us\n";
 
     // Data
     for (const auto& metrics : workload_metrics_) {
         file << metrics.workload_name << ","
              << static_cast<int>(metrics.type) << ","
+             << metrics.simulated_cycles << ","
+             << metrics.simulated_time_ns << ","
+             << metrics.queue_wait_cycles << ","
              << metrics.execution_time_ms << ","
+             << metrics.queue_wait_ms << ","
+             << metrics.predicted_time_ns << ","
+             << metrics.prediction_error_pct << ","
              << metrics.instructions_executed << ","
              << metrics.memory_operations << ","
              << metrics.total_threads << ","
              << metrics.total_blocks << ","
+             << metrics.compute_units_allocated << ","
+             << metrics.co_runner << ","
              << metrics.average_cu_utilization << ","
              << metrics.throughput << "\n";
     }
 
     file.close();
     std::cout << "Metrics exported to " << filename << "\n";
+    return true;
+}
+
+bool PerformanceAnalyzer::exportToColumnar(const std::string& filename) const {
+    ColumnarWriter writer(filename, {
+        {"workload", ColumnType::DICT},
+        {"type", ColumnType::U32},
+        {"sim_cycles", ColumnType::U64},
+        {"sim_time_ns", ColumnType::F64},
+        {"sim_queue_wait_cycles", ColumnType::U64},
+        {"execution_time_ms", ColumnType::F64},
+        {"queue_wait_ms", ColumnType::F64},
+        {"predicted_time_ns", ColumnType::F64},
+        {"instructions", ColumnType::U64},
+        {"memory_ops", ColumnType::U64},
+        {"threads", ColumnType::U64},
+        {"blocks", ColumnType::U64},
+        {"compute_units", ColumnType::U32},
+        {"co_runner", ColumnType::DICT},
+        {"utilization_pct", ColumnType::F64},
+        {"throughput_instr_us", ColumnType::F64}});
+    if (!writer.open()) return false;
+
+    for (const auto& metrics : workload_metrics_) {
+        writer.setString(0, metrics.workload_name);
+        writer.setU32(1, static_cast<uint32_t>(metrics.type));
+        writer.setU64(2, metrics.simulated_cycles);
+        writer.setF64(3, metrics.simulated_time_ns);
+        writer.setU64(4, metrics.queue_wait_cycles);
+        writer.setF64(5, metrics.execution_time_ms);
+        writer.setF64(6, metrics.queue_wait_ms);
+        writer.setF64(7, metrics.predicted_time_ns);
+        writer.setU64(8, metrics.instructions_executed);
+        writer.setU64(9, metrics.memory_operations);
+        writer.setU64(10, metrics.total_threads);
+        writer.setU64(11, metrics.total_blocks);
+        writer.setU32(12, static_cast<uint32_t>(metrics.compute_units_allocated));
+        writer.setString(13, metrics.co_runner);
+        writer.setF64(14, metrics.average_cu_utilization);
+        writer.setF64(15, metrics.throughput);
+        writer.endRow();
+    }
+
+    if (!writer.close()) return false;
+    std::cout << "Metrics exported to " << filename << "\n";
+    return true;
+}
+
+bool PerformanceAnalyzer::exportSimulatorPerformance(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << "\n";
+        return false;
+    }
+
+    file << "Metric,Value\n";
+    file << "Host_Wall_Time_ms," << gpu_metrics_.total_execution_time_ms << "\n";
+    file << "Simulated_Cycles," << gpu_metrics_.simulated_cycles << "\n";
+    file << "Simulated_Instructions," << gpu_metrics_.total_instructions << "\n";
+    file << "Simulated_MIPS," << gpu_metrics_.simulated_mips << "\n";
+    file << "Simulated_Cycles_per_Host_Second," << gpu_metrics_.simulated_cycles_per_host_second << "\n";
+    file << "Peak_RSS_Bytes," << gpu_metrics_.peak_rss_bytes << "\n";
+    for (size_t i = 0; i < NUM_SIM_PHASES; ++i) {
+        std::string name = simPhaseName(static_cast<SimPhase>(i));
+        std::replace(name.begin(), name.end(), ' ', '_');
+        file << "Phase_" << name << "_ms," << gpu_metrics_.phase_time_ms[i] << "\n";
+    }
+
+    file.close();
+    std::cout << "Simulator performance exported to " << filename << "\n";
+    return true;
+}
+
+void PerformanceAnalyzer::printInterferenceReport(const PerformanceAnalyzer& isolated) const {
+    std::cout << "\n========================================\n";
+    std::cout << "   INTERFERENCE REPORT\n";
+    std::cout << "========================================\n\n";
+
+    std::cout << std::left << std::setw(32) << "Workload"
+              << std::setw(14) << "Isolated(us)"
+              << std::setw(14) << "Shared(us)"
+              << std::setw(12) << "Slowdown"
+              << "Co-Runner\n";
+    std::cout << "----------------------------------------\n";
+
+    // Match workloads by name, consuming baseline entries so repeated
+    // kernels pair up in submission order
+    std::vector<bool> used(isolated.workload_metrics_.size(), false);
+    double isolated_total = 0.0;
+
+    for (const auto& metrics : workload_metrics_) {
+        const WorkloadMetrics* baseline = nullptr;
+        for (size_t i = 0; i < isolated.workload_metrics_.size(); ++i) {
+            if (!used[i] && isolated.workload_metrics_[i].workload_name == metrics.workload_name) {
+                used[i] = true;
+                baseline = &isolated.workload_metrics_[i];
+                break;
+            }
+        }
+        if (!baseline) continue;
+
+        // Simulated time, so the comparison does not depend on host load
+        isolated_total += baseline->simulated_time_ns;
+        double slowdown = baseline->simulated_time_ns > 0
+            ? metrics.simulated_time_ns / baseline->simulated_time_ns : 0.0;
+
+        std::cout << std::left << std::setw(32) << metrics.workload_name
+                  << std::setw(14) << std::fixed << std::setprecision(2) << baseline->simulated_time_ns / 1000.0
+                  << std::setw(14) << std::fixed << std::setprecision(2) << metrics.simulated_time_ns / 1000.0
+                  << std::setw(12) << std::fixed << std::setprecision(2) << slowdown
+                  << (metrics.co_runner.empty() ? "-" : metrics.co_runner) << "\n";
+    }
+
+    std::cout << "\nSerial Isolated Time: " << std::fixed << std::setprecision(2)
+              << isolated_total / 1000.0 << " us\n";
+    std::cout << "Co-Scheduled Makespan: " << std::fixed << std::setprecision(2)
+              << gpu_metrics_.simulated_time_ns / 1000.0 << " us\n";
+    std::cout << "========================================\n\n";
+}
+
+void PerformanceAnalyzer::printLatencyReport() const {
+    std::cout << "\n=== Latency Distributions ===\n";
+    // Simulated microseconds: cycles / MHz
+    double us_per_cycle = gpu_metrics_.core_clock_mhz > 0 ? 1.0 / gpu_metrics_.core_clock_mhz : 0.0;
+    queue_wait_cycles_.print("Queue Wait", "us", us_per_cycle);
+    service_cycles_.print("Service Time", "us", us_per_cycle);
+    block_residency_cycles_.print("Block Residency", "cycles");
+    warp_stall_cycles_.print("Warp Stall", "cycles");
+}
+
+// One row of a stall table: each reason as a share of the row's stall cycles
+static void printStallRow(const std::string& label, const StallBreakdown& stalls) {
+    uint64_t total = std::accumulate(stalls.begin(), stalls.end(), uint64_t{0});
+    std::cout << std::left << std::setw(25) << label << std::right;
+    for (uint64_t cycles : stalls) {
+        double pct = total > 0 ? static_cast<double>(cycles) / total * 100.0 : 0.0;
+        std::cout << std::setw(9) << std::fixed << std::setprecision(1) << pct;
+    }
+    std::cout << std::setw(14) << total << "\n";
+}
+
+void PerformanceAnalyzer::printStallReport() const {
+    static const char* kShortNames[NUM_STALL_REASONS] = {
+        "MemDep", "ExecDep", "Barrier", "Struct", "IFetch", "NotSel", "Idle"};
+
+    std::cout << "\n=== Warp Stall Reasons (% of stall cycles) ===\n";
+    std::cout << std::left << std::setw(25) << "Source" << std::right;
+    for (const char* name : kShortNames) {
+        std::cout << std::setw(9) << name;
+    }
+    std::cout << std::setw(14) << "Stall Cycles" << "\n";
+    std::cout << std::string(25 + 9 * NUM_STALL_REASONS + 14, '-') << "\n";
+
+    StallBreakdown workload_total{};
+    for (const auto& metrics : workload_metrics_) {
+        printStallRow(metrics.workload_name, metrics.stall_cycles);
+        for (size_t r = 0; r < NUM_STALL_REASONS; ++r) {
+            workload_total[r] += metrics.stall_cycles[r];
+        }
+    }
+    printStallRow("All Workloads", workload_total);
+
+    std::cout << std::string(25 + 9 * NUM_STALL_REASONS + 14, '-') << "\n";
+    for (size_t i = 0; i < cu_stall_cycles_.size(); ++i) {
+        printStallRow("CU " + std::to_string(i), cu_stall_cycles_[i]);
+    }
+
+    // Largest warp-side reason overall, the first thing to look at
+    auto top = std::max_element(workload_total.begin(), workload_total.end());
+    if (*top > 0) {
+        std::cout << "Dominant reason: "
+                  << stallReasonName(static_cast<StallReason>(top - workload_total.begin())) << "\n";
+    }
+}
+
+void PerformanceAnalyzer::printEnergyReport() const {
+    std::cout << "\n=== Energy (simulated time) ===\n";
+    std::cout << std::left << std::setw(32) << "Workload" << std::right
+              << std::setw(10) << "Compute"
+              << std::setw(10) << "RegFile"
+              << std::setw(10) << "Shared"
+              << std::setw(10) << "L1/L2"
+              << std::setw(10) << "DRAM"
+              << std::setw(10) << "Static"
+              << std::setw(12) << "Total(uJ)"
+              << std::setw(10) << "Power(W)"
+              << std::setw(10) << "GFLOPS/W"
+              << "\n";
+    std::cout << std::string(124, '-') << "\n";
+
+    auto share = [](double part, double total) { return total > 0 ? part / total * 100.0 : 0.0; };
+    for (const auto& metrics : workload_metrics_) {
+        const EnergyBreakdown& energy = metrics.energy;
+        double total = energy.totalJoules();
+        std::cout << std::left << std::setw(32) << metrics.workload_name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(9) << share(energy.compute_j, total) << "%"
+                  << std::setw(9) << share(energy.register_file_j, total) << "%"
+                  << std::setw(9) << share(energy.shared_memory_j, total) << "%"
+                  << std::setw(9) << share(energy.cache_j, total) << "%"
+                  << std::setw(9) << share(energy.dram_j, total) << "%"
+                  << std::setw(9) << share(energy.static_j, total) << "%"
+                  << std::setw(12) << total * 1e6
+                  << std::setprecision(2)
+                  << std::setw(10) << metrics.average_power_w
+                  << std::setw(10) << metrics.gflops_per_watt
+                  << "\n";
+    }
+
+    std::cout << "Device: " << std::fixed << std::setprecision(3) << gpu_metrics_.energy_j * 1e3
+              << " mJ, " << std::setprecision(2) << gpu_metrics_.average_power_w << " W average, "
+              << gpu_metrics_.gflops_per_watt << " GFLOPS/W\n";
+}
+
+RooflineModel PerformanceAnalyzer::getRooflineModel() const {
+    return RooflineModel{gpu_metrics_.peak_gflops, gpu_metrics_.peak_bandwidth_gbs};
+}
+
+RooflineModel PerformanceAnalyzer::getRooflineModel(const WorkloadMetrics& metrics) const {
+    size_t total = gpu_metrics_.num_compute_units;
+    if (total == 0 || metrics.compute_units_allocated == 0) return getRooflineModel();
+    double share = static_cast<double>(std::min(metrics.compute_units_allocated, total)) / total;
+    return getRooflineModel().scaled(share);
+}
+
+std::vector<RooflinePoint> PerformanceAnalyzer::getRooflinePoints() const {
+    std::vector<RooflinePoint> points;
+    points.reserve(workload_metrics_.size());
+    for (const auto& metrics : workload_metrics_) {
+        points.push_back(getRooflineModel(metrics).place(metrics.workload_name, metrics.flops, metrics.memory_bytes,
+                                     metrics.simulated_time_ns));
+    }
+    return points;
+}
+
+void PerformanceAnalyzer::printRooflineReport() const {
+    RooflineModel model = getRooflineModel();
+
+    std::cout << "\n=== Roofline (simulated time) ===\n";
+    std::cout << "Peak Compute: " << std::fixed << std::setprecision(0) << model.peak_gflops
+              << " GFLOP/s, Peak Bandwidth: " << model.peak_bandwidth_gbs << " GB/s, Ridge: "
+              << std::setprecision(2) << model.ridgeIntensity() << " FLOP/B\n";
+    std::cout << std::left << std::setw(32) << "Workload" << std::right
+              << std::setw(10) << "FLOP/B"
+              << std::setw(12) << "GFLOP/s"
+              << std::setw(10) << "GB/s"
+              << std::setw(12) << "Roof"
+              << std::setw(10) << "% Roof"
+              << "  Bound\n";
+    std::cout << std::string(94, '-') << "\n";
+
+    for (const auto& point : getRooflinePoints()) {
+        std::cout << std::left << std::setw(32) << point.workload_name << std::right
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(10) << point.intensity
+                  << std::setw(12) << point.achieved_gflops
+                  << std::setw(10) << point.achieved_bandwidth_gbs
+                  << std::setw(12) << point.attainable_gflops
+                  << std::setw(10) << point.roof_pct
+                  << "  " << (point.memory_bound ? "memory" : "compute") << "\n";
+    }
+}
+
+bool PerformanceAnalyzer::exportRooflineCSV(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << "\n";
+        return false;
+    }
+
+    file << "Workload,FLOPs,Memory_Bytes,Sim_Time_ns,Intensity_FLOP_per_B,Achieved_GFLOPs,Achieved_GBs,"
+            "Attainable_GFLOPs,Roof_%,Bound,Peak_GFLOPs,Peak_GBs\n";
+    for (const auto& metrics : workload_metrics_) {
+        RooflineModel model = getRooflineModel(metrics);
+        RooflinePoint point = model.place(metrics.workload_name, metrics.flops, metrics.memory_bytes,
+                                          metrics.simulated_time_ns);
+        file << metrics.workload_name << ","
+             << metrics.flops << ","
+             << metrics.memory_bytes << ","
+             << metrics.simulated_time_ns << ","
+             << point.intensity << ","
+             << point.achieved_gflops << ","
+             << point.achieved_bandwidth_gbs << ","
+             << point.attainable_gflops << ","
+             << point.roof_pct << ","
+             << (point.memory_bound ? "memory" : "compute") << ","
+             << model.peak_gflops << ","
+             << model.peak_bandwidth_gbs << "\n";
+    }
+
+    file.close();
+    std::cout << "Roofline data exported to " << filename << "\n";
+    return true;
+}
+
+bool PerformanceAnalyzer::exportRooflineSVG(const std::string& filename) const {
+    if (!writeRooflineSVG(filename, getRooflineModel(), getRooflinePoints(), "Roofline")) {
+        return false;
+    }
+    std::cout << "Roofline chart exported to " << filename << "\n";
+    return true;
+}
+
+bool PerformanceAnalyzer::exportHistograms(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << "\n";
+        return false;
+    }
+
+    queue_wait_cycles_.serialize(file);
+    service_cycles_.serialize(file);
+    block_residency_cycles_.serialize(file);
+    warp_stall_cycles_.serialize(file);
+    return true;
+}
+
+bool PerformanceAnalyzer::mergeHistograms(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << "\n";
+        return false;
+    }
+
+    LatencyHistogram loaded[4];
+    for (auto& histogram : loaded) {
+        if (!histogram.deserialize(file)) {
+            std::cerr << "Failed to read histograms from " << filename << "\n";
+            return false;
+        }
+    }
+
+    return queue_wait_cycles_.merge(loaded[0]) &&
+           service_cycles_.merge(loaded[1]) &&
+           block_residency_cycles_.merge(loaded[2]) &&
+           warp_stall_cycles_.merge(loaded[3]);
 }
 
 void PerformanceAnalyzer::reset() {
     workload_metrics_.clear();
+    totals_ = WorkloadTotals{};
     gpu_metrics_ = GPUMetrics{};
+    queue_wait_cycles_.reset();
+    service_cycles_.reset();
+    block_residency_cycles_.reset();
+    warp_stall_cycles_.reset();
+    cu_stall_cycles_.clear();
+}
+
+double computePercentile(std::vector<double> samples, double percentile) {
+    if (samples.empty()) return 0.0;
+
+    percentile = std::min(100.0, std::max(0.0, percentile));
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * samples.size()));
+    size_t index = rank > 0 ? rank - 1 : 0;
+
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
 }
 
 // SchedulerComparison implementation
 void SchedulerComparison::addAnalyzer(const std::string& scheduler_name,
-                                      std::unique_ptr<PerformanceAnalyzer> analyzer) {
-    analyzer_map_[scheduler_name] = std::move(analyzer);
+                                      std::unique_ptr<PerformanceAnalyzer> analyzer,
+                                      uint64_t seed) {
+    replica_map_[scheduler_name].push_back(Replica{seed, std::move(analyzer)});
+}
+
+bool SchedulerComparison::runReplicas(const std::string& scheduler_name, const ReplicaRunner& runner,
+                                      size_t replicas, uint64_t base_seed, size_t max_parallel) {
+    if (max_parallel == 0) {
+        max_parallel = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Workers claim replica indices until all are taken; each result, log
+    // and error lands in its own slot so the order matches the seeds
+    std::vector<std::unique_ptr<PerformanceAnalyzer>> results(replicas);
+    std::vector<std::ostringstream> logs(replicas);
+    std::vector<std::string> errors(replicas);
+    std::atomic<size_t> next_replica{0};
+    auto worker = [&]() {
+        for (size_t index = next_replica++; index < replicas; index = next_replica++) {
+            try {
+                results[index] = runner(base_seed + index, logs[index]);
+            } catch (const std::exception& e) {
+                errors[index] = e.what();
+            } catch (...) {
+                errors[index] = "unknown exception";
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < std::min(max_parallel, replicas); ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    bool all_ok = true;
+    for (size_t index = 0; index < replicas; ++index) {
+        std::cout << logs[index].str();
+        if (results[index]) {
+            addAnalyzer(scheduler_name, std::move(results[index]), base_seed + index);
+            continue;
+        }
+        all_ok = false;
+        std::cerr << scheduler_name << " replica with seed " << base_seed + index << " failed: "
+                  << (errors[index].empty() ? "no metrics returned" : errors[index]) << "\n";
+    }
+    return all_ok;
+}
+
+double SchedulerComparison::meanOf(const std::vector<Replica>& replicas,
+                                   const std::function<double(const PerformanceAnalyzer&)>& field) const {
+    if (replicas.empty()) return 0.0;
+    double sum = 0.0;
+    for (const auto& replica : replicas) {
+        sum += field(*replica.analyzer);
+    }
+    return sum / replicas.size();
+}
+
+std::vector<SchedulerComparison::SchedulerStats> SchedulerComparison::getStatistics() const {
+    std::vector<SchedulerStats> stats;
+    for (const auto& [name, replicas] : replica_map_) {
+        std::vector<double> simulated_ms;
+        std::vector<double> host_ms;
+        for (const auto& replica : replicas) {
+            const auto& metrics = replica.analyzer->getGPUMetrics();
+            simulated_ms.push_back(metrics.simulated_time_ns / 1e6);
+            host_ms.push_back(metrics.total_execution_time_ms);
+        }
+        stats.push_back(SchedulerStats{name, summarizeSamples(simulated_ms), summarizeSamples(host_ms)});
+    }
+    return stats;
 }
 
 void SchedulerComparison::printComparison() const {
@@ -212,64 +828,159 @@ void SchedulerComparison::printComparison() const {
     std::cout << "   SCHEDULER COMPARISON\n";
     std::cout << "========================================\n\n";
 
+    // Means over each scheduler's replicas
     std::cout << std::left << std::setw(20) << "Scheduler"
-              << std::setw(15) << "Total Time(ms)"
+              << std::setw(15) << "Sim Time(ms)"
+              << std::setw(15) << "Host Time(ms)"
               << std::setw(15) << "Avg Util(%)"
-              << std::setw(15) << "Throughput"
+              << std::setw(15) << "CU Alloc(%)"
+              << std::setw(15) << "Queue Wait(us)"
+              << std::setw(15) << "P99 Wait(us)"
+              << std::setw(15) << "Instr/us"
+              << std::setw(15) << "Energy(mJ)"
+              << std::setw(15) << "GFLOPS/W"
               << "\n";
     std::cout << "----------------------------------------\n";
 
-    for (const auto& [name, analyzer] : analyzer_map_) {
-        const auto& metrics = analyzer->getGPUMetrics();
+    for (const auto& [name, replicas] : replica_map_) {
+        auto mean = [&](auto field) {
+            return meanOf(replicas, [&](const PerformanceAnalyzer& analyzer) {
+                return static_cast<double>(field(analyzer.getGPUMetrics()));
+            });
+        };
+        double throughput = meanOf(replicas, [](const PerformanceAnalyzer& analyzer) {
+            return analyzer.getAverageThroughput();
+        });
         std::cout << std::left << std::setw(20) << name
-                  << std::setw(15) << std::fixed << std::setprecision(2) << metrics.total_execution_time_ms
-                  << std::setw(15) << std::fixed << std::setprecision(2) << metrics.average_utilization
-                  << std::setw(15) << std::fixed << std::setprecision(2) << analyzer->getAverageThroughput()
+                  << std::setw(15) << std::fixed << std::setprecision(3)
+                  << mean([](const GPUMetrics& m) { return m.simulated_time_ns / 1e6; })
+                  << std::setw(15) << std::fixed << std::setprecision(2)
+                  << mean([](const GPUMetrics& m) { return m.total_execution_time_ms; })
+                  << std::setw(15) << std::fixed << std::setprecision(2)
+                  << mean([](const GPUMetrics& m) { return m.average_utilization; })
+                  << std::setw(15) << std::fixed << std::setprecision(2)
+                  << mean([](const GPUMetrics& m) { return m.cu_allocation_utilization; })
+                  << std::setw(15) << std::fixed << std::setprecision(2)
+                  << mean([](const GPUMetrics& m) { return m.average_queue_wait_ns / 1000.0; })
+                  << std::setw(15) << std::fixed << std::setprecision(2)
+                  << mean([](const GPUMetrics& m) { return m.p99_queue_wait_ns / 1000.0; })
+                  << std::setw(15) << std::fixed << std::setprecision(2) << throughput
+                  << std::setw(15) << std::fixed << std::setprecision(3)
+                  << mean([](const GPUMetrics& m) { return m.energy_j * 1e3; })
+                  << std::setw(15) << std::fixed << std::setprecision(2)
+                  << mean([](const GPUMetrics& m) { return m.gflops_per_watt; })
+                  << "\n";
+    }
+
+    std::cout << "\nSimulated time over replicas (95% CI of the mean):\n";
+    std::cout << std::left << std::setw(20) << "Scheduler" << std::right
+              << std::setw(10) << "Replicas"
+              << std::setw(14) << "Mean(ms)"
+              << std::setw(14) << "StdDev(ms)"
+              << std::setw(26) << "95% CI(ms)"
+              << std::setw(16) << "Host Mean(ms)"
+              << "\n";
+    std::cout << "----------------------------------------\n";
+
+    for (const auto& stats : getStatistics()) {
+        std::ostringstream interval;
+        interval << std::fixed << std::setprecision(3) << "[" << stats.simulated_time_ms.ci95_low
+                 << ", " << stats.simulated_time_ms.ci95_high << "]";
+        std::cout << std::left << std::setw(20) << stats.scheduler_name << std::right
+                  << std::setw(10) << stats.simulated_time_ms.count
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(14) << stats.simulated_time_ms.mean
+                  << std::setw(14) << stats.simulated_time_ms.stddev
+                  << std::setw(26) << interval.str()
+                  << std::setprecision(2)
+                  << std::setw(16) << stats.host_time_ms.mean
                   << "\n";
     }
+    std::cout << std::left;
 
-    std::cout << "\nBest Scheduler: " << getBestScheduler() << "\n";
+    std::string best = getBestScheduler();
+    if (best != "None") {
+        std::cout << "\nBest Scheduler: " << best << " (significantly faster than every other, p < 0.05)\n";
+    } else {
+        // Say which pair could not be separated
+        auto stats = getStatistics();
+        std::sort(stats.begin(), stats.end(), [](const SchedulerStats& a, const SchedulerStats& b) {
+            return a.simulated_time_ms.mean < b.simulated_time_ms.mean;
+        });
+        std::cout << "\nBest Scheduler: None";
+        if (stats.size() >= 2) {
+            if (stats[0].simulated_time_ms.count < 2 || stats[1].simulated_time_ms.count < 2) {
+                std::cout << " (needs at least 2 replicas per scheduler to test; fastest mean: "
+                          << stats[0].scheduler_name << ")";
+            } else {
+                WelchTest test = welchTest(stats[0].simulated_time_ms, stats[1].simulated_time_ms);
+                std::cout << " (" << stats[0].scheduler_name << " vs " << stats[1].scheduler_name
+                          << " not significant: t = " << std::fixed << std::setprecision(2) << test.t
+                          << ", df = " << std::setprecision(1) << test.degrees_of_freedom << ")";
+            }
+        }
+        std::cout << "\n";
+    }
     std::cout << "========================================\n\n";
 }
 
-void SchedulerComparison::exportComparisonCSV(const std::string& filename) const {
+bool SchedulerComparison::exportComparisonCSV(const std::string& filename) const {
     std::ofstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Failed to open file: " << filename << "\n";
-        return;
+        return false;
     }
 
-    file << "Scheduler,Total_Time_ms,Avg_Utilization_%,Avg_Throughput,Total_Instructions,Total_Memory_Ops\n";
-
-    for (const auto& [name, analyzer] : analyzer_map_) {
-        const auto& metrics = analyzer->getGPUMetrics();
-        file << name << ","
-             << metrics.total_execution_time_ms << ","
-             << metrics.average_utilization << ","
-             << analyzer->getAverageThroughput() << ","
-             << metrics.total_instructions << ","
-             << metrics.total_memory_ops << "\n";
+    file << "Scheduler,Replica,Seed,Sim_Cycles,Sim_Time_ns,Host_Time_ms,Avg_Utilization_%,CU_Allocation_%,Avg_Queue_Wait_ns,P99_Queue_Wait_ns,P99_Service_Time_ns,Avg_Throughput_instr_us,Total_Instructions,Total_Memory_Ops,Sim_MIPS,Sim_Cycles_per_Host_s,Peak_RSS_Bytes,Energy_J,Static_Energy_J,Avg_Power_W,GFLOPS_per_W\n";
+
+    for (const auto& [name, replicas] : replica_map_) {
+        for (size_t index = 0; index < replicas.size(); ++index) {
+            const auto& analyzer = replicas[index].analyzer;
+            const auto& metrics = analyzer->getGPUMetrics();
+            file << name << ","
+                 << index << ","
+                 << replicas[index].seed << ","
+                 << metrics.simulated_cycles << ","
+                 << metrics.simulated_time_ns << ","
+                 << metrics.total_execution_time_ms << ","
+                 << metrics.average_utilization << ","
+                 << metrics.cu_allocation_utilization << ","
+                 << metrics.average_queue_wait_ns << ","
+                 << metrics.p99_queue_wait_ns << ","
+                 << metrics.p99_service_time_ns << ","
+                 << analyzer->getAverageThroughput() << ","
+                 << metrics.total_instructions << ","
+                 << metrics.total_memory_ops << ","
+                 << metrics.simulated_mips << ","
+                 << metrics.simulated_cycles_per_host_second << ","
+                 << metrics.peak_rss_bytes << ","
+                 << metrics.energy_j << ","
+                 << metrics.static_energy_j << ","
+                 << metrics.average_power_w << ","
+                 << metrics.gflops_per_watt << "\n";
+        }
     }
 
     file.close();
     std::cout << "Comparison exported to " << filename << "\n";
+    return true;
 }
 
 std::string SchedulerComparison::getBestScheduler() const {
-    if (analyzer_map_.empty()) return "None";
+    auto stats = getStatistics();
+    if (stats.empty()) return "None";
 
-    std::string best_scheduler;
-    double best_time = std::numeric_limits<double>::max();
+    auto best = std::min_element(stats.begin(), stats.end(), [](const SchedulerStats& a, const SchedulerStats& b) {
+        return a.simulated_time_ms.mean < b.simulated_time_ms.mean;
+    });
+    if (best->simulated_time_ms.mean <= 0) return "None";
 
-    for (const auto& [name, analyzer] : analyzer_map_) {
-        double time = analyzer->getGPUMetrics().total_execution_time_ms;
-        if (time < best_time && time > 0) {
-            best_time = time;
-            best_scheduler = name;
-        }
+    for (const auto& other : stats) {
+        if (&other == &*best) continue;
+        if (!welchTest(best->simulated_time_ms, other.simulated_time_ms).significant) return "None";
     }
 
-    return best_scheduler;
+    return best->scheduler_name;
 }
 
 } // namespace GPUSim
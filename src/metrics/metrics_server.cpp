@@ -0,0 +1,254 @@
+#include "metrics_server.h"
+#include "gpu_device.h"
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "ws2_32.lib")
+#endif
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace GPUSim {
+
+#if defined(_WIN32)
+using SocketHandle = SOCKET;
+using SocketLength = int;
+static const SocketHandle kInvalidSocket = INVALID_SOCKET;
+static void closeSocket(SocketHandle socket) { closesocket(socket); }
+#else
+using SocketHandle = int;
+using SocketLength = socklen_t;
+static const SocketHandle kInvalidSocket = -1;
+static void closeSocket(SocketHandle socket) { close(socket); }
+#endif
+
+#if defined(MSG_NOSIGNAL)
+static const int kSendFlags = MSG_NOSIGNAL; // A scraper hanging up must not raise SIGPIPE
+#else
+static const int kSendFlags = 0;
+#endif
+
+static const std::intptr_t kClosed = -1;
+
+static SocketHandle toSocket(std::intptr_t handle) { return static_cast<SocketHandle>(handle); }
+
+// Waits up to timeout_ms for the socket to become readable
+static bool waitReadable(SocketHandle socket, long timeout_ms) {
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(socket, &readable);
+    timeval timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_usec = (timeout_ms % 1000) * 1000;
+    return select(static_cast<int>(socket) + 1, &readable, nullptr, nullptr, &timeout) > 0;
+}
+
+static void sendAll(SocketHandle socket, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        int n = send(socket, data.data() + sent, static_cast<int>(data.size() - sent), kSendFlags);
+        if (n <= 0) return;
+        sent += static_cast<size_t>(n);
+    }
+}
+
+MetricsServer::MetricsServer(const GPUDevice& device, uint16_t port)
+    : device_(device),
+      port_(port),
+      listen_socket_(kClosed),
+      running_(false),
+      requests_served_(0) {
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start() {
+    if (running_.load()) return true;
+
+#if defined(_WIN32)
+    WSADATA wsa_data;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0) {
+        std::cerr << "Failed to initialize sockets\n";
+        return false;
+    }
+#endif
+
+    SocketHandle listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener == kInvalidSocket) {
+        std::cerr << "Failed to create metrics server socket\n";
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port_);
+
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, 8) != 0) {
+        std::cerr << "Failed to listen on 127.0.0.1:" << port_ << "\n";
+        closeSocket(listener);
+        return false;
+    }
+
+    SocketLength length = sizeof(address);
+    if (getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) == 0) {
+        port_ = ntohs(address.sin_port);
+    }
+
+    listen_socket_ = static_cast<std::intptr_t>(listener);
+    running_.store(true);
+    server_thread_ = std::thread(&MetricsServer::serverThread, this);
+
+    std::cout << "Metrics server listening on http://127.0.0.1:" << port_ << "/metrics\n";
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running_.exchange(false)) return;
+
+    // The accept loop polls running_, so it exits within one timeout
+    if (server_thread_.joinable()) {
+        server_thread_.join();
+    }
+
+    closeSocket(toSocket(listen_socket_));
+    listen_socket_ = kClosed;
+
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+}
+
+void MetricsServer::serverThread() {
+    SocketHandle listener = toSocket(listen_socket_);
+
+    while (running_.load()) {
+        if (!waitReadable(listener, 100)) continue;
+
+        SocketHandle client = accept(listener, nullptr, nullptr);
+        if (client == kInvalidSocket) continue;
+#if defined(SO_NOSIGPIPE)
+        int no_sigpipe = 1;
+        setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+
+        handleConnection(static_cast<std::intptr_t>(client));
+        closeSocket(client);
+    }
+}
+
+void MetricsServer::handleConnection(std::intptr_t handle) {
+    SocketHandle client = toSocket(handle);
+
+    // Only the request line matters; read until the end of the headers
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+        if (!waitReadable(client, 1000)) return;
+        int n = recv(client, buffer, sizeof(buffer), 0);
+        if (n <= 0) return;
+        request.append(buffer, static_cast<size_t>(n));
+    }
+
+    std::istringstream request_line(request.substr(0, request.find("\r\n")));
+    std::string method, path;
+    request_line >> method >> path;
+
+    std::string status = "200 OK";
+    std::string body;
+    if (method != "GET") {
+        status = "405 Method Not Allowed";
+        body = "Only GET is supported\n";
+    } else if (path == "/metrics" || path == "/") {
+        body = renderMetrics();
+    } else {
+        status = "404 Not Found";
+        body = "Metrics are served at /metrics\n";
+    }
+
+    std::ostringstream response;
+    response << "HTTP/1.1 " << status << "\r\n"
+             << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    sendAll(client, response.str());
+    requests_served_++;
+}
+
+std::string MetricsServer::renderMetrics() const {
+    const LiveMetrics& live = device_.getLiveMetrics();
+    const auto relaxed = std::memory_order_relaxed;
+    std::ostringstream out;
+
+    auto header = [&out](const char* name, const char* help, const char* type) {
+        out << "# HELP " << name << " " << help << "\n";
+        out << "# TYPE " << name << " " << type << "\n";
+    };
+
+    header("gpusim_cu_utilization_percent", "Share of compute unit cycles not idle.", "gauge");
+    for (size_t i = 0; i < live.compute_units.size(); ++i) {
+        out << "gpusim_cu_utilization_percent{cu=\"" << i << "\"} "
+            << live.compute_units[i].utilization.load(relaxed) << "\n";
+    }
+    header("gpusim_cu_active_blocks", "Thread blocks resident on the compute unit.", "gauge");
+    for (size_t i = 0; i < live.compute_units.size(); ++i) {
+        out << "gpusim_cu_active_blocks{cu=\"" << i << "\"} "
+            << live.compute_units[i].active_blocks.load(relaxed) << "\n";
+    }
+    header("gpusim_cu_active_warps", "Warps resident on the compute unit.", "gauge");
+    for (size_t i = 0; i < live.compute_units.size(); ++i) {
+        out << "gpusim_cu_active_warps{cu=\"" << i << "\"} "
+            << live.compute_units[i].active_warps.load(relaxed) << "\n";
+    }
+    header("gpusim_cu_cycles_total", "Simulated cycles on the compute unit clock.", "counter");
+    for (size_t i = 0; i < live.compute_units.size(); ++i) {
+        out << "gpusim_cu_cycles_total{cu=\"" << i << "\"} "
+            << live.compute_units[i].cycles.load(relaxed) << "\n";
+    }
+    header("gpusim_cu_instructions_total", "Simulated instructions issued by the compute unit.", "counter");
+    for (size_t i = 0; i < live.compute_units.size(); ++i) {
+        out << "gpusim_cu_instructions_total{cu=\"" << i << "\"} "
+            << live.compute_units[i].instructions.load(relaxed) << "\n";
+    }
+
+    header("gpusim_simulated_cycles_total", "Device clock, the furthest compute unit clock.", "counter");
+    out << "gpusim_simulated_cycles_total " << live.simulated_cycles.load(relaxed) << "\n";
+    header("gpusim_instructions_total", "Simulated instructions issued by all compute units.", "counter");
+    out << "gpusim_instructions_total " << live.instructions.load(relaxed) << "\n";
+    header("gpusim_admission_queue_depth", "Workloads admitted but not yet launched.", "gauge");
+    out << "gpusim_admission_queue_depth " << live.admission_queue_depth.load(relaxed) << "\n";
+    header("gpusim_scheduler_queue_depth", "Workloads waiting in the scheduler queue.", "gauge");
+    out << "gpusim_scheduler_queue_depth " << live.scheduler_queue_depth.load(relaxed) << "\n";
+    header("gpusim_running_workloads", "Workloads launched and not yet completed.", "gauge");
+    out << "gpusim_running_workloads " << live.running_workloads.load(relaxed) << "\n";
+    header("gpusim_completed_workloads_total", "Workloads completed.", "counter");
+    out << "gpusim_completed_workloads_total " << live.completed_workloads.load(relaxed) << "\n";
+    header("gpusim_rejected_workloads_total", "Workloads rejected by admission control.", "counter");
+    out << "gpusim_rejected_workloads_total " << live.rejected_workloads.load(relaxed) << "\n";
+    header("gpusim_host_mips", "Simulated instructions per host microsecond, recent.", "gauge");
+    out << "gpusim_host_mips " << live.host_mips.load(relaxed) << "\n";
+    header("gpusim_metrics_publishes_total", "Times the device refreshed these metrics.", "counter");
+    out << "gpusim_metrics_publishes_total " << live.publishes.load(relaxed) << "\n";
+
+    return out.str();
+}
+
+} // namespace GPUSim
@@ -0,0 +1,167 @@
+#include "occupancy.h"
+#include "workload.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace GPUSim {
+
+// OccupancyRing implementation
+OccupancyRing::OccupancyRing(size_t capacity)
+    : buffer_(std::max<size_t>(1, capacity)),
+      head_(0) {
+}
+
+std::vector<OccupancySample> OccupancyRing::getSamples() const {
+    std::vector<OccupancySample> samples;
+    samples.reserve(size());
+    for (uint64_t i = head_ - size(); i < head_; ++i) {
+        samples.push_back(buffer_[i % buffer_.size()]);
+    }
+    return samples;
+}
+
+// OccupancySampler implementation
+OccupancySampler::OccupancySampler(size_t num_compute_units, uint64_t interval_cycles, size_t ring_capacity)
+    : interval_cycles_(std::max<uint64_t>(1, interval_cycles)) {
+    for (size_t i = 0; i < num_compute_units; ++i) {
+        rings_.push_back(std::make_unique<OccupancyRing>(ring_capacity));
+    }
+}
+
+OccupancyRing* OccupancySampler::getRing(size_t compute_unit) {
+    return compute_unit < rings_.size() ? rings_[compute_unit].get() : nullptr;
+}
+
+void OccupancySampler::recordWorkload(const Workload& workload, const std::vector<uint32_t>& compute_units) {
+    workloads_.push_back(WorkloadSpan{workload.getName(), workload.getStartCycle(), workload.getEndCycle(),
+                                      workload.getConfig().getTotalBlocks(), compute_units});
+}
+
+std::vector<WorkloadOccupancy> OccupancySampler::summarize() const {
+    std::vector<std::vector<OccupancySample>> samples;
+    for (const auto& ring : rings_) {
+        samples.push_back(ring->getSamples());
+    }
+
+    std::vector<WorkloadOccupancy> summaries;
+    for (const auto& span : workloads_) {
+        WorkloadOccupancy summary{};
+        summary.workload_name = span.name;
+        summary.start_cycle = span.start_cycle;
+        summary.end_cycle = span.end_cycle;
+        summary.total_blocks = span.total_blocks;
+
+        // Resident blocks across the workload's units, per sampling interval
+        uint64_t first_bucket = span.start_cycle / interval_cycles_;
+        uint64_t last_bucket = span.end_cycle / interval_cycles_;
+        std::vector<uint32_t> resident(last_bucket - first_bucket + 1, 0);
+        for (uint32_t cu : span.compute_units) {
+            if (cu >= samples.size()) continue;
+            for (const auto& sample : samples[cu]) {
+                if (sample.cycle < span.start_cycle || sample.cycle > span.end_cycle) continue;
+                resident[sample.cycle / interval_cycles_ - first_bucket] += sample.active_blocks;
+            }
+        }
+
+        uint64_t total = 0;
+        for (uint32_t blocks : resident) {
+            summary.peak_resident_blocks = std::max(summary.peak_resident_blocks, blocks);
+            total += blocks;
+        }
+        summary.average_resident_blocks = static_cast<double>(total) / resident.size();
+
+        if (summary.peak_resident_blocks > 0) {
+            summary.waves = static_cast<double>(span.total_blocks) / summary.peak_resident_blocks;
+
+            size_t ramp = 0;
+            while (resident[ramp] * 10 < summary.peak_resident_blocks * 9) ramp++;
+            uint64_t ramp_cycle = (first_bucket + ramp) * interval_cycles_;
+            summary.ramp_cycles = ramp_cycle > span.start_cycle ? ramp_cycle - span.start_cycle : 0;
+
+            size_t tail = resident.size() - 1;
+            while (resident[tail] * 2 < summary.peak_resident_blocks) tail--;
+            uint64_t tail_start = (first_bucket + tail + 1) * interval_cycles_;
+            uint64_t duration = span.end_cycle - span.start_cycle;
+            summary.tail_fraction = duration > 0 && tail_start < span.end_cycle
+                ? static_cast<double>(span.end_cycle - tail_start) / duration
+                : 0.0;
+        }
+
+        summaries.push_back(summary);
+    }
+
+    return summaries;
+}
+
+void OccupancySampler::printSummary() const {
+    std::cout << "\n=== Occupancy (sampled every " << interval_cycles_ << " cycles) ===\n";
+    std::cout << std::left << std::setw(32) << "Workload" << std::right
+              << std::setw(8) << "Blocks"
+              << std::setw(12) << "Peak Res."
+              << std::setw(12) << "Avg Res."
+              << std::setw(8) << "Waves"
+              << std::setw(14) << "Ramp(cyc)"
+              << std::setw(10) << "Tail %"
+              << "\n";
+    std::cout << std::string(96, '-') << "\n";
+
+    for (const auto& summary : summarize()) {
+        std::cout << std::left << std::setw(32) << summary.workload_name << std::right
+                  << std::setw(8) << summary.total_blocks
+                  << std::setw(12) << summary.peak_resident_blocks
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(12) << summary.average_resident_blocks
+                  << std::setprecision(2)
+                  << std::setw(8) << summary.waves
+                  << std::setw(14) << summary.ramp_cycles
+                  << std::setprecision(1)
+                  << std::setw(10) << summary.tail_fraction * 100.0
+                  << "\n";
+    }
+
+    uint64_t overwritten = 0;
+    for (const auto& ring : rings_) {
+        overwritten += ring->getOverwrittenCount();
+    }
+    if (overwritten > 0) {
+        std::cout << overwritten << " early samples were overwritten; raise the ring capacity or interval\n";
+    }
+}
+
+bool OccupancySampler::exportTimeline(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << "\n";
+        return false;
+    }
+
+    file << "Cycle,CU,Active_Blocks,Active_Warps,Instructions,Issue_Rate\n";
+    for (size_t cu = 0; cu < rings_.size(); ++cu) {
+        // Once the ring has wrapped, the sample before the oldest one is gone
+        // and with it the start of that sample's interval
+        bool have_previous = rings_[cu]->getOverwrittenCount() == 0;
+        uint64_t previous_cycle = 0;
+        for (const auto& sample : rings_[cu]->getSamples()) {
+            file << sample.cycle << "," << cu << ","
+                 << sample.active_blocks << ","
+                 << sample.active_warps << ","
+                 << sample.instructions << ",";
+            // Instructions per cycle since the previous sample; blank when unknown
+            if (have_previous) {
+                uint64_t cycles = sample.cycle > previous_cycle ? sample.cycle - previous_cycle : 1;
+                file << static_cast<double>(sample.instructions) / cycles;
+            }
+            file << "\n";
+            previous_cycle = sample.cycle;
+            have_previous = true;
+        }
+    }
+
+    file.close();
+    std::cout << "Occupancy timeline exported to " << filename << "\n";
+    return true;
+}
+
+} // namespace GPUSim
@@ -0,0 +1,506 @@
+#include "record_sink.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+namespace GPUSim {
+
+static const char kCompressedMagic[8] = {'G', 'P', 'U', 'S', 'I', 'M', 'L', 'Z'};
+
+static const char* kCsvHeader =
+    "kind,workload_id,workload,type,block_id,compute_unit,submit_cycle,start_cycle,end_cycle,"
+    "instructions,cycles,memory_ops,blocks,compute_units,simulated_time_ns,host_time_ms,co_runner\n";
+
+// LZ4-style block codec. A block is a run of sequences, each a token byte
+// (literal count in the high nibble, match length minus 4 in the low one,
+// 15 meaning more length bytes follow), the literals, and a 16-bit offset
+// back into the output; the last sequence holds literals only.
+static const size_t kMinMatch = 4;
+static const size_t kMaxOffset = 65535;
+static const size_t kHashBits = 14;
+static const size_t kEndLiterals = 8; // The tail is always literals
+
+static uint32_t read32(const char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static size_t hashOf(uint32_t value) {
+    return (value * 2654435761u) >> (32 - kHashBits);
+}
+
+static void appendLength(std::vector<uint8_t>& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+static void appendSequence(std::vector<uint8_t>& out, const char* literals, size_t literal_count,
+                           size_t offset, size_t match_length) {
+    size_t match_code = match_length ? match_length - kMinMatch : 0;
+    out.push_back(static_cast<uint8_t>((std::min<size_t>(literal_count, 15) << 4) |
+                                       std::min<size_t>(match_code, 15)));
+    if (literal_count >= 15) appendLength(out, literal_count - 15);
+    out.insert(out.end(), literals, literals + literal_count);
+    if (match_length == 0) return;
+
+    out.push_back(static_cast<uint8_t>(offset & 0xFF));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (match_code >= 15) appendLength(out, match_code - 15);
+}
+
+static void lzCompress(const char* input, size_t size, std::vector<uint8_t>& out) {
+    out.clear();
+    std::vector<uint32_t> table(size_t(1) << kHashBits, 0); // Position + 1, 0 when empty
+
+    size_t anchor = 0;
+    size_t pos = 0;
+    while (pos + kEndLiterals + kMinMatch <= size) {
+        uint32_t value = read32(input + pos);
+        uint32_t& entry = table[hashOf(value)];
+        size_t candidate = entry;
+        entry = static_cast<uint32_t>(pos + 1);
+
+        if (candidate == 0 || pos - (candidate - 1) > kMaxOffset ||
+            read32(input + candidate - 1) != value) {
+            pos++;
+            continue;
+        }
+
+        size_t match = candidate - 1;
+        size_t length = kMinMatch;
+        size_t limit = size - kEndLiterals;
+        while (pos + length < limit && input[match + length] == input[pos + length]) {
+            length++;
+        }
+
+        appendSequence(out, input + anchor, pos - anchor, pos - match, length);
+        pos += length;
+        anchor = pos;
+    }
+
+    appendSequence(out, input + anchor, size - anchor, 0, 0);
+}
+
+static bool readLength(const uint8_t*& in, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (in >= end) return false;
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+static bool lzDecompress(const uint8_t* in, size_t size, char* out, size_t out_size) {
+    const uint8_t* end = in + size;
+    size_t written = 0;
+
+    while (in < end) {
+        uint8_t token = *in++;
+        size_t literal_count = token >> 4;
+        if (literal_count == 15 && !readLength(in, end, literal_count)) return false;
+        if (literal_count > static_cast<size_t>(end - in) || literal_count > out_size - written) return false;
+        std::memcpy(out + written, in, literal_count);
+        in += literal_count;
+        written += literal_count;
+        if (in == end) break; // Last sequence
+
+        if (end - in < 2) return false;
+        size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+        in += 2;
+        size_t match_length = token & 0x0F;
+        if (match_length == 15 && !readLength(in, end, match_length)) return false;
+        match_length += kMinMatch;
+        if (offset == 0 || offset > written || match_length > out_size - written) return false;
+
+        // Byte by byte: a match may overlap the bytes it produces
+        const char* match = out + written - offset;
+        for (size_t i = 0; i < match_length; ++i) {
+            out[written + i] = match[i];
+        }
+        written += match_length;
+    }
+
+    return written == out_size;
+}
+
+// Formatting helpers; std::to_chars is locale-free and allocation-free
+static void appendUInt(std::string& out, uint64_t value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+static void appendDouble(std::string& out, double value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 3);
+    out.append(buffer, result.ptr);
+}
+
+static void appendJsonString(std::string& out, std::string_view value) {
+    out += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            static const char kHex[] = "0123456789abcdef";
+            out += "\\u00";
+            out += kHex[(c >> 4) & 0xF];
+            out += kHex[c & 0xF];
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+static void appendCsvString(std::string& out, std::string_view value) {
+    if (value.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out.append(value);
+        return;
+    }
+    out += '"';
+    for (char c : value) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+// StreamingRecordSink implementation
+StreamingRecordSink::StreamingRecordSink(const std::string& path, RecordFormat format,
+                                         RecordCompression compression, size_t batch_bytes)
+    : path_(path),
+      format_(format),
+      compression_(compression),
+      batch_bytes_(std::max<size_t>(4096, batch_bytes)),
+      file_(nullptr),
+      block_records_(0),
+      kernel_records_(0),
+      back_pending_(false),
+      closing_(false),
+      raw_bytes_(0),
+      file_bytes_(0),
+      write_failed_(false) {
+}
+
+StreamingRecordSink::~StreamingRecordSink() {
+    close();
+}
+
+bool StreamingRecordSink::open() {
+    if (file_) return true;
+
+    file_ = std::fopen(path_.c_str(), "wb");
+    if (!file_) {
+        std::cerr << "Failed to open file: " << path_ << "\n";
+        return false;
+    }
+
+    write_failed_ = false;
+    raw_bytes_ = 0;
+    file_bytes_ = 0;
+    block_records_ = 0;
+    kernel_records_ = 0;
+    if (compression_ == RecordCompression::LZ) {
+        writeBytes(kCompressedMagic, sizeof(kCompressedMagic));
+    }
+
+    // Headroom for the record that crosses the threshold
+    front_.clear();
+    front_.reserve(batch_bytes_ + 1024);
+    back_.clear();
+    back_.reserve(batch_bytes_ + 1024);
+    if (format_ == RecordFormat::CSV) {
+        front_ += kCsvHeader;
+    }
+
+    back_pending_ = false;
+    closing_ = false;
+    writer_ = std::thread(&StreamingRecordSink::writerThread, this);
+    return true;
+}
+
+void StreamingRecordSink::writeBlock(const BlockRecord& record) {
+    if (!file_) return;
+
+    if (format_ == RecordFormat::JSONL) {
+        front_ += "{\"kind\":\"block\",\"workload_id\":";
+        appendUInt(front_, record.workload_id);
+        front_ += ",\"workload\":";
+        appendJsonString(front_, record.workload_name);
+        front_ += ",\"block_id\":";
+        appendUInt(front_, record.block_id);
+        front_ += ",\"compute_unit\":";
+        appendUInt(front_, record.compute_unit);
+        front_ += ",\"start_cycle\":";
+        appendUInt(front_, record.start_cycle);
+        front_ += ",\"end_cycle\":";
+        appendUInt(front_, record.end_cycle);
+        front_ += ",\"instructions\":";
+        appendUInt(front_, record.instructions);
+        front_ += ",\"cycles\":";
+        appendUInt(front_, record.cycles);
+        front_ += ",\"memory_ops\":";
+        appendUInt(front_, record.memory_ops);
+        front_ += "}\n";
+    } else {
+        front_ += "block,";
+        appendUInt(front_, record.workload_id);
+        front_ += ',';
+        appendCsvString(front_, record.workload_name);
+        front_ += ",,";
+        appendUInt(front_, record.block_id);
+        front_ += ',';
+        appendUInt(front_, record.compute_unit);
+        front_ += ",,";
+        appendUInt(front_, record.start_cycle);
+        front_ += ',';
+        appendUInt(front_, record.end_cycle);
+        front_ += ',';
+        appendUInt(front_, record.instructions);
+        front_ += ',';
+        appendUInt(front_, record.cycles);
+        front_ += ',';
+        appendUInt(front_, record.memory_ops);
+        front_ += ",,,,,\n";
+    }
+
+    block_records_++;
+    if (front_.size() >= batch_bytes_) {
+        submitBatch();
+    }
+}
+
+void StreamingRecordSink::writeKernel(const KernelRecord& record) {
+    if (!file_) return;
+
+    if (format_ == RecordFormat::JSONL) {
+        front_ += "{\"kind\":\"kernel\",\"workload_id\":";
+        appendUInt(front_, record.workload_id);
+        front_ += ",\"workload\":";
+        appendJsonString(front_, record.workload_name);
+        front_ += ",\"type\":";
+        appendJsonString(front_, workloadTypeName(record.type));
+        front_ += ",\"submit_cycle\":";
+        appendUInt(front_, record.submit_cycle);
+        front_ += ",\"start_cycle\":";
+        appendUInt(front_, record.start_cycle);
+        front_ += ",\"end_cycle\":";
+        appendUInt(front_, record.end_cycle);
+        front_ += ",\"instructions\":";
+        appendUInt(front_, record.instructions);
+        front_ += ",\"memory_ops\":";
+        appendUInt(front_, record.memory_ops);
+        front_ += ",\"blocks\":";
+        appendUInt(front_, record.blocks);
+        front_ += ",\"compute_units\":";
+        appendUInt(front_, record.compute_units);
+        front_ += ",\"simulated_time_ns\":";
+        appendDouble(front_, record.simulated_time_ns);
+        front_ += ",\"host_time_ms\":";
+        appendDouble(front_, record.host_time_ms);
+        front_ += ",\"co_runner\":";
+        appendJsonString(front_, record.co_runner);
+        front_ += "}\n";
+    } else {
+        front_ += "kernel,";
+        appendUInt(front_, record.workload_id);
+        front_ += ',';
+        appendCsvString(front_, record.workload_name);
+        front_ += ',';
+        front_ += workloadTypeName(record.type);
+        front_ += ",,,";
+        appendUInt(front_, record.submit_cycle);
+        front_ += ',';
+        appendUInt(front_, record.start_cycle);
+        front_ += ',';
+        appendUInt(front_, record.end_cycle);
+        front_ += ',';
+        appendUInt(front_, record.instructions);
+        front_ += ",,";
+        appendUInt(front_, record.memory_ops);
+        front_ += ',';
+        appendUInt(front_, record.blocks);
+        front_ += ',';
+        appendUInt(front_, record.compute_units);
+        front_ += ',';
+        appendDouble(front_, record.simulated_time_ns);
+        front_ += ',';
+        appendDouble(front_, record.host_time_ms);
+        front_ += ',';
+        appendCsvString(front_, record.co_runner);
+        front_ += '\n';
+    }
+
+    kernel_records_++;
+    if (front_.size() >= batch_bytes_) {
+        submitBatch();
+    }
+}
+
+void StreamingRecordSink::flush() {
+    if (!file_) return;
+    submitBatch();
+}
+
+void StreamingRecordSink::submitBatch() {
+    if (front_.empty()) return;
+
+    {
+        std::unique_lock<std::mutex> lock(batch_mutex_);
+        batch_cv_.wait(lock, [this]() { return !back_pending_; });
+        front_.swap(back_);
+        back_pending_ = true;
+    }
+    batch_cv_.notify_all();
+    front_.clear(); // The writer's old buffer, capacity kept
+}
+
+void StreamingRecordSink::writeBytes(const void* data, size_t size) {
+    if (size == 0) return;
+    if (std::fwrite(data, 1, size, file_) != size) {
+        write_failed_ = true;
+    }
+    file_bytes_ += size;
+}
+
+void StreamingRecordSink::writeBatch(const std::string& batch) {
+    raw_bytes_ += batch.size();
+    if (compression_ == RecordCompression::NONE) {
+        writeBytes(batch.data(), batch.size());
+        std::fflush(file_);
+        return;
+    }
+
+    lzCompress(batch.data(), batch.size(), compressed_);
+    uint32_t frame[2] = {static_cast<uint32_t>(batch.size()), static_cast<uint32_t>(compressed_.size())};
+    if (compressed_.size() >= batch.size()) {
+        frame[1] = frame[0]; // Stored raw
+        writeBytes(frame, sizeof(frame));
+        writeBytes(batch.data(), batch.size());
+    } else {
+        writeBytes(frame, sizeof(frame));
+        writeBytes(compressed_.data(), compressed_.size());
+    }
+    std::fflush(file_);
+}
+
+void StreamingRecordSink::writerThread() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(batch_mutex_);
+            batch_cv_.wait(lock, [this]() { return back_pending_ || closing_; });
+            if (!back_pending_) break;
+        }
+
+        // The producer leaves back_ alone until it is released
+        writeBatch(back_);
+
+        {
+            std::lock_guard<std::mutex> lock(batch_mutex_);
+            back_.clear();
+            back_pending_ = false;
+        }
+        batch_cv_.notify_all();
+    }
+}
+
+bool StreamingRecordSink::close() {
+    if (!file_) return true;
+
+    submitBatch();
+    {
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        closing_ = true;
+    }
+    batch_cv_.notify_all();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+
+    bool ok = !write_failed_ && std::fclose(file_) == 0;
+    file_ = nullptr;
+    if (!ok) {
+        std::cerr << "Failed to write record file: " << path_ << "\n";
+    }
+    return ok;
+}
+
+void StreamingRecordSink::printSummary() const {
+    std::cout << "Streamed " << block_records_ << " block and " << kernel_records_
+              << " kernel records to " << path_ << " (" << raw_bytes_.load() << " bytes";
+    if (compression_ == RecordCompression::LZ && raw_bytes_.load() > 0) {
+        std::cout << ", " << file_bytes_.load() << " compressed, " << std::fixed << std::setprecision(1)
+                  << static_cast<double>(raw_bytes_.load()) / file_bytes_.load() << "x";
+    }
+    std::cout << ")\n";
+}
+
+bool decompressRecordFile(const std::string& input_path, const std::string& output_path) {
+    std::FILE* input = std::fopen(input_path.c_str(), "rb");
+    if (!input) {
+        std::cerr << "Failed to open file: " << input_path << "\n";
+        return false;
+    }
+
+    char magic[sizeof(kCompressedMagic)];
+    if (std::fread(magic, 1, sizeof(magic), input) != sizeof(magic) ||
+        std::memcmp(magic, kCompressedMagic, sizeof(magic)) != 0) {
+        std::cerr << "Not a compressed record file: " << input_path << "\n";
+        std::fclose(input);
+        return false;
+    }
+
+    std::FILE* output = std::fopen(output_path.c_str(), "wb");
+    if (!output) {
+        std::cerr << "Failed to open file: " << output_path << "\n";
+        std::fclose(input);
+        return false;
+    }
+
+    bool ok = true;
+    std::vector<uint8_t> stored;
+    std::vector<char> raw;
+    uint32_t frame[2];
+    while (true) {
+        // Only a whole missing header is a clean end; part of one is truncation
+        size_t header_bytes = std::fread(frame, 1, sizeof(frame), input);
+        if (header_bytes != sizeof(frame)) {
+            ok = header_bytes == 0 && !std::ferror(input);
+            break;
+        }
+        stored.resize(frame[1]);
+        raw.resize(frame[0]);
+        if (std::fread(stored.data(), 1, stored.size(), input) != stored.size()) {
+            ok = false;
+            break;
+        }
+        if (frame[0] == frame[1]) {
+            std::memcpy(raw.data(), stored.data(), raw.size());
+        } else if (!lzDecompress(stored.data(), stored.size(), raw.data(), raw.size())) {
+            ok = false;
+            break;
+        }
+        if (std::fwrite(raw.data(), 1, raw.size(), output) != raw.size()) {
+            ok = false;
+            break;
+        }
+    }
+
+    std::fclose(input);
+    ok = std::fclose(output) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Corrupt or truncated record file: " << input_path << "\n";
+    }
+    return ok;
+}
+
+} // namespace GPUSim
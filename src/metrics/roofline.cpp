@@ -0,0 +1,170 @@
+#include "roofline.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace GPUSim {
+
+int flopsPerLane(WorkloadType type) {
+    switch (type) {
+        case WorkloadType::MATRIX_MULTIPLY: return 2;
+        case WorkloadType::CONVOLUTION: return 2;
+        default: return 1;
+    }
+}
+
+double RooflineModel::attainableGflops(double intensity) const {
+    return std::min(peak_gflops, intensity * peak_bandwidth_gbs);
+}
+
+RooflinePoint RooflineModel::place(const std::string& name, uint64_t flops, uint64_t bytes, double time_ns) const {
+    RooflinePoint point{};
+    point.workload_name = name;
+    point.intensity = bytes > 0 ? static_cast<double>(flops) / bytes : 0.0;
+    // FLOP per ns is GFLOP/s, bytes per ns is GB/s
+    point.achieved_gflops = time_ns > 0 ? flops / time_ns : 0.0;
+    point.achieved_bandwidth_gbs = time_ns > 0 ? bytes / time_ns : 0.0;
+    point.attainable_gflops = bytes > 0 ? attainableGflops(point.intensity) : peak_gflops;
+    point.roof_pct = point.attainable_gflops > 0 ? point.achieved_gflops / point.attainable_gflops * 100.0 : 0.0;
+    point.memory_bound = bytes > 0 && point.intensity < ridgeIntensity();
+    return point;
+}
+
+static std::string escapeXml(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        switch (c) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            default: out += c;
+        }
+    }
+    return out;
+}
+
+static std::string formatDecade(int exponent) {
+    std::ostringstream out;
+    if (exponent >= 0 && exponent <= 5) {
+        out << static_cast<long long>(std::pow(10.0, exponent));
+    } else if (exponent < 0 && exponent >= -3) {
+        out << std::fixed << std::setprecision(-exponent) << std::pow(10.0, exponent);
+    } else {
+        out << "1e" << exponent;
+    }
+    return out.str();
+}
+
+bool writeRooflineSVG(const std::string& filename, const RooflineModel& model,
+                      const std::vector<RooflinePoint>& points, const std::string& title) {
+    if (model.peak_gflops <= 0 || model.peak_bandwidth_gbs <= 0) {
+        std::cerr << "Roofline needs a peak compute rate and bandwidth\n";
+        return false;
+    }
+
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << "\n";
+        return false;
+    }
+
+    const double width = 800, height = 560;
+    const double left = 80, right = 30, top = 50, bottom = 60;
+    const double plot_w = width - left - right, plot_h = height - top - bottom;
+
+    // Whole decades around the ridge, the peak and every plottable point
+    double ridge = model.ridgeIntensity();
+    double x_lo = ridge / 100, x_hi = ridge * 10;
+    double y_lo = model.peak_gflops / 1e4, y_hi = model.peak_gflops * 2;
+    for (const auto& point : points) {
+        if (point.intensity <= 0 || point.achieved_gflops <= 0) continue;
+        x_lo = std::min(x_lo, point.intensity);
+        x_hi = std::max(x_hi, point.intensity);
+        y_lo = std::min(y_lo, point.achieved_gflops);
+        y_hi = std::max(y_hi, point.achieved_gflops);
+    }
+    int x_min = static_cast<int>(std::floor(std::log10(x_lo)));
+    int x_max = static_cast<int>(std::ceil(std::log10(x_hi)));
+    int y_min = static_cast<int>(std::floor(std::log10(y_lo)));
+    int y_max = static_cast<int>(std::ceil(std::log10(y_hi)));
+
+    auto px = [&](double intensity) {
+        return left + (std::log10(intensity) - x_min) / (x_max - x_min) * plot_w;
+    };
+    auto py = [&](double gflops) {
+        return top + plot_h - (std::log10(gflops) - y_min) / (y_max - y_min) * plot_h;
+    };
+
+    file << std::fixed << std::setprecision(1);
+    file << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width << "\" height=\"" << height
+         << "\" viewBox=\"0 0 " << width << " " << height << "\" font-family=\"sans-serif\" font-size=\"12\">\n";
+    file << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+    file << "<text x=\"" << width / 2 << "\" y=\"28\" text-anchor=\"middle\" font-size=\"16\">"
+         << escapeXml(title) << "</text>\n";
+    file << "<clipPath id=\"plot\"><rect x=\"" << left << "\" y=\"" << top << "\" width=\"" << plot_w
+         << "\" height=\"" << plot_h << "\"/></clipPath>\n";
+
+    // Decade grid and tick labels
+    for (int e = x_min; e <= x_max; ++e) {
+        double x = px(std::pow(10.0, e));
+        file << "<line x1=\"" << x << "\" y1=\"" << top << "\" x2=\"" << x << "\" y2=\"" << top + plot_h
+             << "\" stroke=\"#ddd\"/>\n";
+        file << "<text x=\"" << x << "\" y=\"" << top + plot_h + 18 << "\" text-anchor=\"middle\">"
+             << formatDecade(e) << "</text>\n";
+    }
+    for (int e = y_min; e <= y_max; ++e) {
+        double y = py(std::pow(10.0, e));
+        file << "<line x1=\"" << left << "\" y1=\"" << y << "\" x2=\"" << left + plot_w << "\" y2=\"" << y
+             << "\" stroke=\"#ddd\"/>\n";
+        file << "<text x=\"" << left - 8 << "\" y=\"" << y + 4 << "\" text-anchor=\"end\">"
+             << formatDecade(e) << "</text>\n";
+    }
+    file << "<rect x=\"" << left << "\" y=\"" << top << "\" width=\"" << plot_w << "\" height=\"" << plot_h
+         << "\" fill=\"none\" stroke=\"#333\"/>\n";
+    file << "<text x=\"" << left + plot_w / 2 << "\" y=\"" << height - 18
+         << "\" text-anchor=\"middle\">Arithmetic intensity (FLOP/byte)</text>\n";
+    file << "<text transform=\"translate(20," << top + plot_h / 2
+         << ") rotate(-90)\" text-anchor=\"middle\">Performance (GFLOP/s)</text>\n";
+
+    // The roof: bandwidth slope up to the ridge, then flat at peak compute
+    double x_start = std::pow(10.0, x_min), x_end = std::pow(10.0, x_max);
+    file << "<polyline clip-path=\"url(#plot)\" fill=\"none\" stroke=\"#333\" stroke-width=\"2\" points=\""
+         << px(x_start) << "," << py(model.attainableGflops(x_start)) << " "
+         << px(ridge) << "," << py(model.peak_gflops) << " "
+         << px(x_end) << "," << py(model.peak_gflops) << "\"/>\n";
+    file << "<line x1=\"" << px(ridge) << "\" y1=\"" << py(model.peak_gflops) << "\" x2=\"" << px(ridge)
+         << "\" y2=\"" << top + plot_h << "\" stroke=\"#999\" stroke-dasharray=\"4 4\"/>\n";
+    file << "<text x=\"" << px(ridge) + 6 << "\" y=\"" << top + plot_h - 8 << "\" fill=\"#666\">ridge "
+         << std::setprecision(2) << ridge << " FLOP/B</text>\n";
+    file << "<text x=\"" << left + plot_w - 6 << "\" y=\"" << py(model.peak_gflops) - 6
+         << "\" text-anchor=\"end\">" << std::setprecision(0) << model.peak_gflops << " GFLOP/s, "
+         << model.peak_bandwidth_gbs << " GB/s</text>\n";
+
+    // Workloads, coloured by the roof that bounds them
+    file << std::setprecision(1);
+    for (const auto& point : points) {
+        if (point.intensity <= 0 || point.achieved_gflops <= 0) continue;
+        double x = px(point.intensity), y = py(point.achieved_gflops);
+        const char* colour = point.memory_bound ? "#1f77b4" : "#d62728";
+        file << "<g><title>" << escapeXml(point.workload_name) << ": " << std::setprecision(2)
+             << point.achieved_gflops << " GFLOP/s at " << point.intensity << " FLOP/B, "
+             << point.roof_pct << "% of roof</title>" << std::setprecision(1)
+             << "<circle cx=\"" << x << "\" cy=\"" << y << "\" r=\"5\" fill=\"" << colour << "\"/>"
+             << "<text x=\"" << x + 8 << "\" y=\"" << y - 6 << "\" font-size=\"10\">"
+             << escapeXml(point.workload_name) << "</text></g>\n";
+    }
+
+    file << "<circle cx=\"" << left + 14 << "\" cy=\"" << top + 16 << "\" r=\"5\" fill=\"#1f77b4\"/>"
+         << "<text x=\"" << left + 24 << "\" y=\"" << top + 20 << "\">memory-bound</text>\n";
+    file << "<circle cx=\"" << left + 14 << "\" cy=\"" << top + 34 << "\" r=\"5\" fill=\"#d62728\"/>"
+         << "<text x=\"" << left + 24 << "\" y=\"" << top + 38 << "\">compute-bound</text>\n";
+    file << "</svg>\n";
+
+    return true;
+}
+
+} // namespace GPUSim
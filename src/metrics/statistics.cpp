@@ -0,0 +1,79 @@
+#include "statistics.h"
+#include <cmath>
+#include <limits>
+
+namespace GPUSim {
+
+SampleSummary summarizeSamples(const std::vector<double>& samples) {
+    SampleSummary summary{};
+    summary.count = samples.size();
+    if (samples.empty()) return summary;
+
+    double sum = 0.0;
+    for (double sample : samples) sum += sample;
+    summary.mean = sum / samples.size();
+
+    double squares = 0.0;
+    for (double sample : samples) squares += (sample - summary.mean) * (sample - summary.mean);
+    summary.stddev = samples.size() > 1 ? std::sqrt(squares / (samples.size() - 1)) : 0.0;
+
+    // A single sample has no spread to estimate; its interval is the point
+    double half_width = samples.size() > 1
+        ? studentT95(samples.size() - 1) * summary.stddev / std::sqrt(static_cast<double>(samples.size()))
+        : 0.0;
+    summary.ci95_low = summary.mean - half_width;
+    summary.ci95_high = summary.mean + half_width;
+    return summary;
+}
+
+double studentT95(double degrees_of_freedom) {
+    // Critical values for 1..30 degrees of freedom, then a few anchors
+    // towards the normal limit
+    static const double kTable[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    static const double kTailDf[] = {30.0, 40.0, 60.0, 120.0};
+    static const double kTailT[] = {2.042, 2.021, 2.000, 1.980};
+
+    if (!(degrees_of_freedom >= 1.0)) return std::numeric_limits<double>::infinity();
+    if (degrees_of_freedom < 30.0) {
+        size_t lower = static_cast<size_t>(degrees_of_freedom);
+        double fraction = degrees_of_freedom - lower;
+        return kTable[lower - 1] + fraction * (kTable[lower] - kTable[lower - 1]);
+    }
+    for (size_t i = 1; i < 4; ++i) {
+        if (degrees_of_freedom < kTailDf[i]) {
+            double fraction = (degrees_of_freedom - kTailDf[i - 1]) / (kTailDf[i] - kTailDf[i - 1]);
+            return kTailT[i - 1] + fraction * (kTailT[i] - kTailT[i - 1]);
+        }
+    }
+    return 1.960;
+}
+
+WelchTest welchTest(const SampleSummary& a, const SampleSummary& b) {
+    WelchTest test{};
+    if (a.count < 2 || b.count < 2) return test;
+
+    double var_a = a.stddev * a.stddev / a.count;
+    double var_b = b.stddev * b.stddev / b.count;
+    double difference = a.mean - b.mean;
+
+    if (var_a + var_b == 0.0) {
+        // Both sets are constant: any difference at all is real
+        test.t = difference == 0.0 ? 0.0 : std::copysign(std::numeric_limits<double>::infinity(), difference);
+        test.degrees_of_freedom = static_cast<double>(a.count + b.count - 2);
+        test.significant = difference != 0.0;
+        return test;
+    }
+
+    test.t = difference / std::sqrt(var_a + var_b);
+    // Welch-Satterthwaite
+    test.degrees_of_freedom = (var_a + var_b) * (var_a + var_b) /
+        (var_a * var_a / (a.count - 1) + var_b * var_b / (b.count - 1));
+    test.significant = std::fabs(test.t) > studentT95(test.degrees_of_freedom);
+    return test;
+}
+
+} // namespace GPUSim
@@ -0,0 +1,290 @@
+#include "sweep.h"
+#include "scheduler.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace GPUSim {
+
+static const char* kSweepHeader =
+    "Compute_Units,Warps_per_CU,Max_Blocks_per_CU,Memory_Latency,Scheduler,Mix,Seed,"
+    "OK,Sim_Cycles,Sim_Time_ns,Host_Time_ms,Avg_Utilization_%,CU_Allocation_%,Avg_Queue_Wait_ns,"
+    "P99_Queue_Wait_ns,P99_Service_Time_ns,Total_Instructions,Energy_J,GFLOPS_per_W,Sim_MIPS,Device_Reused";
+
+// The first seven columns identify a point
+static const size_t kKeyColumns = 7;
+
+static size_t countFields(const std::string& line) {
+    return static_cast<size_t>(std::count(line.begin(), line.end(), ',')) + 1;
+}
+
+// Devices differ only in the swept fields, so those decide reuse
+static bool sameDevice(const GPUConfig& a, const GPUConfig& b) {
+    return a.num_compute_units == b.num_compute_units &&
+           a.warps_per_cu == b.warps_per_cu &&
+           a.max_blocks_per_cu == b.max_blocks_per_cu &&
+           a.global_memory_latency == b.global_memory_latency;
+}
+
+// A run holds a host thread per compute unit plus the distributor, so size
+// the pool for the widest device in the grid
+static size_t defaultWorkers(const SweepGrid& grid) {
+    size_t max_cus = grid.compute_units.empty()
+        ? grid.base.num_compute_units
+        : *std::max_element(grid.compute_units.begin(), grid.compute_units.end());
+    size_t hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    return std::max<size_t>(1, hardware_threads / (max_cus + 1));
+}
+
+ParameterSweep::ParameterSweep(const SweepGrid& grid, const std::string& results_path, size_t max_parallel)
+    : grid_(grid),
+      results_path_(results_path),
+      max_parallel_(max_parallel > 0 ? max_parallel : defaultWorkers(grid)),
+      runs_completed_(0),
+      runs_failed_(0),
+      devices_created_(0),
+      devices_reused_(0),
+      runs_skipped_(0) {
+}
+
+std::vector<SweepPoint> ParameterSweep::getPoints() const {
+    auto orBase = [](const std::vector<size_t>& values, size_t base) {
+        return values.empty() ? std::vector<size_t>{base} : values;
+    };
+    std::vector<SchedulingAlgorithm> schedulers = grid_.schedulers.empty()
+        ? std::vector<SchedulingAlgorithm>{SchedulingAlgorithm::FIFO} : grid_.schedulers;
+    std::vector<uint64_t> seeds = grid_.seeds.empty() ? std::vector<uint64_t>{42} : grid_.seeds;
+
+    std::vector<SweepPoint> points;
+    for (size_t cus : orBase(grid_.compute_units, grid_.base.num_compute_units)) {
+        for (size_t warps : orBase(grid_.warps_per_cu, grid_.base.warps_per_cu)) {
+            for (size_t blocks : orBase(grid_.max_blocks_per_cu, grid_.base.max_blocks_per_cu)) {
+                for (size_t latency : orBase(grid_.memory_latency, grid_.base.global_memory_latency)) {
+                    GPUConfig config = grid_.base;
+                    config.num_compute_units = cus;
+                    config.warps_per_cu = warps;
+                    config.max_blocks_per_cu = blocks;
+                    config.global_memory_latency = latency;
+
+                    for (SchedulingAlgorithm scheduler : schedulers) {
+                        for (size_t mix = 0; mix < grid_.mixes.size(); ++mix) {
+                            for (uint64_t seed : seeds) {
+                                points.push_back(SweepPoint{config, scheduler, mix, seed});
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return points;
+}
+
+std::string ParameterSweep::pointKey(const SweepPoint& point) const {
+    std::ostringstream key;
+    key << point.config.num_compute_units << ","
+        << point.config.warps_per_cu << ","
+        << point.config.max_blocks_per_cu << ","
+        << point.config.global_memory_latency << ","
+        << SchedulerFactory::algorithmName(point.scheduler) << ","
+        << grid_.mixes[point.mix].name << ","
+        << point.seed;
+    return key.str();
+}
+
+bool ParameterSweep::loadCompletedKeys(std::set<std::string>& keys) {
+    std::vector<std::string> rows;
+    {
+        std::ifstream existing(results_path_);
+        std::string line;
+        if (existing.is_open() && std::getline(existing, line)) {
+            if (line != kSweepHeader) {
+                std::cerr << "Results table " << results_path_ << " has different columns; not resuming\n";
+                return false;
+            }
+
+            // A run cut short can leave a partial last row; failed runs are retried
+            size_t fields = countFields(kSweepHeader);
+            while (std::getline(existing, line)) {
+                size_t key_end = 0;
+                for (size_t i = 0; i < kKeyColumns && key_end != std::string::npos; ++i) {
+                    key_end = line.find(',', key_end + (i > 0 ? 1 : 0));
+                }
+                if (countFields(line) != fields || key_end == std::string::npos ||
+                    line.compare(key_end + 1, 2, "1,") != 0) {
+                    continue;
+                }
+                if (keys.insert(line.substr(0, key_end)).second) {
+                    rows.push_back(line);
+                }
+            }
+        }
+    }
+
+    // Rewritten beside the table and renamed over it, so an interruption
+    // leaves either the old table or the new one
+    const std::string temp_path = results_path_ + ".tmp";
+    {
+        std::ofstream temp(temp_path, std::ios::trunc);
+        if (!temp.is_open()) {
+            std::cerr << "Failed to open file: " << temp_path << "\n";
+            return false;
+        }
+        temp << kSweepHeader << "\n";
+        for (const auto& row : rows) {
+            temp << row << "\n";
+        }
+        temp.close();
+        if (!temp) {
+            std::cerr << "Failed to write file: " << temp_path << "\n";
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, results_path_, error);
+    if (error) {
+        std::cerr << "Failed to replace " << results_path_ << ": " << error.message() << "\n";
+        std::remove(temp_path.c_str());
+        return false;
+    }
+
+    results_.open(results_path_, std::ios::app);
+    if (!results_.is_open()) {
+        std::cerr << "Failed to open file: " << results_path_ << "\n";
+        return false;
+    }
+    return true;
+}
+
+void ParameterSweep::runPoint(const SweepPoint& point, std::unique_ptr<GPUDevice>& device, std::ostream& log) {
+    bool reused = device && sameDevice(device->getConfig(), point.config);
+    bool ok = false;
+    GPUMetrics metrics{};
+    try {
+        if (reused) {
+            device->reset();
+            devices_reused_++;
+        } else {
+            device = std::make_unique<GPUDevice>(point.config, log);
+            device->getPerformanceAnalyzer()->setRetainWorkloadMetrics(false);
+            devices_created_++;
+        }
+        device->setScheduler(SchedulerFactory::createScheduler(point.scheduler));
+
+        auto workloads = grid_.mixes[point.mix].build(point.seed);
+        size_t accepted = 0;
+        for (auto& workload : workloads) {
+            if (device->submitWorkload(workload)) accepted++;
+        }
+
+        device->executeWorkloads();
+        device->waitForCompletion();
+
+        const PerformanceAnalyzer* analyzer = device->getPerformanceAnalyzer();
+        metrics = analyzer->getGPUMetrics();
+        ok = !workloads.empty() && accepted == workloads.size() &&
+             analyzer->getWorkloadCount() == workloads.size();
+    } catch (const std::exception& e) {
+        // The point still gets its failed row; the device's state is unknown,
+        // so the next point builds a fresh one
+        std::cerr << "Sweep point " << pointKey(point) << " threw: " << e.what() << "\n";
+        device.reset();
+    }
+
+    std::ostringstream row;
+    row << pointKey(point) << ","
+        << (ok ? 1 : 0) << ","
+        << metrics.simulated_cycles << ","
+        << metrics.simulated_time_ns << ","
+        << metrics.total_execution_time_ms << ","
+        << metrics.average_utilization << ","
+        << metrics.cu_allocation_utilization << ","
+        << metrics.average_queue_wait_ns << ","
+        << metrics.p99_queue_wait_ns << ","
+        << metrics.p99_service_time_ns << ","
+        << metrics.total_instructions << ","
+        << metrics.energy_j << ","
+        << metrics.gflops_per_watt << ","
+        << metrics.simulated_mips << ","
+        << (reused ? 1 : 0) << "\n";
+
+    {
+        // Flushed per row so an interruption loses at most the runs in flight
+        std::lock_guard<std::mutex> lock(results_mutex_);
+        results_ << row.str();
+        results_.flush();
+    }
+
+    if (ok) {
+        runs_completed_++;
+    } else {
+        runs_failed_++;
+        std::cerr << "Sweep point failed: " << pointKey(point) << "\n";
+    }
+}
+
+bool ParameterSweep::run() {
+    for (const auto& mix : grid_.mixes) {
+        if (mix.name.empty() || mix.name.find(',') != std::string::npos || !mix.build) {
+            std::cerr << "Invalid workload mix name: '" << mix.name << "'\n";
+            return false;
+        }
+    }
+
+    std::set<std::string> completed;
+    if (!loadCompletedKeys(completed)) {
+        return false;
+    }
+
+    std::vector<SweepPoint> pending;
+    for (const auto& point : getPoints()) {
+        if (completed.count(pointKey(point)) == 0) {
+            pending.push_back(point);
+        }
+    }
+    runs_skipped_ = completed.size();
+
+    std::cout << "Parameter sweep: " << pending.size() << " runs to go, " << runs_skipped_
+              << " already in " << results_path_ << ", " << max_parallel_ << " workers\n";
+
+    // Workers claim points in order, so consecutive claims mostly share a
+    // device. Device status lines would interleave across workers and the
+    // rows carry the results, so each worker discards its devices' log.
+    std::atomic<size_t> next_point{0};
+    auto worker = [&]() {
+        std::ostream discard(nullptr);
+        std::unique_ptr<GPUDevice> device;
+        for (size_t index = next_point++; index < pending.size(); index = next_point++) {
+            runPoint(pending[index], device, discard);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < std::min(max_parallel_, pending.size()); ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    results_.close();
+    return runs_failed_.load() == 0;
+}
+
+void ParameterSweep::printSummary() const {
+    std::cout << "\n=== Parameter Sweep ===\n";
+    std::cout << "Runs completed: " << runs_completed_.load() << "\n";
+    std::cout << "Runs failed: " << runs_failed_.load() << "\n";
+    std::cout << "Runs resumed from table: " << runs_skipped_ << "\n";
+    std::cout << "Devices created: " << devices_created_.load()
+              << ", reused: " << devices_reused_.load() << "\n";
+    std::cout << "Results: " << results_path_ << "\n";
+}
+
+} // namespace GPUSim
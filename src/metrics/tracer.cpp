@@ -0,0 +1,201 @@
+#include "tracer.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <set>
+
+namespace GPUSim {
+
+// Chrome trace process ids
+static constexpr int kKernelPid = 0;
+static constexpr int kComputeUnitPid = 1;
+static constexpr int kWarpStallPid = 2;
+
+static std::string escapeJSON(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            // Control characters may not appear raw in a JSON string
+            static const char kHex[] = "0123456789abcdef";
+            escaped += "\\u00";
+            escaped += kHex[(c >> 4) & 0xF];
+            escaped += kHex[c & 0xF];
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+TimelineTracer::TimelineTracer(const TraceConfig& config)
+    : config_(config),
+      dropped_events_(0) {
+}
+
+void TimelineTracer::addEvent(const Event& event) {
+    if (events_.size() >= config_.max_events) {
+        dropped_events_++;
+        return;
+    }
+    events_.push_back(event);
+}
+
+void TimelineTracer::recordKernel(const Workload& workload) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    kernels_.push_back(KernelSpan{workload.getID(), workload.getName(),
+                                  workload.getStartCycle(), workload.getExecutionCycles(),
+                                  workload.getConfig().getTotalBlocks(),
+                                  workload.getAllocatedComputeUnits()});
+    kernel_names_[workload.getID()] = workload.getName();
+}
+
+void TimelineTracer::recordBlock(const ThreadBlock& block, CoreID compute_unit) {
+    if (!isSampled(block)) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    addEvent(Event{EventKind::BLOCK, compute_unit, block.getWorkloadID(), block.getBlockID(), 0,
+                   block.getStartCycle(), block.getEndCycle() - block.getStartCycle()});
+}
+
+void TimelineTracer::recordWarpStall(CoreID compute_unit, const ThreadBlock& block, const Warp& warp,
+                                     uint64_t start_cycle, uint64_t cycles) {
+    if (!config_.trace_warp_stalls || !isSampled(block)) return;
+    if (config_.warp_sample_interval > 1 && warp.getWarpID() % config_.warp_sample_interval != 0) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    addEvent(Event{EventKind::WARP_STALL, compute_unit, block.getWorkloadID(), block.getBlockID(),
+                   warp.getWarpID(), start_cycle, cycles});
+}
+
+size_t TimelineTracer::getEventCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return kernels_.size() + events_.size();
+}
+
+size_t TimelineTracer::getDroppedEventCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_events_;
+}
+
+bool TimelineTracer::write(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << "\n";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto kernelName = [this](uint64_t workload_id) -> std::string {
+        auto it = kernel_names_.find(workload_id);
+        return it != kernel_names_.end() ? it->second : "Workload " + std::to_string(workload_id);
+    };
+
+    // Blocks resident together on one CU overlap, so spread each CU's blocks
+    // over lanes (one trace thread per lane) where no two spans overlap
+    std::vector<const Event*> blocks;
+    std::set<CoreID> stalled_units;
+    for (const auto& event : events_) {
+        if (event.kind == EventKind::BLOCK) {
+            blocks.push_back(&event);
+        } else {
+            stalled_units.insert(event.compute_unit);
+        }
+    }
+    std::sort(blocks.begin(), blocks.end(), [](const Event* a, const Event* b) {
+        return a->compute_unit != b->compute_unit ? a->compute_unit < b->compute_unit
+                                                  : a->start_cycle < b->start_cycle;
+    });
+
+    std::map<CoreID, std::vector<uint64_t>> lane_ends; // Per CU, end cycle of each lane
+    std::vector<std::pair<const Event*, size_t>> placed;
+    placed.reserve(blocks.size());
+    for (const Event* block : blocks) {
+        auto& lanes = lane_ends[block->compute_unit];
+        size_t lane = 0;
+        while (lane < lanes.size() && lanes[lane] > block->start_cycle) ++lane;
+        if (lane == lanes.size()) lanes.push_back(0);
+        lanes[lane] = block->start_cycle + block->cycles;
+        placed.emplace_back(block, lane);
+    }
+
+    const size_t lanes_per_cu = 1000;
+    bool first = true;
+    auto separator = [&]() -> std::ofstream& {
+        file << (first ? "\n" : ",\n");
+        first = false;
+        return file;
+    };
+
+    file << "{\"displayTimeUnit\":\"ns\",\n";
+    file << "\"otherData\":{\"timebase\":\"simulated cycles (1 trace us = 1 cycle)\","
+         << "\"block_sample_interval\":" << config_.block_sample_interval << ","
+         << "\"dropped_events\":" << dropped_events_ << "},\n";
+    file << "\"traceEvents\":[";
+
+    // Track names
+    separator() << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << kKernelPid
+                << ",\"args\":{\"name\":\"Kernels\"}}";
+    separator() << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << kComputeUnitPid
+                << ",\"args\":{\"name\":\"Compute Units\"}}";
+    separator() << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << kWarpStallPid
+                << ",\"args\":{\"name\":\"Warp Stalls\"}}";
+    for (const auto& [cu, lanes] : lane_ends) {
+        for (size_t lane = 0; lane < lanes.size(); ++lane) {
+            separator() << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << kComputeUnitPid
+                        << ",\"tid\":" << cu * lanes_per_cu + lane
+                        << ",\"args\":{\"name\":\"CU " << cu << " slot " << lane << "\"}}";
+        }
+    }
+    for (CoreID cu : stalled_units) {
+        separator() << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << kWarpStallPid
+                    << ",\"tid\":" << cu << ",\"args\":{\"name\":\"CU " << cu << "\"}}";
+    }
+
+    for (const auto& kernel : kernels_) {
+        separator() << "{\"ph\":\"X\",\"cat\":\"kernel\",\"name\":\"" << escapeJSON(kernel.name)
+                    << "\",\"pid\":" << kKernelPid << ",\"tid\":" << kernel.workload_id
+                    << ",\"ts\":" << kernel.start_cycle << ",\"dur\":" << kernel.cycles
+                    << ",\"args\":{\"blocks\":" << kernel.blocks
+                    << ",\"compute_units\":" << kernel.compute_units << "}}";
+    }
+
+    for (const auto& [block, lane] : placed) {
+        separator() << "{\"ph\":\"X\",\"cat\":\"block\",\"name\":\""
+                    << escapeJSON(kernelName(block->workload_id)) << " #" << block->block_id
+                    << "\",\"pid\":" << kComputeUnitPid
+                    << ",\"tid\":" << block->compute_unit * lanes_per_cu + lane
+                    << ",\"ts\":" << block->start_cycle << ",\"dur\":" << block->cycles << "}";
+    }
+
+    for (const auto& event : events_) {
+        if (event.kind != EventKind::WARP_STALL) continue;
+        separator() << "{\"ph\":\"X\",\"cat\":\"stall\",\"name\":\"memory stall\""
+                    << ",\"pid\":" << kWarpStallPid << ",\"tid\":" << event.compute_unit
+                    << ",\"ts\":" << event.start_cycle << ",\"dur\":" << event.cycles
+                    << ",\"args\":{\"kernel\":\"" << escapeJSON(kernelName(event.workload_id))
+                    << "\",\"block\":" << event.block_id << ",\"warp\":" << event.warp_id << "}}";
+    }
+
+    file << "\n]}\n";
+    file.flush();
+    if (!file) {
+        std::cerr << "Failed to write file: " << filename << "\n";
+        return false;
+    }
+    return true;
+}
+
+void TimelineTracer::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    kernels_.clear();
+    events_.clear();
+    kernel_names_.clear();
+    dropped_events_ = 0;
+}
+
+} // namespace GPUSim
@@ -0,0 +1,248 @@
+#include "batcher.h"
+#include "metrics.h"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+namespace GPUSim {
+
+BatchingFrontend::BatchingFrontend(GPUDevice& device, const BatchingPolicy& policy)
+    : device_(device),
+      policy_(policy),
+      stopping_(false),
+      launches_in_flight_(0),
+      requests_rejected_(0),
+      batches_launched_(0),
+      requests_launched_(0) {
+    if (policy_.max_batch_size == 0) policy_.max_batch_size = 1;
+    flusher_ = std::thread(&BatchingFrontend::flusherThread, this);
+}
+
+BatchingFrontend::~BatchingFrontend() {
+    // Stop the flusher first so it cannot launch a batch behind the drain
+    {
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        stopping_ = true;
+    }
+    batch_cv_.notify_all();
+    if (flusher_.joinable()) {
+        flusher_.join();
+    }
+    drain();
+}
+
+BatchingFrontend::ShapeClass BatchingFrontend::classify(const Workload& workload) {
+    const auto& config = workload.getConfig();
+    return ShapeClass(static_cast<int>(workload.getType()),
+                      config.block_dim_x, config.block_dim_y, config.block_dim_z,
+                      log2Bucket(config.getTotalBlocks()));
+}
+
+void BatchingFrontend::submit(std::shared_ptr<Workload> request) {
+    if (!request) return;
+
+    auto now = std::chrono::steady_clock::now();
+    std::vector<Request> full_batch;
+    {
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        {
+            std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+            if (first_arrival_ == std::chrono::steady_clock::time_point()) {
+                first_arrival_ = now;
+            }
+        }
+
+        auto& open = open_batches_[classify(*request)];
+        open.push_back(Request{std::move(request), now});
+        if (open.size() >= policy_.max_batch_size) {
+            full_batch.swap(open);
+            launches_in_flight_++;
+        } else if (open.size() == 1) {
+            // New deadline for the flusher
+            batch_cv_.notify_one();
+        }
+    }
+
+    if (!full_batch.empty()) {
+        launchBatch(std::move(full_batch));
+    }
+}
+
+void BatchingFrontend::flusherThread() {
+    auto max_wait = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(policy_.max_wait_ms));
+
+    std::unique_lock<std::mutex> lock(batch_mutex_);
+    while (!stopping_) {
+        // Collect every batch whose oldest request has waited long enough
+        auto now = std::chrono::steady_clock::now();
+        auto next_deadline = std::chrono::steady_clock::time_point::max();
+        std::vector<std::vector<Request>> expired;
+
+        for (auto& [shape, open] : open_batches_) {
+            if (open.empty()) continue;
+            auto deadline = open.front().arrival + max_wait;
+            if (deadline <= now) {
+                expired.emplace_back();
+                expired.back().swap(open);
+                launches_in_flight_++;
+            } else {
+                next_deadline = std::min(next_deadline, deadline);
+            }
+        }
+
+        if (!expired.empty()) {
+            lock.unlock();
+            for (auto& batch : expired) {
+                launchBatch(std::move(batch));
+            }
+            lock.lock();
+            continue;
+        }
+
+        if (next_deadline == std::chrono::steady_clock::time_point::max()) {
+            batch_cv_.wait(lock);
+        } else {
+            batch_cv_.wait_until(lock, next_deadline);
+        }
+    }
+}
+
+void BatchingFrontend::launchBatch(std::vector<Request> batch) {
+    const Workload& first = *batch.front().workload;
+    const auto& shape = first.getConfig();
+
+    // One grid holding every request's blocks back to back
+    size_t total_blocks = 0;
+    size_t instructions = 0;
+    size_t memory_ops = 0;
+    int priority = first.getPriority();
+    for (const auto& request : batch) {
+        total_blocks += request.workload->getConfig().getTotalBlocks();
+        instructions += request.workload->getEstimatedInstructions();
+        memory_ops += request.workload->getEstimatedMemoryOps();
+        priority = std::max(priority, request.workload->getPriority());
+    }
+
+    KernelConfig config(total_blocks, 1, 1,
+                        shape.block_dim_x, shape.block_dim_y, shape.block_dim_z);
+    std::string name = batch.size() == 1
+        ? first.getName()
+        : "Batch_" + first.getName() + "_x" + std::to_string(batch.size());
+
+    auto coalesced = std::make_shared<Workload>(name, first.getType(), config);
+    coalesced->setEstimatedInstructions(instructions);
+    coalesced->setEstimatedMemoryOps(memory_ops);
+    coalesced->setPriority(priority);
+
+    std::vector<std::chrono::steady_clock::time_point> arrivals;
+    arrivals.reserve(batch.size());
+    for (const auto& request : batch) {
+        arrivals.push_back(request.arrival);
+    }
+
+    size_t requests = batch.size();
+    auto result = device_.submitAsync(coalesced,
+        [this, arrivals = std::move(arrivals)](const WorkloadMetrics&) {
+            auto done = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            for (const auto& arrival : arrivals) {
+                latencies_ms_.push_back(
+                    std::chrono::duration<double, std::milli>(done - arrival).count());
+            }
+            last_completion_ = std::max(last_completion_, done);
+        });
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        launched_batches_.push_back(LaunchedBatch{std::move(result), requests});
+        batches_launched_++;
+        requests_launched_ += requests;
+    }
+
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    if (--launches_in_flight_ == 0) {
+        launch_cv_.notify_all();
+    }
+}
+
+void BatchingFrontend::drain() {
+    std::vector<std::vector<Request>> remaining;
+    {
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        for (auto& [shape, open] : open_batches_) {
+            if (open.empty()) continue;
+            remaining.emplace_back();
+            remaining.back().swap(open);
+            launches_in_flight_++;
+        }
+    }
+    for (auto& batch : remaining) {
+        launchBatch(std::move(batch));
+    }
+
+    // A batch taken by submit or the flusher may not be in launched_batches_ yet
+    {
+        std::unique_lock<std::mutex> lock(batch_mutex_);
+        launch_cv_.wait(lock, [this] { return launches_in_flight_ == 0; });
+    }
+
+    std::vector<LaunchedBatch> launched;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        launched.swap(launched_batches_);
+    }
+
+    size_t rejected = 0;
+    for (auto& batch : launched) {
+        try {
+            batch.result.get();
+        } catch (const std::exception& e) {
+            std::cerr << "Batch failed: " << e.what() << "\n";
+            rejected += batch.requests;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    requests_rejected_ += rejected;
+}
+
+BatchingStats BatchingFrontend::getStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+
+    BatchingStats stats{};
+    stats.requests_completed = latencies_ms_.size();
+    stats.requests_rejected = requests_rejected_;
+    stats.batches_launched = batches_launched_;
+    stats.average_batch_size = batches_launched_ > 0
+        ? static_cast<double>(requests_launched_) / batches_launched_ : 0.0;
+    stats.p50_latency_ms = computePercentile(latencies_ms_, 50.0);
+    stats.p95_latency_ms = computePercentile(latencies_ms_, 95.0);
+    stats.p99_latency_ms = computePercentile(latencies_ms_, 99.0);
+    stats.max_latency_ms = computePercentile(latencies_ms_, 100.0);
+
+    double elapsed_s = std::chrono::duration<double>(last_completion_ - first_arrival_).count();
+    if (stats.requests_completed > 0 && elapsed_s > 0) {
+        stats.throughput_rps = stats.requests_completed / elapsed_s;
+    }
+
+    return stats;
+}
+
+void BatchingFrontend::printReport() const {
+    BatchingStats stats = getStats();
+
+    std::cout << "\n=== Batching Report (max batch " << policy_.max_batch_size
+              << ", max wait " << policy_.max_wait_ms << " ms) ===\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Requests Completed: " << stats.requests_completed << "\n";
+    std::cout << "Requests Rejected: " << stats.requests_rejected << "\n";
+    std::cout << "Batches Launched: " << stats.batches_launched << "\n";
+    std::cout << "Average Batch Size: " << stats.average_batch_size << "\n";
+    std::cout << "Latency p50/p95/p99: " << stats.p50_latency_ms << " / "
+              << stats.p95_latency_ms << " / " << stats.p99_latency_ms << " ms\n";
+    std::cout << "Max Latency: " << stats.max_latency_ms << " ms\n";
+    std::cout << "Throughput: " << stats.throughput_rps << " requests/s\n";
+}
+
+} // namespace GPUSim
@@ -0,0 +1,235 @@
+#include "load_generator.h"
+#include "metrics.h"
+#include "scheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <iostream>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace GPUSim {
+
+static constexpr double kPi = 3.14159265358979323846;
+
+std::shared_ptr<Workload> Arrival::createWorkload() const {
+    switch (type) {
+        case WorkloadType::MATRIX_MULTIPLY: {
+            // Square matrix with roughly the requested element count
+            size_t dim = std::max<size_t>(16, static_cast<size_t>(std::sqrt(elements)) / 16 * 16);
+            return Workload::createMatrixMultiply(dim, dim, dim);
+        }
+        case WorkloadType::REDUCTION:
+            return Workload::createReduction(elements);
+        default:
+            return Workload::createVectorAdd(elements);
+    }
+}
+
+LoadGenerator::LoadGenerator(const LoadProfile& profile) : profile_(profile) {}
+
+std::vector<Arrival> LoadGenerator::generateSchedule() const {
+    std::vector<Arrival> schedule;
+    if (profile_.arrival_rate <= 0 || profile_.duration_ms <= 0) return schedule;
+    if (profile_.arrivals == ArrivalProcess::MMPP &&
+        (profile_.mean_calm_ms <= 0 || profile_.mean_burst_ms <= 0 || profile_.burst_factor <= 0)) {
+        // A zero-length state would switch forever without reaching the duration
+        std::cerr << "MMPP needs positive mean_calm_ms, mean_burst_ms and burst_factor\n";
+        return schedule;
+    }
+
+    std::mt19937_64 rng(profile_.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto exponential = [&](double mean) { return -mean * std::log(1.0 - unit(rng)); };
+
+    // Request shapes
+    const WorkloadType types[] = {WorkloadType::VECTOR_ADD, WorkloadType::REDUCTION,
+                                  WorkloadType::MATRIX_MULTIPLY};
+    size_t min_elements = std::max<size_t>(1, profile_.min_elements);
+    size_t max_elements = std::max(min_elements, profile_.max_elements);
+    auto drawSize = [&]() -> size_t {
+        switch (profile_.sizes) {
+            case SizeDistribution::UNIFORM:
+                return min_elements + static_cast<size_t>(unit(rng) * (max_elements - min_elements));
+            case SizeDistribution::LOG_UNIFORM: {
+                double low = std::log(static_cast<double>(min_elements));
+                double high = std::log(static_cast<double>(max_elements));
+                return static_cast<size_t>(std::exp(low + unit(rng) * (high - low)));
+            }
+            case SizeDistribution::BIMODAL:
+                return unit(rng) < profile_.large_fraction ? max_elements : min_elements;
+            default:
+                return min_elements;
+        }
+    };
+    auto addArrival = [&](double time_ms) {
+        WorkloadType type = types[static_cast<size_t>(unit(rng) * 3) % 3];
+        schedule.push_back(Arrival{time_ms, type, drawSize()});
+    };
+
+    double mean_gap_ms = 1000.0 / profile_.arrival_rate;
+
+    switch (profile_.arrivals) {
+        case ArrivalProcess::POISSON: {
+            for (double t = exponential(mean_gap_ms); t < profile_.duration_ms;
+                 t += exponential(mean_gap_ms)) {
+                addArrival(t);
+            }
+            break;
+        }
+
+        case ArrivalProcess::MMPP: {
+            // Scale the calm rate so the long-run mean stays at arrival_rate
+            double calm = profile_.mean_calm_ms;
+            double burst = profile_.mean_burst_ms;
+            double calm_rate = profile_.arrival_rate * (calm + burst) /
+                               (calm + profile_.burst_factor * burst);
+            double calm_gap_ms = 1000.0 / calm_rate;
+            double burst_gap_ms = calm_gap_ms / profile_.burst_factor;
+
+            bool bursting = false;
+            double t = 0.0;
+            double state_end = exponential(calm);
+            while (t < profile_.duration_ms) {
+                double next = t + exponential(bursting ? burst_gap_ms : calm_gap_ms);
+                if (next >= state_end) {
+                    // Memoryless, so the arrival clock restarts at the switch
+                    t = state_end;
+                    bursting = !bursting;
+                    state_end = t + exponential(bursting ? burst : calm);
+                    continue;
+                }
+                t = next;
+                if (t < profile_.duration_ms) addArrival(t);
+            }
+            break;
+        }
+
+        case ArrivalProcess::DIURNAL: {
+            // Thinning: draw at the peak rate, keep with probability rate(t) / peak
+            double amplitude = std::min(1.0, std::max(0.0, profile_.amplitude));
+            double peak_rate = profile_.arrival_rate * (1.0 + amplitude);
+            double peak_gap_ms = 1000.0 / peak_rate;
+            for (double t = exponential(peak_gap_ms); t < profile_.duration_ms;
+                 t += exponential(peak_gap_ms)) {
+                double phase = 2.0 * kPi * t / profile_.period_ms;
+                double rate = profile_.arrival_rate * (1.0 + amplitude * std::sin(phase));
+                if (unit(rng) * peak_rate < rate) {
+                    addArrival(t);
+                }
+            }
+            break;
+        }
+    }
+
+    return schedule;
+}
+
+LoadRunResult LoadGenerator::run(GPUDevice& device, const std::vector<Arrival>& schedule) const {
+    LoadRunResult result{};
+    result.scheduler_name = device.getScheduler() ? device.getScheduler()->getName() : "None";
+    result.requests_offered = schedule.size();
+    result.offered_rate = schedule.size() / (profile_.duration_ms / 1000.0);
+
+    std::mutex results_mutex;
+    std::vector<double> response_ms;
+    std::vector<double> queue_wait_ms;
+    uint64_t start = device.getCurrentCycle();
+    uint64_t last_completion = start;
+
+    std::vector<std::future<WorkloadMetrics>> futures;
+    futures.reserve(schedule.size());
+
+    // Arrival times are offsets on the device's simulated clock
+    for (const auto& arrival : schedule) {
+        uint64_t due = start + device.nsToCycles(arrival.time_ms * 1e6);
+        // Busy compute units carry the clock to the arrival; an idle device
+        // skips straight to it
+        while (device.isRunning() && device.getCurrentCycle() < due && !device.advanceIdleClock(due)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+
+        auto workload = arrival.createWorkload();
+        const Workload* request = workload.get(); // Kept alive by the device until completion
+        futures.push_back(device.submitAsync(std::move(workload),
+            [&, due, request](const WorkloadMetrics&) {
+                uint64_t done = request->getEndCycle();
+                std::lock_guard<std::mutex> lock(results_mutex);
+                response_ms.push_back(device.cyclesToNs(done - due) / 1e6);
+                queue_wait_ms.push_back(device.cyclesToNs(request->getStartCycle() - due) / 1e6);
+                last_completion = std::max(last_completion, done);
+            }));
+    }
+
+    for (auto& future : futures) {
+        try {
+            future.get();
+        } catch (const std::exception&) {
+            result.requests_rejected++;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(results_mutex);
+    result.requests_completed = response_ms.size();
+    double elapsed_s = device.cyclesToNs(last_completion - start) / 1e9;
+    if (elapsed_s > 0) {
+        result.achieved_rate = result.requests_completed / elapsed_s;
+    }
+    result.p50_response_ms = computePercentile(response_ms, 50.0);
+    result.p95_response_ms = computePercentile(response_ms, 95.0);
+    result.p99_response_ms = computePercentile(response_ms, 99.0);
+    if (!response_ms.empty()) {
+        double total_response = 0.0;
+        double total_wait = 0.0;
+        for (size_t i = 0; i < response_ms.size(); ++i) {
+            total_response += response_ms[i];
+            total_wait += queue_wait_ms[i];
+        }
+        result.mean_response_ms = total_response / response_ms.size();
+        result.mean_queue_wait_ms = total_wait / response_ms.size();
+    }
+
+    return result;
+}
+
+std::string LoadGenerator::arrivalProcessName(ArrivalProcess process) {
+    switch (process) {
+        case ArrivalProcess::POISSON: return "Poisson";
+        case ArrivalProcess::MMPP: return "MMPP";
+        case ArrivalProcess::DIURNAL: return "Diurnal";
+        default: return "Unknown";
+    }
+}
+
+void LoadGenerator::printLoadCurve(const std::vector<LoadRunResult>& results) {
+    std::cout << "\n=== Response Time vs Offered Load ===\n";
+    std::cout << std::left << std::setw(20) << "Scheduler"
+              << std::setw(12) << "Offered/s"
+              << std::setw(12) << "Achieved/s"
+              << std::setw(12) << "p50(ms)"
+              << std::setw(12) << "p95(ms)"
+              << std::setw(12) << "p99(ms)"
+              << std::setw(14) << "Queue Wait(ms)"
+              << "\n";
+    std::cout << std::string(94, '-') << "\n";
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& result : results) {
+        // Completions falling behind arrivals means the queue is growing
+        bool saturated = result.achieved_rate < 0.9 * result.offered_rate;
+        std::cout << std::left << std::setw(20) << result.scheduler_name
+                  << std::setw(12) << result.offered_rate
+                  << std::setw(12) << result.achieved_rate
+                  << std::setw(12) << result.p50_response_ms
+                  << std::setw(12) << result.p95_response_ms
+                  << std::setw(12) << result.p99_response_ms
+                  << std::setw(14) << result.mean_queue_wait_ms
+                  << (saturated ? "saturated" : "")
+                  << "\n";
+    }
+}
+
+} // namespace GPUSim
@@ -0,0 +1,206 @@
+#include "predictor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace GPUSim {
+
+static const char* kModelHeader = "# GPUSim runtime model v";
+static const int kModelVersion = 2; // 1 held host milliseconds
+
+RuntimePredictor::RuntimePredictor(double decay)
+    : decay_(decay),
+      total_error_pct_(0.0),
+      recent_error_pct_(0.0),
+      error_samples_(0) {
+}
+
+RuntimePredictor::ModelKey RuntimePredictor::makeKey(const Workload& workload) {
+    const auto& config = workload.getConfig();
+    return ModelKey(static_cast<int>(workload.getType()),
+                    log2Bucket(config.getTotalBlocks()),
+                    log2Bucket(config.getThreadsPerBlock()));
+}
+
+double RuntimePredictor::instructionsPerBlock(const Workload& workload) {
+    size_t blocks = std::max<size_t>(1, workload.getConfig().getTotalBlocks());
+    return static_cast<double>(workload.getEstimatedInstructions()) / blocks;
+}
+
+const RuntimePredictor::Model* RuntimePredictor::findModel(const ModelKey& key) const {
+    auto exact = models_.find(key);
+    if (exact != models_.end()) return &exact->second;
+
+    // Fall back to the closest shape bucket of the same workload type
+    const Model* nearest = nullptr;
+    int best_distance = std::numeric_limits<int>::max();
+    for (const auto& [other, model] : models_) {
+        if (std::get<0>(other) != std::get<0>(key)) continue;
+        int distance = std::abs(std::get<1>(other) - std::get<1>(key)) +
+                       std::abs(std::get<2>(other) - std::get<2>(key));
+        if (distance < best_distance) {
+            best_distance = distance;
+            nearest = &model;
+        }
+    }
+    return nearest;
+}
+
+double RuntimePredictor::predictBlockTime(const Workload& workload) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const Model* model = findModel(makeKey(workload));
+    if (!model) return -1.0;
+
+    double slope = 0.0;
+    if (model->samples > 1 && model->var_x > 1e-9 * (model->mean_x * model->mean_x + 1.0)) {
+        slope = model->cov_xy / model->var_x;
+    }
+
+    double prediction = model->mean_y + slope * (instructionsPerBlock(workload) - model->mean_x);
+
+    // Keep extrapolation from running away from what has been observed
+    return std::max(prediction, 0.1 * model->mean_y);
+}
+
+void RuntimePredictor::observe(const Workload& workload) {
+    if (!workload.isCompleted()) return;
+
+    size_t blocks = std::max<size_t>(1, workload.getConfig().getTotalBlocks());
+    size_t units = std::min(std::max<size_t>(1, workload.getAllocatedComputeUnits()), blocks);
+    double actual_cycles = static_cast<double>(workload.getExecutionCycles());
+
+    double x = instructionsPerBlock(workload);
+    double y = actual_cycles * units / blocks;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Score the prediction the scheduler acted on
+    double predicted_cycles = workload.getPredictedCycles();
+    if (predicted_cycles > 0 && actual_cycles > 0) {
+        double error_pct = std::abs(predicted_cycles - actual_cycles) / actual_cycles * 100.0;
+        total_error_pct_ += error_pct;
+        recent_error_pct_ = error_samples_ == 0
+            ? error_pct
+            : (1.0 - decay_) * recent_error_pct_ + decay_ * error_pct;
+        error_samples_++;
+    }
+
+    auto key = makeKey(workload);
+    auto it = models_.find(key);
+    if (it == models_.end()) {
+        models_[key] = Model{x, y, 0.0, 0.0, 1};
+        return;
+    }
+
+    Model& model = it->second;
+    double dx = x - model.mean_x;
+    double dy = y - model.mean_y;
+    model.mean_x += decay_ * dx;
+    model.mean_y += decay_ * dy;
+    model.var_x = (1.0 - decay_) * (model.var_x + decay_ * dx * dx);
+    model.cov_xy = (1.0 - decay_) * (model.cov_xy + decay_ * dx * dy);
+    model.samples++;
+}
+
+double RuntimePredictor::getMeanAbsoluteErrorPct() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_samples_ == 0) return 0.0;
+    return total_error_pct_ / error_samples_;
+}
+
+double RuntimePredictor::getRecentAbsoluteErrorPct() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return recent_error_pct_;
+}
+
+size_t RuntimePredictor::getObservationCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_samples_;
+}
+
+size_t RuntimePredictor::getModelCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return models_.size();
+}
+
+bool RuntimePredictor::save(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file: " << filename << "\n";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    file << kModelHeader << kModelVersion << "\n";
+    file << "# type blocks_log2 threads_log2 samples mean_x mean_y cov_xy var_x\n";
+    file << std::setprecision(17);
+    for (const auto& [key, model] : models_) {
+        file << std::get<0>(key) << " " << std::get<1>(key) << " " << std::get<2>(key) << " "
+             << model.samples << " " << model.mean_x << " " << model.mean_y << " "
+             << model.cov_xy << " " << model.var_x << "\n";
+    }
+
+    return true;
+}
+
+bool RuntimePredictor::load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line.compare(0, std::strlen(kModelHeader), kModelHeader) != 0) {
+        std::cerr << "Not a runtime model file: " << filename << "\n";
+        return false;
+    }
+    if (line.substr(std::strlen(kModelHeader)) != std::to_string(kModelVersion)) {
+        std::cerr << "Unsupported runtime model version in " << filename << ": "
+                  << line.substr(std::strlen(kModelHeader)) << "\n";
+        return false;
+    }
+
+    std::map<ModelKey, Model> loaded;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream fields(line);
+        int type, blocks_log2, threads_log2;
+        Model model;
+        if (!(fields >> type >> blocks_log2 >> threads_log2 >> model.samples
+                     >> model.mean_x >> model.mean_y >> model.cov_xy >> model.var_x)) {
+            std::cerr << "Malformed runtime model entry in " << filename << "\n";
+            return false;
+        }
+        loaded[ModelKey(type, blocks_log2, threads_log2)] = model;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    models_ = std::move(loaded);
+    return true;
+}
+
+void RuntimePredictor::printSummary() const {
+    std::cout << "Runtime Predictor: " << getModelCount() << " models, "
+              << getObservationCount() << " scored predictions, "
+              << std::fixed << std::setprecision(2)
+              << "mean error " << getMeanAbsoluteErrorPct() << "%, "
+              << "recent error " << getRecentAbsoluteErrorPct() << "%\n";
+}
+
+void RuntimePredictor::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    models_.clear();
+    total_error_pct_ = 0.0;
+    recent_error_pct_ = 0.0;
+    error_samples_ = 0;
+}
+
+} // namespace GPUSim
@@ -3,6 +3,10 @@
 
 namespace GPUSim {
 
+// Nominal per-CU execution rate used to turn static instruction estimates
+// into predicted cycles; blocks are mostly waiting on global memory
+constexpr double kNominalInstructionsPerCycle = 0.2;
+
 // Base Scheduler implementation
 void Scheduler::addWorkload(std::shared_ptr<Workload> workload) {
     std::lock_guard<std::mutex> lock(scheduler_mutex_);
@@ -10,9 +14,25 @@ void Scheduler::addWorkload(std::shared_ptr<Workload> workload) {
 }
 
 bool Scheduler::hasPendingWorkloads() const {
+    std::lock_guard<std::mutex> lock(scheduler_mutex_);
     return !pending_workloads_.empty();
 }
 
+size_t Scheduler::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(scheduler_mutex_);
+    return pending_workloads_.size();
+}
+
+size_t Scheduler::getRunningCount() const {
+    std::lock_guard<std::mutex> lock(scheduler_mutex_);
+    return running_workloads_.size();
+}
+
+size_t Scheduler::getCompletedCount() const {
+    std::lock_guard<std::mutex> lock(scheduler_mutex_);
+    return completed_workloads_.size();
+}
+
 void Scheduler::markWorkloadRunning(std::shared_ptr<Workload> workload) {
     std::lock_guard<std::mutex> lock(scheduler_mutex_);
 
@@ -31,6 +51,46 @@ void Scheduler::markWorkloadCompleted(std::shared_ptr<Workload> workload) {
         running_workloads_.erase(it);
         completed_workloads_.push_back(workload);
     }
+
+    if (predictor_) {
+        predictor_->observe(*workload);
+    }
+}
+
+void Scheduler::updateComputeUnitAvailability(size_t free_units, size_t total_units, uint64_t current_cycle) {
+    std::lock_guard<std::mutex> lock(scheduler_mutex_);
+    free_compute_units_ = free_units;
+    total_compute_units_ = total_units;
+    current_cycle_ = current_cycle;
+}
+
+std::shared_ptr<Workload> Scheduler::getCompanionWorkload(const Workload& /*primary*/) {
+    return nullptr;
+}
+
+size_t Scheduler::getComputeUnitDemand(const Workload& workload) const {
+    // A workload can keep at most one CU busy per block
+    size_t blocks = std::max<size_t>(1, workload.getConfig().getTotalBlocks());
+    if (total_compute_units_ == 0) return blocks;
+    return std::min(blocks, total_compute_units_);
+}
+
+double Scheduler::predictBlockTime(const Workload& workload) const {
+    if (predictor_) {
+        double learned = predictor_->predictBlockTime(workload);
+        if (learned > 0) return learned;
+    }
+
+    size_t blocks = std::max<size_t>(1, workload.getConfig().getTotalBlocks());
+    double instructions_per_block =
+        static_cast<double>(workload.getEstimatedInstructions()) / blocks;
+    return instructions_per_block / kNominalInstructionsPerCycle;
+}
+
+double Scheduler::predictRuntime(const Workload& workload, size_t compute_units) const {
+    size_t blocks = std::max<size_t>(1, workload.getConfig().getTotalBlocks());
+    compute_units = std::min(std::max<size_t>(1, compute_units), blocks);
+    return blocks * predictBlockTime(workload) / compute_units;
 }
 
 // FIFOScheduler implementation
@@ -95,12 +155,127 @@ std::shared_ptr<Workload> ShortestJobFirstScheduler::getNextWorkload() {
         return nullptr;
     }
 
-    // Find workload with fewest estimated instructions
-    auto it = std::min_element(pending_workloads_.begin(), pending_workloads_.end(),
-        [](const std::shared_ptr<Workload>& a, const std::shared_ptr<Workload>& b) {
-            return a->getEstimatedInstructions() < b->getEstimatedInstructions();
+    // Find workload with the shortest predicted runtime; one prediction each,
+    // since every one takes the predictor's lock
+    auto it = pending_workloads_.begin();
+    double shortest = predictRuntime(**it, getComputeUnitDemand(**it));
+    for (auto candidate = std::next(it); candidate != pending_workloads_.end(); ++candidate) {
+        double runtime = predictRuntime(**candidate, getComputeUnitDemand(**candidate));
+        if (runtime < shortest) {
+            shortest = runtime;
+            it = candidate;
+        }
+    }
+
+    auto workload = *it;
+    pending_workloads_.erase(it);
+    running_workloads_.push_back(workload);
+
+    return workload;
+}
+
+// BackfillScheduler implementation
+std::shared_ptr<Workload> BackfillScheduler::launch(size_t index, size_t compute_units) {
+    auto workload = pending_workloads_[index];
+    pending_workloads_.erase(pending_workloads_.begin() + index);
+    running_workloads_.push_back(workload);
+
+    running_reservations_.push_back({
+        workload, compute_units, current_cycle_ + predictRuntime(*workload, compute_units)});
+
+    return workload;
+}
+
+std::shared_ptr<Workload> BackfillScheduler::getNextWorkload() {
+    std::lock_guard<std::mutex> lock(scheduler_mutex_);
+
+    if (pending_workloads_.empty() || free_compute_units_ == 0) {
+        return nullptr;
+    }
+
+    // Forget reservations of workloads that have finished
+    running_reservations_.erase(
+        std::remove_if(running_reservations_.begin(), running_reservations_.end(),
+            [](const Reservation& r) { return r.workload->isCompleted(); }),
+        running_reservations_.end());
+
+    // Predictions are in simulated cycles, so the reservations run on the
+    // device clock
+    double now = static_cast<double>(current_cycle_);
+
+    // Head of the queue starts as soon as its full demand is free
+    size_t head_demand = getComputeUnitDemand(*pending_workloads_.front());
+    if (head_demand <= free_compute_units_) {
+        return launch(0, head_demand);
+    }
+
+    // Shadow time: the earliest point at which enough running workloads are
+    // predicted to finish for the head to start
+    std::vector<Reservation> by_end = running_reservations_;
+    std::sort(by_end.begin(), by_end.end(),
+        [](const Reservation& a, const Reservation& b) {
+            return a.predicted_end < b.predicted_end;
+        });
+
+    size_t available = free_compute_units_;
+    double shadow_time = now;
+    for (const auto& reservation : by_end) {
+        available += reservation.compute_units;
+        shadow_time = std::max(now, reservation.predicted_end);
+        if (available >= head_demand) break;
+    }
+
+    // Units the head will not need even once it starts
+    size_t extra_units = available > head_demand ? available - head_demand : 0;
+
+    for (size_t i = 1; i < pending_workloads_.size(); ++i) {
+        const auto& candidate = *pending_workloads_[i];
+        size_t demand = getComputeUnitDemand(candidate);
+        if (demand > free_compute_units_) continue;
+
+        bool finishes_before_shadow = now + predictRuntime(candidate, demand) <= shadow_time;
+
+        if (finishes_before_shadow || demand <= extra_units) {
+            return launch(i, demand);
+        }
+    }
+
+    return nullptr;
+}
+
+// CoScheduler implementation
+bool CoScheduler::isComputeBound(const Workload& workload) const {
+    return workload.getArithmeticIntensity() >= intensity_threshold_;
+}
+
+std::shared_ptr<Workload> CoScheduler::getNextWorkload() {
+    std::lock_guard<std::mutex> lock(scheduler_mutex_);
+
+    if (pending_workloads_.empty()) {
+        return nullptr;
+    }
+
+    auto workload = pending_workloads_.front();
+    pending_workloads_.erase(pending_workloads_.begin());
+    running_workloads_.push_back(workload);
+
+    return workload;
+}
+
+std::shared_ptr<Workload> CoScheduler::getCompanionWorkload(const Workload& primary) {
+    std::lock_guard<std::mutex> lock(scheduler_mutex_);
+
+    // Oldest pending workload with the opposite resource profile
+    bool primary_compute_bound = isComputeBound(primary);
+    auto it = std::find_if(pending_workloads_.begin(), pending_workloads_.end(),
+        [this, primary_compute_bound](const std::shared_ptr<Workload>& candidate) {
+            return isComputeBound(*candidate) != primary_compute_bound;
         });
 
+    if (it == pending_workloads_.end()) {
+        return nullptr;
+    }
+
     auto workload = *it;
     pending_workloads_.erase(it);
     running_workloads_.push_back(workload);
@@ -119,9 +294,39 @@ std::unique_ptr<Scheduler> SchedulerFactory::createScheduler(SchedulingAlgorithm
             return std::make_unique<RoundRobinScheduler>();
         case SchedulingAlgorithm::SHORTEST_JOB_FIRST:
             return std::make_unique<ShortestJobFirstScheduler>();
+        case SchedulingAlgorithm::BACKFILL:
+            return std::make_unique<BackfillScheduler>();
+        case SchedulingAlgorithm::CO_SCHEDULING:
+            return std::make_unique<CoScheduler>();
         default:
             return std::make_unique<FIFOScheduler>();
     }
 }
 
+static const std::pair<const char*, SchedulingAlgorithm> kAlgorithmNames[] = {
+    {"fifo", SchedulingAlgorithm::FIFO},
+    {"priority", SchedulingAlgorithm::PRIORITY},
+    {"round-robin", SchedulingAlgorithm::ROUND_ROBIN},
+    {"sjf", SchedulingAlgorithm::SHORTEST_JOB_FIRST},
+    {"backfill", SchedulingAlgorithm::BACKFILL},
+    {"co-schedule", SchedulingAlgorithm::CO_SCHEDULING}
+};
+
+bool SchedulerFactory::parseAlgorithm(const std::string& name, SchedulingAlgorithm& algorithm) {
+    for (const auto& [known, value] : kAlgorithmNames) {
+        if (name == known) {
+            algorithm = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* SchedulerFactory::algorithmName(SchedulingAlgorithm algorithm) {
+    for (const auto& [name, value] : kAlgorithmNames) {
+        if (value == algorithm) return name;
+    }
+    return "unknown";
+}
+
 } // namespace GPUSim
@@ -1,5 +1,550 @@
+// Unit tests for the simulator's building blocks. Runs every test, or only
+// those named on the command line; exits non-zero if any check fails.
+
+#include "gpu_device.h"
+#include "workload.h"
+#include "scheduler.h"
+#include "record_sink.h"
+#include "histogram.h"
+#include "columnar.h"
+#include "predictor.h"
+#include "batcher.h"
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
-int main() {
-    std::cout << "Hello World!" << std::endl;
-    return 0;
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace GPUSim;
+
+namespace {
+
+int g_failures = 0;
+
+// Records a failure and carries on, so one run reports every broken check
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #condition "\n"; \
+            g_failures++;                                                             \
+        }                                                                             \
+    } while (0)
+
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+// Device status lines would drown the test output
+std::ostream& quietLog() {
+    static std::ostream discard(nullptr);
+    return discard;
+}
+
+// Scratch file in the system temp directory, removed by the caller
+std::string tempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("gpusim_test_" + name)).string();
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+void writeFile(const std::string& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+// The compute units each workload's blocks retired on
+class ComputeUnitRecorder : public RecordSink {
+private:
+    std::mutex mutex_;
+    std::map<std::string, std::set<uint32_t>> units_;
+
+public:
+    void writeBlock(const BlockRecord& record) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        units_[std::string(record.workload_name)].insert(record.compute_unit);
+    }
+    void writeKernel(const KernelRecord&) override {}
+
+    size_t unitsUsed(const std::string& workload_name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return units_[workload_name].size();
+    }
+};
+
+// --- Dispatch ---
+
+// A backfill reservation of min(blocks, CUs) units gets one block per unit
+void testDispatchSpreadsOverReservation() {
+    GPUConfig config;
+    config.num_compute_units = 8;
+    GPUDevice gpu(config, quietLog());
+    gpu.setScheduler(SchedulerFactory::createScheduler(SchedulingAlgorithm::BACKFILL));
+    auto recorder = std::make_shared<ComputeUnitRecorder>();
+    gpu.setRecordSink(recorder);
+
+    auto vector_add = Workload::createVectorAdd(1024);
+    auto reduction = Workload::createReduction(4096);
+    std::string vector_add_name = vector_add->getName();
+    std::string reduction_name = reduction->getName();
+    size_t vector_add_blocks = vector_add->getConfig().getTotalBlocks();
+    size_t reduction_blocks = reduction->getConfig().getTotalBlocks();
+    gpu.submitWorkload(std::move(vector_add));
+    gpu.submitWorkload(std::move(reduction));
+
+    gpu.executeWorkloads();
+    gpu.waitForCompletion();
+
+    CHECK(recorder->unitsUsed(vector_add_name) == std::min<size_t>(vector_add_blocks, 8));
+    CHECK(recorder->unitsUsed(reduction_name) == std::min<size_t>(reduction_blocks, 8));
+}
+
+// A workload that owns the device uses all of it
+void testDispatchSpreadsOverWholeDevice() {
+    GPUConfig config;
+    config.num_compute_units = 4;
+    GPUDevice gpu(config, quietLog());
+    auto recorder = std::make_shared<ComputeUnitRecorder>();
+    gpu.setRecordSink(recorder);
+
+    auto vector_add = Workload::createVectorAdd(4096);
+    std::string name = vector_add->getName();
+    CHECK(vector_add->getConfig().getTotalBlocks() >= 4);
+    gpu.submitWorkload(std::move(vector_add));
+
+    gpu.executeWorkloads();
+    gpu.waitForCompletion();
+
+    CHECK(recorder->unitsUsed(name) == 4);
+}
+
+// --- Histogram ---
+
+// Small values land in exact buckets; larger ones stay within the relative
+// error the precision promises
+void testHistogramBucketing() {
+    LatencyHistogram histogram(7);
+    for (uint64_t value = 1; value <= 100; ++value) {
+        histogram.record(value);
+    }
+    CHECK(histogram.getCount() == 100);
+    CHECK(histogram.getMin() == 1);
+    CHECK(histogram.getMax() == 100);
+    CHECK(histogram.getPercentile(50.0) == 50);
+    CHECK(histogram.getPercentile(99.0) == 99);
+    CHECK(histogram.getPercentile(100.0) == 100);
+    CHECK(std::abs(histogram.getMean() - 50.5) < 1e-9);
+
+    const double max_relative_error = std::ldexp(1.0, 1 - 7);
+    for (uint64_t value : {1000ULL, 123457ULL, 987654321ULL, 1ULL << 40}) {
+        LatencyHistogram single(7);
+        single.record(value);
+        single.record(1); // Keeps the percentile from clamping to the observed max
+        double reported = static_cast<double>(single.getPercentile(100.0));
+        CHECK(reported == static_cast<double>(value));
+        LatencyHistogram wide(7);
+        wide.record(value);
+        wide.record(value * 4);
+        double median = static_cast<double>(wide.getPercentile(50.0));
+        CHECK(median >= value);
+        CHECK((median - value) / value <= max_relative_error);
+    }
+}
+
+void testHistogramSerializeRoundTrip() {
+    LatencyHistogram original(7);
+    for (uint64_t value = 0; value < 5000; value += 7) {
+        original.record(value * value, 1 + value % 3);
+    }
+
+    std::stringstream text;
+    original.serialize(text);
+    LatencyHistogram restored(7);
+    CHECK(restored.deserialize(text));
+    CHECK(restored.getCount() == original.getCount());
+    CHECK(restored.getMin() == original.getMin());
+    CHECK(restored.getMax() == original.getMax());
+    for (double percentile : {1.0, 25.0, 50.0, 90.0, 99.0, 99.9}) {
+        CHECK(restored.getPercentile(percentile) == original.getPercentile(percentile));
+    }
+
+    // Merging a copy doubles every count and leaves the percentiles alone
+    CHECK(restored.merge(original));
+    CHECK(restored.getCount() == 2 * original.getCount());
+    CHECK(restored.getPercentile(50.0) == original.getPercentile(50.0));
+
+    LatencyHistogram coarse(4);
+    CHECK(!coarse.merge(original));
+
+    std::stringstream garbage("not a histogram\n");
+    LatencyHistogram rejected(7);
+    CHECK(!rejected.deserialize(garbage));
+}
+
+// --- Record sink ---
+
+// The same records through a plain and an LZ-compressed sink; small batches
+// so the compressed file holds many frames
+void writeRecords(const std::string& path, RecordCompression compression) {
+    StreamingRecordSink sink(path, RecordFormat::JSONL, compression, 4096);
+    CHECK(sink.open());
+    const std::string names[] = {"VectorAdd_4096", "Reduction_65536", "MatMul_256x256x256"};
+    for (uint32_t i = 0; i < 3000; ++i) {
+        BlockRecord block{i % 3, names[i % 3], i, i % 16, i * 100ULL, i * 100ULL + 41000,
+                          8000, 41000, 1600};
+        sink.writeBlock(block);
+        if (i % 500 == 499) {
+            KernelRecord kernel{i % 3, names[i % 3], WorkloadType::VECTOR_ADD, 0, 10, i * 100ULL,
+                                i * 58.48, i * 8000ULL, i * 1600ULL, i, 16, 1.5, ""};
+            sink.writeKernel(kernel);
+        }
+    }
+    CHECK(sink.close());
+}
+
+void testRecordSinkCompressedRoundTrip() {
+    std::string plain_path = tempPath("records.jsonl");
+    std::string compressed_path = tempPath("records.jsonl.lz");
+    std::string expanded_path = tempPath("records_expanded.jsonl");
+    writeRecords(plain_path, RecordCompression::NONE);
+    writeRecords(compressed_path, RecordCompression::LZ);
+
+    std::string plain = readFile(plain_path);
+    std::string compressed = readFile(compressed_path);
+    CHECK(!plain.empty());
+    CHECK(compressed.size() < plain.size());
+    CHECK(decompressRecordFile(compressed_path, expanded_path));
+    CHECK(readFile(expanded_path) == plain);
+
+    std::remove(plain_path.c_str());
+    std::remove(compressed_path.c_str());
+    std::remove(expanded_path.c_str());
+}
+
+void testRecordSinkTruncatedFile() {
+    std::string compressed_path = tempPath("truncated.jsonl.lz");
+    std::string truncated_path = tempPath("truncated_cut.jsonl.lz");
+    std::string expanded_path = tempPath("truncated_expanded.jsonl");
+    writeRecords(compressed_path, RecordCompression::LZ);
+    std::string compressed = readFile(compressed_path);
+
+    // Magic, then frames of {uint32 raw size, uint32 stored size, data}
+    const size_t magic = 8;
+    const size_t header = 8;
+    CHECK(compressed.size() > magic + header);
+    uint32_t first_stored = 0;
+    std::memcpy(&first_stored, compressed.data() + magic + 4, sizeof(first_stored));
+    size_t second_frame = magic + header + first_stored;
+    CHECK(second_frame + header < compressed.size());
+
+    // Cut between frames: a clean, shorter file
+    writeFile(truncated_path, compressed.substr(0, second_frame));
+    CHECK(decompressRecordFile(truncated_path, expanded_path));
+
+    // Cut inside a frame header or inside frame data
+    for (size_t cut : {magic + 3, second_frame + 5, second_frame - 10, compressed.size() - 1}) {
+        writeFile(truncated_path, compressed.substr(0, cut));
+        CHECK(!decompressRecordFile(truncated_path, expanded_path));
+    }
+
+    writeFile(truncated_path, "GPUSIMXX");
+    CHECK(!decompressRecordFile(truncated_path, expanded_path));
+
+    std::remove(compressed_path.c_str());
+    std::remove(truncated_path.c_str());
+    std::remove(expanded_path.c_str());
+}
+
+// --- Columnar ---
+
+void testColumnarRoundTrip() {
+    std::string path = tempPath("results.gcr");
+    {
+        ColumnarWriter writer(path, {{"id", ColumnType::U32},
+                                     {"cycles", ColumnType::U64},
+                                     {"time_ns", ColumnType::F64},
+                                     {"name", ColumnType::DICT}},
+                              4);
+        CHECK(writer.open());
+        for (uint32_t row = 0; row < 10; ++row) {
+            writer.setU32(0, row);
+            writer.setU64(1, (1ULL << 40) + row);
+            writer.setF64(2, row * 0.5);
+            writer.setString(3, row % 2 ? "odd" : "even");
+            writer.endRow();
+        }
+        CHECK(writer.close());
+    }
+
+    ColumnarReader reader;
+    CHECK(reader.open(path));
+    CHECK(reader.getNumRows() == 10);
+    CHECK(reader.getNumColumns() == 4);
+    CHECK(reader.getNumChunks() == 3);
+    CHECK(reader.getChunkRows(2) == 2);
+    CHECK(reader.findColumn("time_ns") == 2);
+    CHECK(reader.findColumn("missing") == -1);
+    CHECK(reader.getDictionarySize() == 2);
+    for (uint32_t row = 0; row < 10; ++row) {
+        CHECK(reader.getU32(0, row) == row);
+        CHECK(reader.getU64(1, row) == (1ULL << 40) + row);
+        CHECK(reader.getF64(2, row) == row * 0.5);
+        CHECK(reader.getString(3, row) == (row % 2 ? "odd" : "even"));
+    }
+    const uint64_t* cycles = reader.getChunkData<uint64_t>(1, 1);
+    CHECK(cycles && cycles[0] == (1ULL << 40) + 4);
+    reader.close();
+    std::remove(path.c_str());
+}
+
+// A reopened writer starts a fresh dictionary
+void testColumnarReopenResetsDictionary() {
+    std::string path = tempPath("reopen.gcr");
+    ColumnarWriter writer(path, {{"name", ColumnType::DICT}});
+    CHECK(writer.open());
+    writer.setString(0, "first_run_a");
+    writer.endRow();
+    writer.setString(0, "first_run_b");
+    writer.endRow();
+    CHECK(writer.close());
+
+    CHECK(writer.open());
+    writer.setString(0, "second_run");
+    writer.endRow();
+    CHECK(writer.close());
+
+    ColumnarReader reader;
+    CHECK(reader.open(path));
+    CHECK(reader.getNumRows() == 1);
+    CHECK(reader.getDictionarySize() == 1);
+    CHECK(reader.getString(0, 0) == "second_run");
+    reader.close();
+    std::remove(path.c_str());
+}
+
+void testColumnarRejectsDamagedFooter() {
+    std::string path = tempPath("damaged.gcr");
+    {
+        ColumnarWriter writer(path, {{"value", ColumnType::U64}}, 8);
+        CHECK(writer.open());
+        for (uint64_t row = 0; row < 20; ++row) {
+            writer.setU64(0, row);
+            writer.endRow();
+        }
+        CHECK(writer.close());
+    }
+    std::string good = readFile(path);
+    ColumnarReader reader;
+
+    // Trailer: uint64 footer offset, then the magic
+    std::string bad_magic = good;
+    bad_magic[bad_magic.size() - 1] = 'X';
+    std::string bad_offset = good;
+    uint64_t past_end = good.size() + 100;
+    std::memcpy(&bad_offset[good.size() - 16], &past_end, sizeof(past_end));
+
+    for (const std::string& damaged : {good.substr(0, good.size() - 1), bad_magic, bad_offset,
+                                       good.substr(0, 12), std::string("GPUSIMCR")}) {
+        writeFile(path, damaged);
+        CHECK(!reader.open(path));
+        CHECK(reader.getNumRows() == 0);
+    }
+
+    writeFile(path, good);
+    CHECK(reader.open(path));
+    CHECK(reader.getNumRows() == 20);
+    reader.close();
+    std::remove(path.c_str());
+}
+
+// --- Runtime predictor ---
+
+// A workload that ran its blocks in cycles on units compute units
+std::unique_ptr<Workload> completedWorkload(WorkloadType type, size_t blocks, size_t instructions,
+                                            uint64_t cycles, size_t units) {
+    auto workload = std::make_unique<Workload>("Completed", type, KernelConfig(blocks));
+    workload->setEstimatedInstructions(instructions);
+    workload->setAllocatedComputeUnits(units);
+    workload->setStartCycle(1000);
+    ThreadBlock block(0, 256);
+    block.setStartCycle(1000);
+    block.setEndCycle(1000 + cycles);
+    workload->recordRetiredBlock(block);
+    workload->complete();
+    return workload;
+}
+
+void testPredictorSaveLoad() {
+    RuntimePredictor trained;
+    for (uint64_t run = 1; run <= 4; ++run) {
+        trained.observe(*completedWorkload(WorkloadType::VECTOR_ADD, 64, 64 * 8000 * run, 41000 * 8 * run, 8));
+        trained.observe(*completedWorkload(WorkloadType::REDUCTION, 16, 16 * 9000, 50000 * 2, 8));
+    }
+    CHECK(trained.getModelCount() == 2);
+
+    Workload probe("Probe", WorkloadType::VECTOR_ADD, KernelConfig(64));
+    probe.setEstimatedInstructions(64 * 12000);
+    double expected = trained.predictBlockTime(probe);
+    CHECK(expected > 0);
+
+    std::string path = tempPath("runtime_model.txt");
+    CHECK(trained.save(path));
+    RuntimePredictor loaded;
+    CHECK(loaded.load(path));
+    CHECK(loaded.getModelCount() == 2);
+    CHECK(loaded.predictBlockTime(probe) == expected);
+
+    // A bad file leaves the loaded models in place
+    std::string saved = readFile(path);
+    writeFile(path, "type blocks threads\n0 6 8 1 1 1 0 0\n");
+    CHECK(!loaded.load(path));
+    std::string old_version = saved;
+    old_version.replace(saved.find('\n') - 1, 1, "1");
+    writeFile(path, old_version);
+    CHECK(!loaded.load(path));
+    writeFile(path, saved + "0 6 8 not numbers\n");
+    CHECK(!loaded.load(path));
+    CHECK(loaded.getModelCount() == 2);
+    CHECK(loaded.predictBlockTime(probe) == expected);
+
+    RuntimePredictor untrained;
+    CHECK(untrained.predictBlockTime(probe) < 0);
+    std::remove(path.c_str());
+}
+
+// --- Scheduling ---
+
+std::shared_ptr<Workload> plannedWorkload(const std::string& name, size_t blocks, size_t instructions_per_block) {
+    auto workload = std::make_shared<Workload>(name, WorkloadType::VECTOR_ADD, KernelConfig(blocks));
+    workload->setEstimatedInstructions(blocks * instructions_per_block);
+    return workload;
+}
+
+// A blocked head keeps its reservation: only work predicted to finish
+// before it can start jumps the queue
+void testBackfillReservationOrder() {
+    BackfillScheduler scheduler;
+    auto running = plannedWorkload("Running", 6, 20000); // 100k cycles on 6 CUs
+    auto head = plannedWorkload("Head", 8, 1000);
+    auto long_job = plannedWorkload("Long", 2, 100000);   // 500k cycles, past the reservation
+    auto short_job = plannedWorkload("Short", 2, 2000);   // 10k cycles, done well before it
+
+    scheduler.addWorkload(running);
+    scheduler.updateComputeUnitAvailability(8, 8, 0);
+    CHECK(scheduler.getNextWorkload() == running);
+
+    scheduler.addWorkload(head);
+    scheduler.addWorkload(long_job);
+    scheduler.addWorkload(short_job);
+    scheduler.updateComputeUnitAvailability(2, 8, 0);
+    CHECK(scheduler.getNextWorkload() == short_job);
+
+    // The short job's units come back, but the long job would still hold
+    // them when the head's reservation starts
+    short_job->complete();
+    scheduler.updateComputeUnitAvailability(2, 8, 10000);
+    CHECK(scheduler.getNextWorkload() == nullptr);
+
+    // Once the head's units are free it goes before the long job
+    running->complete();
+    scheduler.updateComputeUnitAvailability(8, 8, 100000);
+    CHECK(scheduler.getNextWorkload() == head);
+    scheduler.updateComputeUnitAvailability(0, 8, 100000);
+    CHECK(scheduler.getNextWorkload() == nullptr);
+    head->complete();
+    scheduler.updateComputeUnitAvailability(8, 8, 200000);
+    CHECK(scheduler.getNextWorkload() == long_job);
+}
+
+// --- Batching ---
+
+// drain() returns only once every request has completed, including batches
+// the flusher took but had not launched yet
+void testBatcherDrain() {
+    GPUConfig config;
+    config.num_compute_units = 4;
+    GPUDevice gpu(config, quietLog());
+    gpu.executeWorkloads();
+
+    // Full batches only; the flusher waits far longer than the test
+    {
+        BatchingFrontend batcher(gpu, BatchingPolicy(4, 60000.0));
+        for (int i = 0; i < 10; ++i) {
+            batcher.submit(Workload::createVectorAdd(1024));
+        }
+        batcher.drain();
+        BatchingStats stats = batcher.getStats();
+        CHECK(stats.requests_completed == 10);
+        CHECK(stats.requests_rejected == 0);
+        CHECK(stats.batches_launched == 3);
+    }
+
+    // Immediate deadlines, so the flusher launches nearly every batch
+    for (int round = 0; round < 5; ++round) {
+        BatchingFrontend batcher(gpu, BatchingPolicy(8, 0.0));
+        for (int i = 0; i < 6; ++i) {
+            batcher.submit(Workload::createVectorAdd(1024));
+        }
+        batcher.drain();
+        BatchingStats stats = batcher.getStats();
+        CHECK(stats.requests_completed + stats.requests_rejected == 6);
+    }
+
+    // Destroyed without a drain: the destructor drains
+    {
+        BatchingFrontend batcher(gpu, BatchingPolicy(8, 0.0));
+        for (int i = 0; i < 6; ++i) {
+            batcher.submit(Workload::createVectorAdd(1024));
+        }
+    }
+
+    gpu.waitForCompletion();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const TestCase tests[] = {
+        {"dispatch_spreads_over_reservation", testDispatchSpreadsOverReservation},
+        {"dispatch_spreads_over_whole_device", testDispatchSpreadsOverWholeDevice},
+        {"histogram_bucketing", testHistogramBucketing},
+        {"histogram_serialize_round_trip", testHistogramSerializeRoundTrip},
+        {"record_sink_compressed_round_trip", testRecordSinkCompressedRoundTrip},
+        {"record_sink_truncated_file", testRecordSinkTruncatedFile},
+        {"columnar_round_trip", testColumnarRoundTrip},
+        {"columnar_reopen_resets_dictionary", testColumnarReopenResetsDictionary},
+        {"columnar_rejects_damaged_footer", testColumnarRejectsDamagedFooter},
+        {"predictor_save_load", testPredictorSaveLoad},
+        {"backfill_reservation_order", testBackfillReservationOrder},
+        {"batcher_drain", testBatcherDrain},
+    };
+
+    size_t run = 0;
+    for (const auto& test : tests) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i) {
+            selected |= std::strcmp(argv[i], test.name) == 0;
+        }
+        if (!selected) continue;
+
+        int failures_before = g_failures;
+        test.run();
+        run++;
+        std::cout << (g_failures == failures_before ? "[  OK  ] " : "[ FAIL ] ") << test.name << "\n";
+    }
+
+    std::cout << run << " tests, " << g_failures << " failed checks\n";
+    return g_failures == 0 && run > 0 ? 0 : 1;
 }